@@ -0,0 +1,386 @@
+/**
+ * @file ssd1306_emu.c Headless ssd1306 emulator interface for host builds
+ */
+
+#include "ssd1306_emu.h"
+
+#if defined(__linux__) || defined(__MINGW32__)
+
+#include "intf/ssd1306_interface.h"
+#include "lcd/ssd1306_commands.h"
+#include <stdio.h>
+#include <string.h>
+
+#define EMU_WIDTH           128
+#define EMU_PAGES           8
+#define EMU_ROWS            (EMU_PAGES * 8)
+
+/** Decoder of the byte following a control byte */
+enum
+{
+    EMU_EXPECT_CONTROL,
+    EMU_COMMAND_ONCE,
+    EMU_DATA_ONCE,
+    EMU_COMMAND_STREAM,
+    EMU_DATA_STREAM,
+};
+
+static uint8_t s_gdram[EMU_PAGES][EMU_WIDTH];
+static uint8_t s_mode;
+static uint8_t s_cmd;
+static uint8_t s_args[6];
+static uint8_t s_argCount;
+static uint8_t s_argNeed;
+
+/* Controller state */
+static uint8_t s_memoryMode;
+static uint8_t s_colStart, s_colEnd, s_pageStart, s_pageEnd;
+static uint8_t s_col, s_page;
+static uint8_t s_startLine;
+static uint8_t s_offset;
+static uint8_t s_muxRows;
+static uint8_t s_inverted;
+static uint8_t s_allOn;
+static uint8_t s_displayOn;
+static uint8_t s_scrollLeft, s_scrollStartPage, s_scrollEndPage, s_scrollInterval;
+static uint8_t s_scrollActive;
+static uint16_t s_scrollFrames;
+
+/* Bus accounting */
+static uint32_t s_clockHz;
+static SSD1306EmuStats s_stats;
+static uint64_t s_clocks;
+static uint16_t s_txnBytes;
+
+static const uint16_t s_scrollIntervalFrames[8] = { 5, 64, 128, 256, 3, 4, 25, 2 };
+
+static uint8_t commandArgs(uint8_t cmd)
+{
+    switch (cmd)
+    {
+        case SSD1306_SETCONTRAST:
+        case SSD1306_MEMORYMODE:
+        case SSD1306_SETMULTIPLEX:
+        case SSD1306_SETDISPLAYOFFSET:
+        case SSD1306_SETDISPLAYCLOCKDIV:
+        case SSD1306_SETPRECHARGE:
+        case SSD1306_SETCOMPINS:
+        case SSD1306_SETVCOMDETECT:
+        case SSD1306_CHARGEPUMP:
+            return 1;
+        case SSD1306_COLUMNADDR:
+        case SSD1306_PAGEADDR:
+        case 0xA3: // vertical scroll area
+            return 2;
+        case 0x29: // vertical and horizontal scroll
+        case 0x2A:
+            return 5;
+        case SSD1306_RIGHT_HORIZONTAL_SCROLL:
+        case SSD1306_LEFT_HORIZONTAL_SCROLL:
+            return 6;
+        default:
+            return 0;
+    }
+}
+
+static void executeCommand(void)
+{
+    uint8_t cmd = s_cmd;
+    if ((cmd & 0xC0) == SSD1306_SETSTARTLINE)
+    {
+        s_startLine = cmd & 0x3F;
+    }
+    else if ((cmd & 0xF8) == 0xB0)
+    {
+        s_page = cmd & 0x07;
+    }
+    else if (cmd <= 0x0F)
+    {
+        s_col = (s_col & 0xF0) | cmd;
+    }
+    else if (cmd <= 0x1F)
+    {
+        s_col = (s_col & 0x0F) | ((cmd & 0x0F) << 4);
+    }
+    switch (cmd)
+    {
+        case SSD1306_MEMORYMODE:
+            s_memoryMode = s_args[0] & 0x03;
+            break;
+        case SSD1306_COLUMNADDR:
+            s_colStart = s_args[0] & 0x7F;
+            s_colEnd = s_args[1] & 0x7F;
+            s_col = s_colStart;
+            break;
+        case SSD1306_PAGEADDR:
+            s_pageStart = s_args[0] & 0x07;
+            s_pageEnd = s_args[1] & 0x07;
+            s_page = s_pageStart;
+            break;
+        case SSD1306_SETDISPLAYOFFSET:
+            s_offset = s_args[0] & 0x3F;
+            break;
+        case SSD1306_SETMULTIPLEX:
+            s_muxRows = (s_args[0] & 0x3F) + 1;
+            break;
+        case SSD1306_DISPLAYALLON_RESUME:
+            s_allOn = 0;
+            break;
+        case SSD1306_DISPLAYALLON:
+            s_allOn = 1;
+            break;
+        case SSD1306_NORMALDISPLAY:
+            s_inverted = 0;
+            break;
+        case SSD1306_INVERTDISPLAY:
+            s_inverted = 1;
+            break;
+        case SSD1306_DISPLAYOFF:
+            s_displayOn = 0;
+            break;
+        case SSD1306_DISPLAYON:
+            s_displayOn = 1;
+            break;
+        case SSD1306_RIGHT_HORIZONTAL_SCROLL:
+        case SSD1306_LEFT_HORIZONTAL_SCROLL:
+            s_scrollLeft = (cmd == SSD1306_LEFT_HORIZONTAL_SCROLL);
+            s_scrollStartPage = s_args[1] & 0x07;
+            s_scrollInterval = s_args[2] & 0x07;
+            s_scrollEndPage = s_args[3] & 0x07;
+            break;
+        case SSD1306_ACTIVATE_SCROLL:
+            s_scrollActive = 1;
+            s_scrollFrames = 0;
+            break;
+        case SSD1306_DEACTIVATE_SCROLL:
+            s_scrollActive = 0;
+            break;
+        default:
+            break;
+    }
+}
+
+static void emuCommand(uint8_t data)
+{
+    if (s_argNeed)
+    {
+        s_args[s_argCount++] = data;
+        if (s_argCount == s_argNeed)
+        {
+            s_argNeed = 0;
+            executeCommand();
+        }
+        return;
+    }
+    s_cmd = data;
+    s_argCount = 0;
+    s_argNeed = commandArgs(data);
+    if (!s_argNeed)
+    {
+        executeCommand();
+    }
+}
+
+static void emuData(uint8_t data)
+{
+    s_gdram[s_page][s_col] = data;
+    s_stats.dataBytes++;
+    if (s_memoryMode == 0x02)
+    {
+        // Page addressing: column wraps inside the page
+        s_col = (s_col + 1) & 0x7F;
+    }
+    else if (s_memoryMode == 0x01)
+    {
+        if (++s_page > s_pageEnd)
+        {
+            s_page = s_pageStart;
+            s_col = (s_col >= s_colEnd) ? s_colStart : s_col + 1;
+        }
+    }
+    else if (++s_col > s_colEnd)
+    {
+        s_col = s_colStart;
+        s_page = (s_page >= s_pageEnd) ? s_pageStart : s_page + 1;
+    }
+}
+
+static void emuStart(void)
+{
+    s_mode = EMU_EXPECT_CONTROL;
+    s_txnBytes = 0;
+    s_stats.transactions++;
+}
+
+static void emuStop(void)
+{
+    // start, address byte with ACK, 9 clocks per byte, stop
+    s_clocks += 1 + 9 * (uint32_t)(s_txnBytes + 1) + 1;
+    s_txnBytes = 0;
+}
+
+static void emuSend(uint8_t data)
+{
+    s_stats.bytes++;
+    s_txnBytes++;
+    switch (s_mode)
+    {
+        case EMU_EXPECT_CONTROL:
+            if (data & 0x80)
+            {
+                s_mode = (data & 0x40) ? EMU_DATA_ONCE : EMU_COMMAND_ONCE;
+            }
+            else
+            {
+                s_mode = (data & 0x40) ? EMU_DATA_STREAM : EMU_COMMAND_STREAM;
+            }
+            break;
+        case EMU_COMMAND_ONCE:
+            emuCommand(data);
+            s_mode = EMU_EXPECT_CONTROL;
+            break;
+        case EMU_DATA_ONCE:
+            emuData(data);
+            s_mode = EMU_EXPECT_CONTROL;
+            break;
+        case EMU_COMMAND_STREAM:
+            emuCommand(data);
+            break;
+        default:
+            emuData(data);
+            break;
+    }
+}
+
+static void emuSendBuffer(const uint8_t *buffer, uint16_t size)
+{
+    while (size--)
+    {
+        emuSend(*buffer++);
+    }
+}
+
+static void emuClose(void)
+{
+}
+
+void ssd1306_emuInit(uint32_t clockHz)
+{
+    memset(s_gdram, 0, sizeof(s_gdram));
+    s_mode = EMU_EXPECT_CONTROL;
+    s_argNeed = 0;
+    s_memoryMode = 0x02;
+    s_colStart = 0;
+    s_colEnd = EMU_WIDTH - 1;
+    s_pageStart = 0;
+    s_pageEnd = EMU_PAGES - 1;
+    s_col = 0;
+    s_page = 0;
+    s_startLine = 0;
+    s_offset = 0;
+    s_muxRows = EMU_ROWS;
+    s_inverted = 0;
+    s_allOn = 0;
+    s_displayOn = 0;
+    s_scrollActive = 0;
+    s_clockHz = clockHz ? clockHz : 400000;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_clocks = 0;
+
+    ssd1306_intf.spi = 0;
+    ssd1306_intf.start = emuStart;
+    ssd1306_intf.stop = emuStop;
+    ssd1306_intf.send = emuSend;
+    ssd1306_intf.send_buffer = emuSendBuffer;
+    ssd1306_intf.close = emuClose;
+}
+
+void ssd1306_emuGetStats(SSD1306EmuStats *stats, uint8_t reset)
+{
+    *stats = s_stats;
+    stats->busUs = (uint32_t)(s_clocks * 1000000ULL / s_clockHz);
+    if (reset)
+    {
+        memset(&s_stats, 0, sizeof(s_stats));
+        s_clocks = 0;
+    }
+}
+
+void ssd1306_emuAdvanceFrames(uint16_t frames)
+{
+    if (!s_scrollActive)
+    {
+        return;
+    }
+    s_scrollFrames += frames;
+    uint16_t interval = s_scrollIntervalFrames[s_scrollInterval];
+    for (; s_scrollFrames >= interval; s_scrollFrames -= interval)
+    {
+        for (uint8_t page = s_scrollStartPage; page <= s_scrollEndPage; page++)
+        {
+            uint8_t *row = s_gdram[page];
+            if (s_scrollLeft)
+            {
+                uint8_t first = row[0];
+                memmove(row, row + 1, EMU_WIDTH - 1);
+                row[EMU_WIDTH - 1] = first;
+            }
+            else
+            {
+                uint8_t last = row[EMU_WIDTH - 1];
+                memmove(row + 1, row, EMU_WIDTH - 1);
+                row[0] = last;
+            }
+        }
+    }
+}
+
+const uint8_t *ssd1306_emuGetGdram(void)
+{
+    return &s_gdram[0][0];
+}
+
+uint8_t ssd1306_emuGetPixel(lcduint_t x, lcduint_t y)
+{
+    if (!s_displayOn || x >= EMU_WIDTH || y >= s_muxRows)
+    {
+        return 0;
+    }
+    if (s_allOn)
+    {
+        return 1;
+    }
+    uint8_t row = (y + s_startLine + s_offset) % EMU_ROWS;
+    uint8_t lit = (s_gdram[row >> 3][x] >> (row & 0x07)) & 0x01;
+    return lit ^ s_inverted;
+}
+
+int8_t ssd1306_emuWritePbm(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL)
+    {
+        return -1;
+    }
+    fprintf(f, "P4\n%d %d\n", EMU_WIDTH, s_muxRows);
+    for (lcduint_t y = 0; y < s_muxRows; y++)
+    {
+        uint8_t line[EMU_WIDTH / 8];
+        for (lcduint_t x = 0; x < EMU_WIDTH; x += 8)
+        {
+            uint8_t bits = 0;
+            for (uint8_t i = 0; i < 8; i++)
+            {
+                // PBM 1 is black: dark pixels of the panel
+                bits = (bits << 1) | !ssd1306_emuGetPixel(x + i, y);
+            }
+            line[x >> 3] = bits;
+        }
+        fwrite(line, 1, sizeof(line), f);
+    }
+    int8_t result = ferror(f) ? -1 : 0;
+    fclose(f);
+    return result;
+}
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @file ssd1306_emu.h Headless ssd1306 emulator interface for host builds
+ */
+
+#ifndef _SSD1306_EMU_H_
+#define _SSD1306_EMU_H_
+
+#include "nano_gfx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LCD_EMULATOR I2C/SPI: headless ssd1306 emulator
+ * @{
+ * @brief Decodes i2c command/data stream into in-memory GDRAM, without any display.
+ *
+ * @details ssd1306_emuInit() installs the emulator as ssd1306_intf i2c interface. Every byte the
+ *        library sends is decoded as ssd1306 controller would do it: control bytes (Co, D/C),
+ *        commands with their arguments (also split over several transactions), horizontal,
+ *        vertical and page addressing modes, start line, display offset, inversion, display
+ *        on/off and horizontal scroll. Scroll advances only in ssd1306_emuAdvanceFrames(), as
+ *        there is no real frame clock. Segment and COM remap commands are accepted and ignored:
+ *        the panel view is the one of the library init sequences (column 0, row 0 at top left).
+ *        Bus traffic is counted per transaction, and bus time is simulated for given SCL clock.
+ *        Available for Linux and MinGW host builds only.
+ */
+
+/** Traffic counters of the emulated bus, see ssd1306_emuGetStats() */
+typedef struct
+{
+    /** Bus transactions (ssd1306_intf.start() calls) */
+    uint32_t transactions;
+    /** Bytes sent after the device address: control bytes, commands and pixel data */
+    uint32_t bytes;
+    /** Bytes written to GDRAM */
+    uint32_t dataBytes;
+    /** Simulated bus time in microseconds: start, address, 9 clocks per byte, stop */
+    uint32_t busUs;
+} SSD1306EmuStats;
+
+/**
+ * Inits display interface to use emulator as i2c bus. Emulated controller is reset to its
+ * power-on state: display off, page addressing mode, start line and offset 0, GDRAM cleared.
+ *
+ * @param clockHz - simulated SCL clock in Hz, used for SSD1306EmuStats::busUs
+ * @note: after call to this function you need to initialize lcd display.
+ */
+void ssd1306_emuInit(uint32_t clockHz);
+
+/**
+ * Returns traffic counters since emulator init or last reset.
+ * @param stats - destination
+ * @param reset - 1 to clear counters after reading
+ */
+void ssd1306_emuGetStats(SSD1306EmuStats *stats, uint8_t reset);
+
+/**
+ * Moves active horizontal scroll by given number of display frames. Content of scrolled
+ * pages moves by one column each scroll interval (see ESsd1306ScrollInterval).
+ * @param frames - number of elapsed frames
+ */
+void ssd1306_emuAdvanceFrames(uint16_t frames);
+
+/**
+ * Returns emulated GDRAM: 8 pages of 128 bytes, bit 0 of each byte is the top row of the page.
+ */
+const uint8_t *ssd1306_emuGetGdram(void);
+
+/**
+ * Returns pixel as seen on the panel: start line, display offset, inversion and
+ * display on/off are applied.
+ * @param x - column 0 - 127
+ * @param y - row, less than multiplex ratio (64 for 128x64 displays)
+ * @return 1 if pixel is lit
+ */
+uint8_t ssd1306_emuGetPixel(lcduint_t x, lcduint_t y);
+
+/**
+ * Writes panel view (see ssd1306_emuGetPixel()) to binary PBM file: lit pixels are white,
+ * as on the display.
+ * @param path - file to write
+ * @return 0 on success, -1 if file cannot be written
+ */
+int8_t ssd1306_emuWritePbm(const char *path);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SSD1306_EMU_H_
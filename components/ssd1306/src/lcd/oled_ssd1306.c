@@ -85,25 +85,29 @@ static const uint8_t PROGMEM s_oled128x32_initData[] =
 
 static void ssd1306_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
 {
+    const uint8_t cmd[] =
+    {
+        SSD1306_COLUMNADDR, x, w ? (x + w - 1) : (ssd1306_lcd.width - 1),
+        SSD1306_PAGEADDR, y, (ssd1306_lcd.height >> 3) - 1,
+    };
     ssd1306_intf.start();
-    if (ssd1306_intf.spi)
-        ssd1306_spiDataMode(0);
-    else
-        ssd1306_intf.send(0x00);
-    ssd1306_intf.send(SSD1306_COLUMNADDR);
-    ssd1306_intf.send(x);
-    ssd1306_intf.send(w ? (x + w - 1) : (ssd1306_lcd.width - 1));
-    ssd1306_intf.send(SSD1306_PAGEADDR);
-    ssd1306_intf.send(y);
-    ssd1306_intf.send((ssd1306_lcd.height >> 3) - 1);
     if (ssd1306_intf.spi)
     {
+        ssd1306_spiDataMode(0);
+        for (uint8_t i = 0; i < sizeof(cmd); i++)
+        {
+            ssd1306_intf.send(cmd[i]);
+        }
         ssd1306_spiDataMode(1);
     }
     else
     {
-        ssd1306_intf.stop();
-        ssd1306_intf.start();
+        // Co=1 control byte before each command lets data stream follow in the same transaction
+        for (uint8_t i = 0; i < sizeof(cmd); i++)
+        {
+            ssd1306_intf.send(0x80);
+            ssd1306_intf.send(cmd[i]);
+        }
         ssd1306_intf.send(0x40);
     }
 }
@@ -166,6 +170,25 @@ uint8_t ssd1306_getStartLine(void)
     return s_ssd1306_startLine;
 }
 
+void ssd1306_startHorizontalScroll(uint8_t left, uint8_t startPage, uint8_t endPage, uint8_t interval)
+{
+    ssd1306_commandStart();
+    ssd1306_intf.send( left ? SSD1306_LEFT_HORIZONTAL_SCROLL : SSD1306_RIGHT_HORIZONTAL_SCROLL );
+    ssd1306_intf.send(0x00);
+    ssd1306_intf.send(startPage & 0x07);
+    ssd1306_intf.send(interval & 0x07);
+    ssd1306_intf.send(endPage & 0x07);
+    ssd1306_intf.send(0x00);
+    ssd1306_intf.send(0xFF);
+    ssd1306_intf.send(SSD1306_ACTIVATE_SCROLL);
+    ssd1306_intf.stop();
+}
+
+void ssd1306_stopScroll(void)
+{
+    ssd1306_sendCommand(SSD1306_DEACTIVATE_SCROLL);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //  I2C SSD1306 128x64
 ///////////////////////////////////////////////////////////////////////////////
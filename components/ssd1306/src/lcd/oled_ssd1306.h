@@ -175,7 +175,9 @@ void         ssd1306_flipHorizontal(uint8_t mode);
 void         ssd1306_flipVertical(uint8_t mode);
 
 /**
- * Sets start line in gdram to start display content with
+ * Sets start line in gdram to start display content with.
+ * Only one command is sent, gdram is not changed: content moves up by line rows,
+ * and rows above start line are shown at the bottom of the display.
  *
  * @param line start line in range 0 - 63
  */
@@ -186,6 +188,24 @@ void ssd1306_setStartLine(uint8_t line);
  */
 uint8_t ssd1306_getStartLine(void);
 
+/**
+ * Starts continuous horizontal scroll of pages [startPage, endPage]: content moves by one
+ * column every interval and wraps around display edge. GDRAM must not be written while
+ * scroll is active, see ssd1306_stopScroll().
+ *
+ * @param left - 1 to move content towards column 0, 0 to move it towards last column
+ * @param startPage - first page to scroll, 0 - 7
+ * @param endPage - last page to scroll, not less than startPage
+ * @param interval - step interval, one of ESsd1306ScrollInterval values
+ */
+void ssd1306_startHorizontalScroll(uint8_t left, uint8_t startPage, uint8_t endPage, uint8_t interval);
+
+/**
+ * Stops scroll started by ssd1306_startHorizontalScroll(). Displayed content stays
+ * at the position reached.
+ */
+void ssd1306_stopScroll(void);
+
 /**
  * @}
  */
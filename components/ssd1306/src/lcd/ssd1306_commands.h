@@ -41,6 +41,10 @@ enum ESsd1306Commands
     SSD1306_MEMORYMODE       = 0x20,
     SSD1306_COLUMNADDR       = 0x21,
     SSD1306_PAGEADDR         = 0x22,
+    SSD1306_RIGHT_HORIZONTAL_SCROLL = 0x26,
+    SSD1306_LEFT_HORIZONTAL_SCROLL  = 0x27,
+    SSD1306_DEACTIVATE_SCROLL = 0x2E,
+    SSD1306_ACTIVATE_SCROLL  = 0x2F,
     SSD1306_SETSTARTLINE     = 0x40,
     SSD1306_DEFAULT_ADDRESS  = 0x78,
     SSD1306_SETCONTRAST      = 0x81,
@@ -66,6 +70,19 @@ enum ESsd1306Commands
     SSD1306_NOP              = 0xE3,
 };
 
+/** SSD1306 horizontal scroll step intervals, in frames */
+enum ESsd1306ScrollInterval
+{
+    SSD1306_SCROLL_5_FRAMES    = 0x00,
+    SSD1306_SCROLL_64_FRAMES   = 0x01,
+    SSD1306_SCROLL_128_FRAMES  = 0x02,
+    SSD1306_SCROLL_256_FRAMES  = 0x03,
+    SSD1306_SCROLL_3_FRAMES    = 0x04,
+    SSD1306_SCROLL_4_FRAMES    = 0x05,
+    SSD1306_SCROLL_25_FRAMES   = 0x06,
+    SSD1306_SCROLL_2_FRAMES    = 0x07,
+};
+
 /** SSD1306 supported memory modes. */
 enum ESsd1306MemoryMode
 {
@@ -208,6 +208,56 @@ void NanoCanvasOps<BPP>::printFixedPgm(lcdint_t xpos, lcdint_t y, const char *ch
 #define BANK_ADDR1(b) ((b) * m_w)
 #endif
 
+#if defined(__AVR__)
+/* 8-bit cores gain nothing from word access */
+#define CANVAS_WORD_ACCESS 0
+#else
+#define CANVAS_WORD_ACCESS 1
+#if defined(__GNUC__)
+typedef uint32_t __attribute__((__may_alias__)) canvas_word_t;
+#else
+typedef uint32_t canvas_word_t;
+#endif
+#endif
+
+/**
+ * Sets (color is non-zero) or clears bits of the vertical mask in len bytes of one page.
+ * Full page masks go to memset(), others are applied 4 bytes at a time once dst is aligned.
+ */
+static void canvasMaskRow1(uint8_t *dst, lcduint_t len, uint8_t mask, uint16_t color)
+{
+    if (mask == 0xFF)
+    {
+        memset(dst, color ? 0xFF : 0x00, len);
+        return;
+    }
+    if (!color)
+    {
+        mask = ~mask;
+    }
+#if CANVAS_WORD_ACCESS
+    for (; len && ((uintptr_t)dst & 0x03); len--, dst++)
+    {
+        *dst = color ? (*dst | mask) : (*dst & mask);
+    }
+    uint32_t wordMask = mask * 0x01010101UL;
+    canvas_word_t *word = reinterpret_cast<canvas_word_t *>(dst);
+    if (color)
+    {
+        for (; len >= 4; len -= 4) *word++ |= wordMask;
+    }
+    else
+    {
+        for (; len >= 4; len -= 4) *word++ &= wordMask;
+    }
+    dst = reinterpret_cast<uint8_t *>(word);
+#endif
+    for (; len; len--, dst++)
+    {
+        *dst = color ? (*dst | mask) : (*dst & mask);
+    }
+}
+
 template <>
 void NanoCanvasOps<1>::putPixel(lcdint_t x, lcdint_t y)
 {
@@ -236,16 +286,7 @@ void NanoCanvasOps<1>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
     if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
     x1 = max(0, x1);
     x2 = min(x2, (lcdint_t)(m_w -1));
-    uint16_t addr = YADDR1(y1) + x1;
-    uint8_t mask = (1 << (y1 & 0x7));
-    if (m_color)
-    {
-        do { m_buf[addr++] |= mask; } while (x2>x1++);
-    }
-    else
-    {
-        do { m_buf[addr++] &= ~mask; } while (x2>x1++);
-    }
+    canvasMaskRow1(&m_buf[YADDR1(y1) + x1], x2 - x1 + 1, 1 << (y1 & 0x7), m_color);
 }
 
 template <>
@@ -311,34 +352,17 @@ void NanoCanvasOps<1>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
     y2 = min(y2, (lcdint_t)(m_h - 1));
     uint8_t bank1 = (y1 >> 3);
     uint8_t bank2 = (y2 >> 3);
+    // Only first and last pages are partial, inner pages are filled with memset()
+    uint8_t firstMask = 0xFF << (y1 & 7);
+    uint8_t lastMask = 0xFF >> (7 - (y2 & 7));
     for (uint8_t bank = bank1; bank<=bank2; bank++)
     {
         uint8_t mask = 0xFF;
-        if (bank1 == bank2)
-        {
-            mask = (mask >> ((y1 & 7) + 7 - (y2 & 7))) << (y1 & 7);
-        }
-        else if (bank1 == bank)
-        {
-            mask = (mask << (y1 & 7));
-        }
-        else if (bank2 == bank)
-        {
-            mask = (mask >> (7 - (y2 & 7)));
-        }
-        for (uint8_t x=x1; x<=x2; x++)
-        {
-            if (m_color)
-            {
-                m_buf[BANK_ADDR1(bank) + x] |= mask;
-            }
-            else
-            {
-                m_buf[BANK_ADDR1(bank) + x] &= ~mask;
-            }
-        }
+        if (bank == bank1) mask &= firstMask;
+        if (bank == bank2) mask &= lastMask;
+        canvasMaskRow1(&m_buf[BANK_ADDR1(bank) + x1], x2 - x1 + 1, mask, m_color);
     }
-};
+}
 
 template <>
 void NanoCanvasOps<1>::clear()
@@ -346,73 +370,54 @@ void NanoCanvasOps<1>::clear()
     memset(m_buf, 0, YADDR1(m_h));
 }
 
-// TODO: Not so fast implementation. needs to be optimized
 template <>
 void NanoCanvasOps<1>::drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
     x -= offset.x;
     y -= offset.y;
-    lcduint_t origin_width = w;
+    // Clip once: canvas area [x1..x2], [y1..y2] covered by the bitmap
+    lcdint_t x1 = max(0, x);
+    lcdint_t x2 = min((lcdint_t)(x + (lcdint_t)w - 1), (lcdint_t)(m_w - 1));
+    lcdint_t y1 = max(0, y);
+    lcdint_t y2 = min((lcdint_t)(y + (lcdint_t)h - 1), (lcdint_t)(m_h - 1));
+    if ((x1 > x2) || (y1 > y2)) return;
     uint8_t offs = y & 0x07;
-    uint8_t complexFlag = 0;
-    uint8_t mainFlag = 1;
-    if (y + (lcdint_t)h <= 0) return;
-    if (y >= (lcdint_t)m_h) return;
-    if ((int16_t)x + (int16_t)w <= 0) return;
-    if ((int16_t)x >= (int16_t)m_w)  return;
-    if (y < 0)
-    {
-         bitmap += ((lcduint_t)((-y) + 7) >> 3) * w;
-         h += y;
-         y = 0;
-         complexFlag = 1;
-    }
-    if (x < 0)
-    {
-         bitmap += -x;
-         w += x;
-         x = 0;
-    }
-    uint8_t max_pages = (lcduint_t)(h + 15 - offs) >> 3;
-    if ((lcduint_t)(y + (lcdint_t)h) > (lcduint_t)m_h)
-    {
-         h = (lcduint_t)(m_h - (lcduint_t)y);
-    }
-    if ((lcduint_t)(x + (lcdint_t)w) > (lcduint_t)m_w)
-    {
-         w = (lcduint_t)(m_w - (lcduint_t)x);
-    }
-    uint8_t pages = ((y + h - 1) >> 3) - (y >> 3) + 1;
-    uint8_t j;
-    lcduint_t i;
-
-    for(j=0; j < pages; j++)
-    {
-        uint16_t addr = YADDR1(y + ((uint16_t)j<<3)) + x;
-        if ( j == max_pages - 1 ) mainFlag = !offs;
-        for( i=w; i > 0; i--)
+    // Source page, which lands on canvas page 0 with offs shift
+    lcdint_t srcBase = (y - offs) / 8;
+    lcdint_t srcPages = (h + 7) >> 3;
+    lcduint_t len = x2 - x1 + 1;
+    bitmap += x1 - x;
+    uint8_t inverse = m_color == BLACK ? 0xFF : 0x00;
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+
+    for (lcdint_t bank = y1 >> 3; bank <= (y2 >> 3); bank++)
+    {
+        // Each canvas byte combines lower bits of source page and upper bits of previous one
+        lcdint_t src = bank - srcBase;
+        const uint8_t *cur = src < srcPages ? bitmap + src * w : NULL;
+        const uint8_t *prev = (offs && src > 0) ? bitmap + (src - 1) * w : NULL;
+        uint8_t mask = 0xFF;
+        if (bank == (y1 >> 3)) mask &= 0xFF << (y1 & 0x07);
+        if (bank == (y2 >> 3)) mask &= 0xFF >> (0x07 - (y2 & 0x07));
+        uint8_t *dst = &m_buf[BANK_ADDR1(bank) + x1];
+        for (lcduint_t i = 0; i < len; i++)
         {
             uint8_t data = 0;
-            uint8_t mask = 0;
-            if ( mainFlag )    { data |= (pgm_read_byte(bitmap) << offs); mask |= (0xFF << offs); }
-            if ( complexFlag ) { data |= (pgm_read_byte(bitmap - origin_width) >> (8 - offs)); mask |= (0xFF >> (8 - offs)); }
-            if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
+            if (cur) data = pgm_read_byte(&cur[i]) << offs;
+            if (prev) data |= pgm_read_byte(&prev[i]) >> (8 - offs);
+            if (!transparent)
+            {
+                dst[i] = (dst[i] & ~mask) | ((data ^ inverse) & mask);
+            }
+            else if (inverse)
             {
-                m_buf[addr] &= ~mask;
-                m_buf[addr] |= m_color == BLACK ? ~data: data;
+                dst[i] &= ~(data & mask);
             }
             else
             {
-                if (m_color == BLACK)
-                    m_buf[addr] &= ~data;
-                else
-                    m_buf[addr] |= data;
+                dst[i] |= data & mask;
             }
-            bitmap++;
-            addr++;
         }
-        bitmap += origin_width - w;
-        complexFlag = offs;
     }
 }
 
@@ -427,8 +432,6 @@ void NanoCanvasOps<1>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint
     if (x + (lcdint_t)w <= 0) return;
     if (x >= (lcdint_t)m_w)  return;
 
-    delay(100);
-
     uint8_t start_bit = 0;
     lcduint_t pitch_delta = 0;
     if (y < 0)
@@ -524,6 +527,21 @@ void NanoCanvas1::blt(const NanoRect &rect)
     // TODO: NOT IMPLEMENTED
 }
 
+//                 NANO CANVAS PAGES 1
+
+void NanoCanvasPages1::render(DrawFunc draw, void *arg)
+{
+    lcduint_t width = ssd1306_lcd.width < SSD1306_PAGE_BUFFER_WIDTH ?
+                      ssd1306_lcd.width : SSD1306_PAGE_BUFFER_WIDTH;
+    for (lcduint_t page = 0; page < (ssd1306_lcd.height >> 3); page++)
+    {
+        m_canvas.begin(width, 8, m_buf);
+        m_canvas.setOffset(0, page << 3);
+        draw(m_canvas, arg);
+        m_canvas.blt();
+    }
+}
+
 //                 NANO CANVAS 1_8
 
 void NanoCanvas1_8::blt(lcdint_t x, lcdint_t y)
@@ -34,6 +34,7 @@
 #include "ssd1306_hal/io.h"
 #include "ssd1306_hal/Print_internal.h"
 #include "nano_gfx_types.h"
+#include "ssd1306_pages.h"
 
 /**
  * @ingroup NANO_ENGINE_API
@@ -407,6 +408,33 @@ public:
     void blt(const NanoRect &rect) override;
 };
 
+/**
+ * NanoCanvasPages1 redraws whole 1-bit display through a single 8-pixel high
+ * NanoCanvas1 (128 bytes for 128 pixels wide display). Draw callback is called
+ * once per page with canvas offset set to that page, so all canvas operations are
+ * clipped to the page, and every page is sent to the display in one block.
+ */
+class NanoCanvasPages1
+{
+public:
+    /**
+     * Draw callback: draws whole screen content using screen coordinates.
+     * Content outside of canvas.rect() can be skipped to save cpu.
+     */
+    typedef void (*DrawFunc)(NanoCanvas1 &canvas, void *arg);
+
+    /**
+     * Renders all pages of the display.
+     * @param draw - function drawing screen content
+     * @param arg - user argument for draw function
+     */
+    void render(DrawFunc draw, void *arg);
+
+private:
+    uint8_t m_buf[SSD1306_PAGE_BUFFER_WIDTH];
+    NanoCanvas1 m_canvas;
+};
+
 /**
  * NanoCanvas1_8 represents objects for drawing in memory buffer
  * NanoCanvas1_8 represents each pixel as single bit: 0/1
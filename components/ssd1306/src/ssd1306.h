@@ -31,6 +31,10 @@
 #include "nano_gfx_types.h"
 #include "ssd1306_generic.h"
 #include "ssd1306_1bit.h"
+#include "ssd1306_shadow.h"
+#include "ssd1306_pages.h"
+#include "ssd1306_glyph_cache.h"
+#include "ssd1306_driver.h"
 #include "ssd1306_8bit.h"
 #include "ssd1306_16bit.h"
 #include "ssd1306_fonts.h"
@@ -49,7 +49,13 @@ extern uint8_t g_ssd1306_unicode;
 
 void ssd1306_fillScreen(uint8_t fill_Data)
 {
+    const ssd1306_static_driver_t *driver = ssd1306_getStaticDriver();
     fill_Data ^= s_ssd1306_invertByte;
+    if (driver)
+    {
+        driver->fill_screen(fill_Data);
+        return;
+    }
     ssd1306_lcd.set_block(0, 0, 0);
     for(lcduint_t m=(ssd1306_lcd.height >> 3); m>0; m--)
     {
@@ -64,6 +70,12 @@ void ssd1306_fillScreen(uint8_t fill_Data)
 
 void ssd1306_clearScreen()
 {
+    const ssd1306_static_driver_t *driver = ssd1306_getStaticDriver();
+    if (driver)
+    {
+        driver->fill_screen(s_ssd1306_invertByte);
+        return;
+    }
     ssd1306_lcd.set_block(0, 0, 0);
     for(lcduint_t m=(ssd1306_lcd.height >> 3); m>0; m--)
     {
@@ -82,6 +94,11 @@ uint8_t ssd1306_printFixed(uint8_t xpos, uint8_t y, const char *ch, EFontStyle s
     uint8_t text_index = 0;
     uint8_t page_offset = 0;
     uint8_t x = xpos;
+    const ssd1306_static_driver_t *driver = ssd1306_getStaticDriver();
+    if (driver)
+    {
+        return driver->print_fixed(xpos, y, ch, style);
+    }
     y >>= 3;
     ssd1306_lcd.set_block(xpos, y, ssd1306_lcd.width - xpos);
     for(;;)
@@ -351,11 +368,41 @@ uint8_t ssd1306_printFixedN(uint8_t xpos, uint8_t y, const char ch[], EFontStyle
             ssd1306_lcd.set_block(xpos, y, ssd1306_lcd.width - xpos);
         }
         uint16_t unicode;
-        do
+        if ( (uint8_t)ch[j] < 0x80 )
         {
-            unicode = ssd1306_unicode16FromUtf8(ch[j]);
+            // ascii needs no utf-8 decoding, but ends any sequence the decoder left pending;
+            // cached digits are sent already scaled
+            ssd1306_unicode16Reset();
+            unicode = (uint8_t)ch[j];
             j++;
-        } while ( unicode == SSD1306_MORE_CHARS_REQUIRED );
+            const uint8_t *glyph = (style == STYLE_NORMAL) ? ssd1306_getCachedGlyph(unicode, factor) : NULL;
+            if ( glyph )
+            {
+                uint8_t width = s_fixedFont.h.width << factor;
+                glyph += page_offset * width;
+                x += width;
+                if ( !s_ssd1306_invertByte && ssd1306_lcd.send_pixels_buffer1 )
+                {
+                    ssd1306_lcd.send_pixels_buffer1(glyph, width);
+                }
+                else
+                {
+                    for( i=width; i>0; i--)
+                    {
+                        ssd1306_lcd.send_pixels1((*glyph++)^s_ssd1306_invertByte);
+                    }
+                }
+                continue;
+            }
+        }
+        else
+        {
+            do
+            {
+                unicode = ssd1306_unicode16FromUtf8(ch[j]);
+                j++;
+            } while ( unicode == SSD1306_MORE_CHARS_REQUIRED );
+        }
         SCharInfo char_info;
         ssd1306_getCharBitmap(unicode, &char_info);
         ldata = 0;
@@ -927,6 +974,12 @@ void gfx_drawMonoBitmap(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const
 void ssd1306_clearBlock(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
 {
     uint8_t i, j;
+    const ssd1306_static_driver_t *driver = ssd1306_getStaticDriver();
+    if (driver)
+    {
+        driver->clear_block(x, y, w, h, s_ssd1306_invertByte);
+        return;
+    }
     ssd1306_lcd.set_block(x, y, w);
     for(j=(h >> 3); j>0; j--)
     {
@@ -942,6 +995,12 @@ void ssd1306_clearBlock(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
 void ssd1306_fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
     uint8_t templ = ssd1306_color^s_ssd1306_invertByte;
+    const ssd1306_static_driver_t *driver = ssd1306_getStaticDriver();
+    if (driver)
+    {
+        driver->fill_rect(x1, y1, x2, y2, templ);
+        return;
+    }
     if (x1 > x2) return;
     if (y1 > y2) return;
     if ((lcduint_t)x2 >= ssd1306_displayWidth()) x2 = (lcdint_t)ssd1306_displayWidth() - 1;
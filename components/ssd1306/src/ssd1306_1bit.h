@@ -123,6 +123,8 @@ uint8_t     ssd1306_printFixed2x(uint8_t xpos, uint8_t y, const char ch[], EFont
  * @param style - font style (EFontStyle), normal by default.
  * @param factor - 0, 1, 2, 3.
  * @returns number of chars in string
+ * @note Digits of STYLE_NORMAL text are taken pre-scaled from the glyph cache,
+ *       see ssd1306_getCachedGlyph().
  * @see ssd1306_setFixedFont
  * @warning ssd1306_printFixed2x() can output chars at fixed y positions: 0, 8, 16, 24, 32, etc.
  *          If you specify [10,18], ssd1306_printFixed2x() will output text starting at [10,16] position.
@@ -0,0 +1,37 @@
+/**
+ * @file ssd1306_driver.cpp Compile-time specialized driver for ssd1306 compatible 1-bit displays
+ */
+
+#include "ssd1306_driver.h"
+
+static const ssd1306_static_driver_t *s_driver = nullptr;
+/* set_block at selection time: differs once shadow framebuffer or page rendering takes over */
+static void (*s_setBlock)(lcduint_t x, lcduint_t y, lcduint_t w) = nullptr;
+
+extern "C" int8_t ssd1306_setStaticDriver(const ssd1306_static_driver_t *driver)
+{
+    if ( driver && ( (ssd1306_lcd.type != LCD_TYPE_SSD1306) ||
+                     (ssd1306_lcd.width != driver->width) ||
+                     (ssd1306_lcd.height != driver->height) ) )
+    {
+        return -1;
+    }
+    s_driver = driver;
+    s_setBlock = ssd1306_lcd.set_block;
+    return 0;
+}
+
+extern "C" const ssd1306_static_driver_t *ssd1306_getStaticDriver(void)
+{
+    return (s_driver && (ssd1306_lcd.set_block == s_setBlock)) ? s_driver : nullptr;
+}
+
+extern "C" const ssd1306_static_driver_t *ssd1306_128x64_staticDriver(void)
+{
+    return Ssd1306Driver< Ssd1306Panel<128, 64> >::ops();
+}
+
+extern "C" const ssd1306_static_driver_t *ssd1306_128x32_staticDriver(void)
+{
+    return Ssd1306Driver< Ssd1306Panel<128, 32> >::ops();
+}
@@ -0,0 +1,381 @@
+/**
+ * @file ssd1306_driver.h Compile-time specialized driver for ssd1306 compatible 1-bit displays
+ */
+
+#ifndef _SSD1306_DRIVER_H_
+#define _SSD1306_DRIVER_H_
+
+#include "nano_gfx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LCD_STATIC_DRIVER DIRECT DRAW: compile-time specialized driver for 1-bit displays
+ * @{
+ * @brief Runs the heaviest direct draw functions without per-byte function pointer calls.
+ *
+ * @details Regular direct draw functions send every pixel byte through ssd1306_lcd.send_pixels1,
+ *        which is an alias of ssd1306_intf.send. Ssd1306Driver template (C++) is specialized for
+ *        panel geometry and interface: its inner loops write bytes into a small staging buffer,
+ *        passed to the interface with one ssd1306_intf.send_buffer() call when full and at the
+ *        end of the block. Once selected by ssd1306_setStaticDriver(), ssd1306_fillScreen(),
+ *        ssd1306_clearScreen(), ssd1306_clearBlock(), ssd1306_fillRect() and ssd1306_printFixed()
+ *        are thin wrappers over the driver. Other functions keep using ssd1306_lcd.
+ *        While shadow framebuffer or page rendering redirects ssd1306_lcd, the wrappers follow
+ *        the redirection and the static driver is not used.
+ */
+
+/** Entry points of a specialized driver, see Ssd1306Driver::ops() */
+typedef struct
+{
+    /** Display width the driver is built for */
+    lcduint_t width;
+    /** Display height the driver is built for */
+    lcduint_t height;
+    /** Fills whole display with byte pattern (inversion already applied) */
+    void (*fill_screen)(uint8_t data);
+    /** Fills block with byte pattern, y in pages, h in pixels (multiple of 8) */
+    void (*clear_block)(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t data);
+    /** Fills rectangle with byte pattern (color and inversion already applied) */
+    void (*fill_rect)(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint8_t pattern);
+    /** Same as ssd1306_printFixed() */
+    uint8_t (*print_fixed)(uint8_t xpos, uint8_t y, const char *ch, EFontStyle style);
+} ssd1306_static_driver_t;
+
+/**
+ * Selects specialized driver for ssd1306_clearScreen(), ssd1306_fillRect(), ssd1306_printFixed(), ...
+ * Call after display initialization.
+ * @param driver - driver entry points, or NULL to return to runtime dispatch through ssd1306_lcd
+ * @return 0 on success, -1 if display is not ssd1306 or its size differs from the driver's one
+ */
+int8_t       ssd1306_setStaticDriver(const ssd1306_static_driver_t *driver);
+
+/**
+ * Returns selected specialized driver, or NULL if none is selected or ssd1306_lcd is redirected
+ * (shadow framebuffer, page rendering) since selection.
+ */
+const ssd1306_static_driver_t *ssd1306_getStaticDriver(void);
+
+/** Specialized driver for 128x64 ssd1306 displays, i2c or spi */
+const ssd1306_static_driver_t *ssd1306_128x64_staticDriver(void);
+
+/** Specialized driver for 128x32 ssd1306 displays, i2c or spi */
+const ssd1306_static_driver_t *ssd1306_128x32_staticDriver(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+#include "ssd1306_generic.h"
+#include "lcd/lcd_common.h"
+#include "lcd/ssd1306_commands.h"
+#include "intf/ssd1306_interface.h"
+#include "intf/spi/ssd1306_spi.h"
+#include "ssd1306_hal/io.h"
+#include <string.h>
+
+extern "C" SFixedFontInfo s_fixedFont;
+extern "C" uint8_t s_ssd1306_invertByte;
+
+/**
+ * @ingroup LCD_STATIC_DRIVER
+ * @{
+ */
+
+/**
+ * Geometry and block addressing of ssd1306 compatible panel in horizontal addressing mode.
+ */
+template <lcduint_t W, lcduint_t H>
+class Ssd1306Panel
+{
+public:
+    /** Width in pixels */
+    static const lcduint_t width = W;
+    /** Height in pixels */
+    static const lcduint_t height = H;
+    /** Number of 8-pixel pages */
+    static const lcduint_t pages = H >> 3;
+
+    /**
+     * Fills commands selecting output block, same as ssd1306_lcd.set_block for ssd1306.
+     * @return number of command bytes, 6
+     */
+    static uint8_t blockCommands(uint8_t *cmd, lcduint_t x, lcduint_t y, lcduint_t w)
+    {
+        cmd[0] = SSD1306_COLUMNADDR;
+        cmd[1] = x;
+        cmd[2] = w ? (x + w - 1) : (W - 1);
+        cmd[3] = SSD1306_PAGEADDR;
+        cmd[4] = y;
+        cmd[5] = pages - 1;
+        return 6;
+    }
+};
+
+/**
+ * Interface staging pixel bytes in RAM and passing them to ssd1306_intf in chunks of N bytes.
+ * N must be at least 16 to hold i2c block header.
+ */
+template <uint16_t N>
+class Ssd1306StagedIntf
+{
+public:
+    /** Starts transaction and sends block commands, then switches to data */
+    static void startBlock(const uint8_t *cmd, uint8_t len)
+    {
+        ssd1306_intf.start();
+        m_len = 0;
+        if (ssd1306_intf.spi)
+        {
+            ssd1306_spiDataMode(0);
+            ssd1306_intf.send_buffer(cmd, len);
+            ssd1306_spiDataMode(1);
+        }
+        else
+        {
+            // Co=1 control byte before each command lets data stream follow in the same transaction
+            for (uint8_t i = 0; i < len; i++)
+            {
+                m_buffer[m_len++] = 0x80;
+                m_buffer[m_len++] = cmd[i];
+            }
+            m_buffer[m_len++] = 0x40;
+        }
+    }
+
+    /** Sends pixel byte */
+    static inline void send(uint8_t data)
+    {
+        m_buffer[m_len++] = data;
+        if (m_len == N)
+        {
+            flush();
+        }
+    }
+
+    /** Sends count copies of pixel byte */
+    static void fill(uint8_t data, uint16_t count)
+    {
+        while (count)
+        {
+            uint16_t n = N - m_len;
+            if (n > count) n = count;
+            memset(&m_buffer[m_len], data, n);
+            m_len += n;
+            count -= n;
+            if (m_len == N)
+            {
+                flush();
+            }
+        }
+    }
+
+    /** Sends staged bytes and completes transaction */
+    static void stop()
+    {
+        flush();
+        ssd1306_intf.stop();
+    }
+
+private:
+    static uint8_t m_buffer[N];
+    static uint16_t m_len;
+
+    static void flush()
+    {
+        if (m_len)
+        {
+            ssd1306_intf.send_buffer(m_buffer, m_len);
+            m_len = 0;
+        }
+    }
+};
+
+template <uint16_t N> uint8_t Ssd1306StagedIntf<N>::m_buffer[N];
+template <uint16_t N> uint16_t Ssd1306StagedIntf<N>::m_len = 0;
+
+/**
+ * Direct draw functions specialized for Panel and Intf. Produce the same output as
+ * ssd1306_fillScreen(), ssd1306_clearBlock(), ssd1306_fillRect() and ssd1306_printFixed().
+ */
+template <class Panel, class Intf = Ssd1306StagedIntf<32> >
+class Ssd1306Driver
+{
+public:
+    /** Starts output block, see ssd1306_lcd.set_block */
+    static void setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
+    {
+        uint8_t cmd[6];
+        Intf::startBlock(cmd, Panel::blockCommands(cmd, x, y, w));
+    }
+
+    /** Fills whole display with byte pattern */
+    static void fillScreen(uint8_t data)
+    {
+        setBlock(0, 0, 0);
+        Intf::fill(data, Panel::width * Panel::pages);
+        Intf::stop();
+    }
+
+    /** Fills block with byte pattern, y in pages, h in pixels */
+    static void clearBlock(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t data)
+    {
+        setBlock(x, y, w);
+        Intf::fill(data, (uint16_t)w * (h >> 3));
+        Intf::stop();
+    }
+
+    /** Fills rectangle with byte pattern */
+    static void fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint8_t pattern)
+    {
+        if (x1 > x2) return;
+        if (y1 > y2) return;
+        if ((lcduint_t)x2 >= Panel::width) x2 = (lcdint_t)Panel::width - 1;
+        if ((lcduint_t)y2 >= Panel::height) y2 = (lcdint_t)Panel::height - 1;
+        uint8_t bank1 = (y1 >> 3);
+        uint8_t bank2 = (y2 >> 3);
+        setBlock(x1, bank1, x2 - x1 + 1);
+        for (uint8_t bank = bank1; bank<=bank2; bank++)
+        {
+            uint8_t mask = 0xFF;
+            if (bank1 == bank2)
+            {
+                mask = (mask >> ((y1 & 7) + 7 - (y2 & 7))) << (y1 & 7);
+            }
+            else if (bank1 == bank)
+            {
+                mask = (mask << (y1 & 7));
+            }
+            else if (bank2 == bank)
+            {
+                mask = (mask >> (7 - (y2 & 7)));
+            }
+            Intf::fill(pattern & mask, x2 - x1 + 1);
+        }
+        Intf::stop();
+    }
+
+    /** Prints text with current fixed font, see ssd1306_printFixed() */
+    static uint8_t printFixed(uint8_t xpos, uint8_t y, const char *ch, EFontStyle style)
+    {
+        uint8_t i, j=0;
+        uint8_t text_index = 0;
+        uint8_t page_offset = 0;
+        uint8_t x = xpos;
+        y >>= 3;
+        setBlock(xpos, y, Panel::width - xpos);
+        for(;;)
+        {
+            uint8_t ldata;
+            if ((x > Panel::width - s_fixedFont.h.width) || (ch[j] == '\0'))
+            {
+                x = xpos;
+                y++;
+                if (y >= Panel::pages)
+                {
+                    break;
+                }
+                page_offset++;
+                if (page_offset == s_fixedFont.pages)
+                {
+                    text_index = j;
+                    page_offset = 0;
+                    if (ch[j] == '\0')
+                    {
+                        break;
+                    }
+                }
+                else
+                {
+                    j = text_index;
+                }
+                Intf::stop();
+                setBlock(xpos, y, Panel::width - xpos);
+            }
+            uint16_t unicode;
+            if ((uint8_t)ch[j] < 0x80)
+            {
+                // ascii needs no utf-8 decoding, but ends any sequence the decoder left pending
+                ssd1306_unicode16Reset();
+                unicode = (uint8_t)ch[j];
+                j++;
+            }
+            else
+            {
+                do
+                {
+                    unicode = ssd1306_unicode16FromUtf8(ch[j]);
+                    j++;
+                } while ( unicode == SSD1306_MORE_CHARS_REQUIRED );
+            }
+            SCharInfo char_info;
+            ssd1306_getCharBitmap(unicode, &char_info);
+            ldata = 0;
+            x += char_info.width + char_info.spacing;
+            if (char_info.height > page_offset * 8)
+            {
+                char_info.glyph += page_offset * char_info.width;
+                for( i = char_info.width; i>0; i--)
+                {
+                    uint8_t data;
+                    if ( style == STYLE_NORMAL )
+                    {
+                        data = pgm_read_byte(&char_info.glyph[0]);
+                    }
+                    else if ( style == STYLE_BOLD )
+                    {
+                        uint8_t temp = pgm_read_byte(&char_info.glyph[0]);
+                        data = temp | ldata;
+                        ldata = temp;
+                    }
+                    else
+                    {
+                        uint8_t temp = pgm_read_byte(&char_info.glyph[1]);
+                        data = (temp & 0xF0) | ldata;
+                        ldata = (temp & 0x0F);
+                    }
+                    Intf::send(data^s_ssd1306_invertByte);
+                    char_info.glyph++;
+                }
+            }
+            else
+            {
+                char_info.spacing += char_info.width;
+            }
+            Intf::fill(s_ssd1306_invertByte, char_info.spacing);
+        }
+        Intf::stop();
+        return j;
+    }
+
+    /** Entry points for ssd1306_setStaticDriver() */
+    static const ssd1306_static_driver_t *ops()
+    {
+        static const ssd1306_static_driver_t s_ops =
+        {
+            Panel::width,
+            Panel::height,
+            fillScreen,
+            clearBlock,
+            fillRect,
+            printFixed,
+        };
+        return &s_ops;
+    }
+};
+
+/**
+ * @}
+ */
+
+#endif // __cplusplus
+
+#endif // _SSD1306_DRIVER_H_
@@ -95,28 +95,39 @@ void ssd1306_getCharBitmap(uint16_t unicode, SCharInfo *info)
     return s_ssd1306_getCharBitmap( unicode, info );
 }
 
+#ifdef CONFIG_SSD1306_UNICODE_ENABLE
+static uint16_t s_utf8_lead = 0;
+#endif
+
 uint16_t ssd1306_unicode16FromUtf8(uint8_t ch)
 {
 #ifdef CONFIG_SSD1306_UNICODE_ENABLE
-    static uint16_t unicode = 0;
+    uint16_t unicode = s_utf8_lead;
     ch &= 0x000000FF;
     if (!unicode)
     {
         if ( ch >= 0xc0 )
         {
-            unicode = ch;
+            s_utf8_lead = ch;
             return SSD1306_MORE_CHARS_REQUIRED;
         }
         return ch;
     }
     uint16_t code = ((unicode & 0x1f) << 6) | (ch & 0x3f);
-    unicode = 0;
+    s_utf8_lead = 0;
     return code;
 #else
     return ch;
 #endif
 }
 
+void ssd1306_unicode16Reset(void)
+{
+#ifdef CONFIG_SSD1306_UNICODE_ENABLE
+    s_utf8_lead = 0;
+#endif
+}
+
 void ssd1306_enableUtf8Mode(void)
 {
 #ifdef CONFIG_SSD1306_UNICODE_ENABLE
@@ -152,6 +152,13 @@ void ssd1306_setSquixFont(const uint8_t * progmemFont);
  *         SSD1306_MORE_CHARS_REQUIRED if more characters is expected
  */
 uint16_t ssd1306_unicode16FromUtf8(uint8_t ch);
+
+/**
+ * Drops a multibyte sequence left pending by ssd1306_unicode16FromUtf8().
+ * Callers that take ascii bytes without the decoder call it first, so a stray
+ * lead byte does not combine with the next non-ascii character.
+ */
+void ssd1306_unicode16Reset(void);
 #endif
 
 /**
@@ -0,0 +1,123 @@
+/**
+ * @file ssd1306_glyph_cache.c Pre-scaled glyph cache for ssd1306_printFixedN()
+ */
+
+#include "ssd1306_glyph_cache.h"
+#include "ssd1306_generic.h"
+#include "ssd1306_hal/io.h"
+#include <stdlib.h>
+
+#define GLYPH_CACHE_COUNT   (sizeof(SSD1306_GLYPH_CACHE_CHARS) - 1)
+
+extern SFixedFontInfo s_fixedFont;
+
+/* Allocated on first font that fits, so a disabled or unused cache costs no RAM */
+static uint8_t *s_glyphs = NULL;
+static uint16_t s_capacity = 0;
+static const uint8_t *s_font = NULL;
+static uint8_t s_factor;
+static uint8_t s_valid = 0;
+static uint8_t s_enabled = 1;
+static uint16_t s_glyphSize;
+
+void ssd1306_setGlyphCache(uint8_t enable)
+{
+    s_enabled = enable;
+    if (!enable)
+    {
+        free(s_glyphs);
+        s_glyphs = NULL;
+        s_capacity = 0;
+        s_font = NULL;
+        s_valid = 0;
+    }
+}
+
+static uint8_t scaleByte(uint8_t data, uint8_t factor, uint8_t page_offset)
+{
+    uint8_t accum = 0;
+    uint8_t mask = ~((0xFF) << (1<<factor));
+    // Same expansion as ssd1306_printFixedN(): page_offset selects source bits of the output page
+    data >>= ((page_offset & ((1<<factor) - 1))<<(3-factor));
+    for (uint8_t idx = 0; idx < 1<<(3-factor); idx++)
+    {
+         accum |= (((data>>idx) & 0x01) ? (mask<<(idx<<factor)) : 0);
+    }
+    return accum;
+}
+
+static void buildCache(uint8_t factor)
+{
+    uint8_t width = s_fixedFont.h.width << factor;
+    uint8_t pages = s_fixedFont.pages << factor;
+    s_font = s_fixedFont.primary_table;
+    s_factor = factor;
+    s_valid = 0;
+    s_glyphSize = (uint16_t)width * pages;
+    if (factor > 3 || (uint32_t)s_glyphSize * GLYPH_CACHE_COUNT > SSD1306_GLYPH_CACHE_SIZE)
+    {
+        return;
+    }
+    if (s_capacity < s_glyphSize * GLYPH_CACHE_COUNT)
+    {
+        free(s_glyphs);
+        s_capacity = 0;
+        s_glyphs = (uint8_t *)malloc(s_glyphSize * GLYPH_CACHE_COUNT);
+        if (!s_glyphs)
+        {
+            return;
+        }
+        s_capacity = s_glyphSize * GLYPH_CACHE_COUNT;
+    }
+    for (uint8_t g = 0; g < GLYPH_CACHE_COUNT; g++)
+    {
+        SCharInfo char_info;
+        uint8_t *dst = &s_glyphs[g * s_glyphSize];
+        ssd1306_getCharBitmap(SSD1306_GLYPH_CACHE_CHARS[g], &char_info);
+        if ((char_info.width != s_fixedFont.h.width) || char_info.spacing)
+        {
+            // Proportional glyph: printFixedN() advance would differ, keep runtime scaling
+            return;
+        }
+        for (uint8_t page_offset = 0; page_offset < pages; page_offset++)
+        {
+            uint8_t row = page_offset >> factor;
+            const uint8_t *src = char_info.glyph + row * char_info.width;
+            for (uint8_t i = 0; i < char_info.width; i++)
+            {
+                uint8_t data = (char_info.height > row * 8) ? scaleByte(pgm_read_byte(&src[i]), factor, page_offset) : 0;
+                for (uint8_t z = (1<<factor); z > 0; z--)
+                {
+                    *dst++ = data;
+                }
+            }
+        }
+    }
+    s_valid = 1;
+}
+
+const uint8_t *ssd1306_getCachedGlyph(uint8_t ch, uint8_t factor)
+{
+    uint8_t g;
+    if (!s_enabled || !factor)
+    {
+        return NULL;
+    }
+    if ((ch >= '0') && (ch <= '9'))
+    {
+        g = ch - '0';
+    }
+    else
+    {
+        for (g = 10; (g < GLYPH_CACHE_COUNT) && (SSD1306_GLYPH_CACHE_CHARS[g] != ch); g++);
+        if (g == GLYPH_CACHE_COUNT)
+        {
+            return NULL;
+        }
+    }
+    if ((s_font != s_fixedFont.primary_table) || (s_factor != factor))
+    {
+        buildCache(factor);
+    }
+    return s_valid ? &s_glyphs[g * s_glyphSize] : NULL;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file ssd1306_glyph_cache.h Pre-scaled glyph cache for ssd1306_printFixedN()
+ */
+
+#ifndef _SSD1306_GLYPH_CACHE_H_
+#define _SSD1306_GLYPH_CACHE_H_
+
+#include "nano_gfx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LCD_GLYPH_CACHE DIRECT DRAW: pre-scaled glyph cache for 1-bit displays
+ * @{
+ * @brief Keeps scaled digits of the current fixed font in RAM for ssd1306_printFixedN().
+ *
+ * @details ssd1306_printFixedN() scales every glyph bit by bit for each page it draws.
+ *        For characters listed in SSD1306_GLYPH_CACHE_CHARS the scaled bytes are computed
+ *        once, on first use of a font and scale factor, and later calls send them as is.
+ *        The cache holds one font/factor pair and is rebuilt when either changes. It is
+ *        used for STYLE_NORMAL only, and only if all cached glyphs have font's fixed width
+ *        and fit in SSD1306_GLYPH_CACHE_SIZE bytes (8x16 font at FONT_SIZE_2X needs 832 bytes).
+ */
+
+/** Characters kept in the cache */
+#define SSD1306_GLYPH_CACHE_CHARS   "0123456789 -."
+
+#ifndef SSD1306_GLYPH_CACHE_SIZE
+/** Largest cache allowed, bytes. The buffer is allocated from heap on first use, sized for the font */
+#define SSD1306_GLYPH_CACHE_SIZE    1024
+#endif
+
+/**
+ * Enables or disables the glyph cache (enabled by default).
+ * Disabling frees the cache buffer and makes ssd1306_printFixedN() scale glyphs at runtime again.
+ * @param enable - non-zero to enable cache
+ */
+void         ssd1306_setGlyphCache(uint8_t enable);
+
+/**
+ * Returns scaled glyph of the current fixed font, building the cache if font or factor changed.
+ * Bytes are stored page by page: (pages << factor) rows of (width << factor) bytes.
+ * @param ch - ascii character
+ * @param factor - scale factor, as for ssd1306_printFixedN()
+ * @return pointer to scaled glyph or NULL if character is not cached
+ */
+const uint8_t *ssd1306_getCachedGlyph(uint8_t ch, uint8_t factor);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SSD1306_GLYPH_CACHE_H_
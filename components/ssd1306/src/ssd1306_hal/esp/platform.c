@@ -73,16 +73,38 @@ void delay(uint32_t ms)     // delay()
 #include <stdio.h>
 #include "driver/i2c.h"
 
+#ifndef SSD1306_ESP_I2C_BUFFER_SIZE
+/** Staging buffer for one transaction: full 128x64 frame plus block address header */
+#define SSD1306_ESP_I2C_BUFFER_SIZE  (1024 + 16)
+#endif
+
 static uint8_t s_i2c_addr = 0x3C;
 static int8_t s_bus_id;
 
 static i2c_cmd_handle_t s_cmd_handle = NULL;
+/* Bytes of current transaction. Command link keeps pointers to queued buffers, not copies,
+ * so staged bytes must stay untouched until platform_i2c_stop() executes the link. */
+static uint8_t s_buffer[SSD1306_ESP_I2C_BUFFER_SIZE];
+static uint16_t s_len = 0;
+static uint16_t s_queued = 0;
+
+/* Appends staged bytes not yet added to the command link as a single write command */
+static void platform_i2c_queue(void)
+{
+    if (s_len > s_queued)
+    {
+        i2c_master_write(s_cmd_handle, &s_buffer[s_queued], s_len - s_queued, true);
+        s_queued = s_len;
+    }
+}
 
 static void platform_i2c_start(void)
 {
     // ... Open i2c channel for your device with specific s_i2c_addr
     if (s_cmd_handle == NULL)
         s_cmd_handle = i2c_cmd_link_create();
+    s_len = 0;
+    s_queued = 0;
     i2c_master_start(s_cmd_handle);
     i2c_master_write_byte(s_cmd_handle, ( s_i2c_addr << 1 ) | I2C_MASTER_WRITE, 0x1);
 }
@@ -90,8 +112,11 @@ static void platform_i2c_start(void)
 static void platform_i2c_stop(void)
 {
     // ... Complete i2c communication
+    platform_i2c_queue();
     i2c_master_stop(s_cmd_handle);
     /*esp_err_t ret =*/ i2c_master_cmd_begin(s_bus_id, s_cmd_handle, 1000 / portTICK_RATE_MS);
+    // SDK has no way to reset a link: it is rebuilt per transaction, but with 4 commands
+    // (start, address, data, stop) instead of one per byte
     i2c_cmd_link_delete(s_cmd_handle);
     s_cmd_handle = NULL;
 }
@@ -99,7 +124,16 @@ static void platform_i2c_stop(void)
 static void platform_i2c_send(uint8_t data)
 {
     // ... Send byte to i2c communication channel
-    i2c_master_write_byte(s_cmd_handle, data, 0x1);
+    if (s_len < sizeof(s_buffer))
+    {
+        s_buffer[s_len++] = data;
+    }
+    else
+    {
+        // Staging buffer is full: queue what is staged and fall back to per-byte commands
+        platform_i2c_queue();
+        i2c_master_write_byte(s_cmd_handle, data, 0x1);
+    }
 }
 
 static void platform_i2c_close(void)
@@ -111,12 +145,17 @@ static void platform_i2c_close(void)
 static void platform_i2c_send_buffer(const uint8_t *data, uint16_t len)
 {
     // ... Send len bytes to i2c communication channel here
+    uint16_t room = sizeof(s_buffer) - s_len;
+    uint16_t n = len < room ? len : room;
+    memcpy(&s_buffer[s_len], data, n);
+    s_len += n;
+    data += n;
+    len -= n;
     while (len--)
     {
         platform_i2c_send(*data);
         data++;
     }
-//    i2c_master_write(cmd, data_wr, size, ACK_CHECK_EN);
 }
 
 void ssd1306_platform_i2cInit(int8_t busId, uint8_t addr, ssd1306_platform_i2cConfig_t * cfg)
@@ -135,20 +174,23 @@ void ssd1306_platform_i2cInit(int8_t busId, uint8_t addr, ssd1306_platform_i2cCo
     s_bus_id = busId;
 
     i2c_config_t conf = { 0 };
-    conf.mode = 0;
+    conf.mode = I2C_MODE_MASTER;
     conf.sda_io_num = cfg->sda >= 0 ? cfg->sda : 21;
     conf.sda_pullup_en = GPIO_PULLUP_ENABLE;
     conf.scl_io_num = cfg->scl >= 0 ? cfg->scl : 22;
     conf.scl_pullup_en = GPIO_PULLUP_ENABLE;
-    //conf.master.clk_speed = 400000; //I2C_EXAMPLE_MASTER_FREQ_HZ;
-
-    i2c_driver_install(s_bus_id, 0);
+#if defined(I2C_APB_CLK_FREQ)
+    // Hardware controller (esp-idf): fast mode
+    conf.master.clk_speed = 400000;
     i2c_param_config(s_bus_id, &conf);
-
-    
-    // i2c_driver_install(s_bus_id, conf.mode, 0, 0, 0);
-    //                    I2C_EXAMPLE_MASTER_RX_BUF_DISABLE,
-    //                    I2C_EXAMPLE_MASTER_TX_BUF_DISABLE, 0);
+    i2c_driver_install(s_bus_id, conf.mode, 0, 0, 0);
+#else
+    // ESP8266 RTOS SDK drives the bus in software with fixed timing: there is no clock setting,
+    // clk_stretch_tick is only the timeout for a slave stretching SCL (300 ticks, about 200 us).
+    conf.clk_stretch_tick = 300;
+    i2c_driver_install(s_bus_id, conf.mode);
+    i2c_param_config(s_bus_id, &conf);
+#endif
 }
 #endif
 
@@ -0,0 +1,127 @@
+/**
+ * @file ssd1306_pages.c Page-at-a-time rendering for 1-bit displays
+ */
+
+#include "ssd1306_pages.h"
+#include "lcd/lcd_common.h"
+#include "intf/ssd1306_interface.h"
+#include <string.h>
+
+static uint8_t s_pageBuffer[SSD1306_PAGE_BUFFER_WIDTH];
+static lcduint_t s_renderPage;
+
+/* Emulated controller cursor (horizontal addressing mode) */
+static lcduint_t s_blockX0;
+static lcduint_t s_blockX1;
+static lcduint_t s_blockPage;
+static lcduint_t s_col;
+static lcduint_t s_page;
+static uint8_t s_blockOpen = 0;
+
+/* Display functions replaced while page is being drawn */
+static void (*s_setBlock)(lcduint_t x, lcduint_t y, lcduint_t w);
+static void (*s_nextPage)(void);
+static void (*s_sendPixels1)(uint8_t data);
+static void (*s_sendPixelsBuffer1)(const uint8_t *buffer, uint16_t len);
+static void (*s_stop)(void);
+
+static void pageSetBlock(lcduint_t x, lcduint_t y, lcduint_t w)
+{
+    s_blockX0 = x;
+    s_blockX1 = w ? (x + w - 1) : (ssd1306_lcd.width - 1);
+    s_blockPage = y;
+    s_col = x;
+    s_page = y;
+    s_blockOpen = 1;
+}
+
+static void pageNextPage(void)
+{
+    // Controller wraps to next page by itself once block width is written
+    if (s_col != s_blockX0)
+    {
+        s_col = s_blockX0;
+        s_page++;
+    }
+}
+
+static void pageSendPixels1(uint8_t data)
+{
+    if ((s_page == s_renderPage) && (s_col < ssd1306_lcd.width))
+    {
+        s_pageBuffer[s_col] = data;
+    }
+    if (++s_col > s_blockX1)
+    {
+        s_col = s_blockX0;
+        if (++s_page >= (ssd1306_lcd.height >> 3))
+        {
+            s_page = s_blockPage;
+        }
+    }
+}
+
+static void pageSendPixelsBuffer1(const uint8_t *buffer, uint16_t len)
+{
+    while (len--)
+    {
+        pageSendPixels1(*buffer++);
+    }
+}
+
+static void pageStop(void)
+{
+    // Closes draw session opened by pageSetBlock(); commands still reach the display
+    if (s_blockOpen)
+    {
+        s_blockOpen = 0;
+        return;
+    }
+    s_stop();
+}
+
+int8_t ssd1306_renderPages(SSD1306PageDrawFunc draw, void *arg)
+{
+    lcduint_t width = ssd1306_lcd.width;
+    if (width > SSD1306_PAGE_BUFFER_WIDTH)
+    {
+        return -1;
+    }
+    s_setBlock = ssd1306_lcd.set_block;
+    s_nextPage = ssd1306_lcd.next_page;
+    s_sendPixels1 = ssd1306_lcd.send_pixels1;
+    s_sendPixelsBuffer1 = ssd1306_lcd.send_pixels_buffer1;
+    s_stop = ssd1306_intf.stop;
+
+    for (s_renderPage = 0; s_renderPage < (ssd1306_lcd.height >> 3); s_renderPage++)
+    {
+        memset(s_pageBuffer, 0, width);
+        s_blockOpen = 0;
+        ssd1306_lcd.set_block = pageSetBlock;
+        ssd1306_lcd.next_page = pageNextPage;
+        ssd1306_lcd.send_pixels1 = pageSendPixels1;
+        ssd1306_lcd.send_pixels_buffer1 = pageSendPixelsBuffer1;
+        ssd1306_intf.stop = pageStop;
+        draw(s_renderPage, arg);
+
+        ssd1306_lcd.set_block = s_setBlock;
+        ssd1306_lcd.next_page = s_nextPage;
+        ssd1306_lcd.send_pixels1 = s_sendPixels1;
+        ssd1306_lcd.send_pixels_buffer1 = s_sendPixelsBuffer1;
+        ssd1306_intf.stop = s_stop;
+        s_setBlock(0, s_renderPage, width);
+        if (s_sendPixelsBuffer1)
+        {
+            s_sendPixelsBuffer1(s_pageBuffer, width);
+        }
+        else
+        {
+            for (lcduint_t i = 0; i < width; i++)
+            {
+                s_sendPixels1(s_pageBuffer[i]);
+            }
+        }
+        s_stop();
+    }
+    return 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file ssd1306_pages.h Page-at-a-time rendering for 1-bit displays
+ */
+
+#ifndef _SSD1306_PAGES_H_
+#define _SSD1306_PAGES_H_
+
+#include "nano_gfx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LCD_PAGE_RENDER DIRECT DRAW: page-at-a-time rendering for 1-bit displays
+ * @{
+ * @brief Redraws the whole screen through a single page buffer (128 bytes of RAM).
+ *
+ * @details ssd1306_renderPages() calls user draw function once for every 8-pixel page.
+ *        During the call 1-bit direct draw functions (ssd1306_printFixed(), ssd1306_fillRect(),
+ *        ...) write into a page buffer, emulating controller addressing, and bytes falling
+ *        outside of current page are dropped. The buffer is then sent to the display in one
+ *        block, so full screen update costs one transaction per page.
+ *        For C++ NanoCanvas1 drawing use NanoCanvasPages1.
+ */
+
+/** Maximum display width supported by page rendering */
+#define SSD1306_PAGE_BUFFER_WIDTH   128
+
+/**
+ * Draw function called for every page.
+ * It should draw whole screen content; drawing outside of page can be skipped to save cpu.
+ * @param page - page being rendered (y / 8)
+ * @param arg - user argument passed to ssd1306_renderPages()
+ */
+typedef void (*SSD1306PageDrawFunc)(uint8_t page, void *arg);
+
+/**
+ * Renders whole screen page by page. Each page starts cleared (black).
+ * @param draw - function drawing screen content
+ * @param arg - user argument for draw function
+ * @return 0 on success, -1 if display is wider than the page buffer
+ */
+int8_t       ssd1306_renderPages(SSD1306PageDrawFunc draw, void *arg);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SSD1306_PAGES_H_
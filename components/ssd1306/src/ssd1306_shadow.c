@@ -0,0 +1,399 @@
+/**
+ * @file ssd1306_shadow.c Shadow framebuffer and bus statistics for 1-bit direct draw
+ */
+
+#include "ssd1306_shadow.h"
+#include "lcd/lcd_common.h"
+#include "intf/ssd1306_interface.h"
+#include <string.h>
+
+#define SHADOW_WIDTH        128
+#define SHADOW_PAGES        8
+/** Bytes sent to switch block on i2c: 6 address commands with Co=1 control bytes + data control byte */
+#define SHADOW_BLOCK_COST   13
+/** Worst case of runs per page: each run is followed by a gap longer than SHADOW_BLOCK_COST */
+#define SHADOW_MAX_RUNS     (SHADOW_WIDTH / (SHADOW_BLOCK_COST + 2) + 1)
+
+typedef struct
+{
+    uint8_t x0;
+    uint8_t x1;
+} SShadowRun;
+
+static uint8_t s_shadow[SHADOW_PAGES * SHADOW_WIDTH];
+static uint8_t s_dirty[SHADOW_PAGES][SHADOW_WIDTH / 8];
+static SShadowRun s_runs[SHADOW_PAGES][SHADOW_MAX_RUNS];
+static uint8_t s_runCount[SHADOW_PAGES];
+static uint8_t s_shadowEnabled = 0;
+/* Columns added to every x written through the shadow, wrapping at display width */
+static lcduint_t s_offset = 0;
+
+/* Emulated controller cursor (horizontal addressing mode) */
+static lcduint_t s_blockX0;
+static lcduint_t s_blockX1;
+static lcduint_t s_blockPage;
+static lcduint_t s_col;
+static lcduint_t s_page;
+static uint8_t s_blockOpen = 0;
+
+/* Display functions replaced while shadow mode is active */
+static void (*s_setBlock)(lcduint_t x, lcduint_t y, lcduint_t w);
+static void (*s_nextPage)(void);
+static void (*s_sendPixels1)(uint8_t data);
+static void (*s_sendPixelsBuffer1)(const uint8_t *buffer, uint16_t len);
+static void (*s_stop)(void);
+
+/* Bus functions wrapped by counters */
+static SSD1306BusStats s_busStats;
+static void (*s_busStart)(void) = NULL;
+static void (*s_busSend)(uint8_t data);
+static void (*s_busSendBuffer)(const uint8_t *buffer, uint16_t size);
+static void (*s_busPixels1)(uint8_t data);
+static void (*s_busPixelsBuffer1)(const uint8_t *buffer, uint16_t len);
+
+///////////////////////////////////////////////////////////////////////////////
+//                       BUS STATISTICS
+///////////////////////////////////////////////////////////////////////////////
+
+static void busStart(void)
+{
+    s_busStats.transactions++;
+    s_busStart();
+}
+
+static void busSend(uint8_t data)
+{
+    s_busStats.bytes++;
+    s_busSend(data);
+}
+
+static void busSendBuffer(const uint8_t *buffer, uint16_t size)
+{
+    s_busStats.bytes += size;
+    s_busSendBuffer(buffer, size);
+}
+
+static void busPixels1(uint8_t data)
+{
+    s_busStats.bytes++;
+    s_busPixels1(data);
+}
+
+static void busPixelsBuffer1(const uint8_t *buffer, uint16_t len)
+{
+    s_busStats.bytes += len;
+    s_busPixelsBuffer1(buffer, len);
+}
+
+void ssd1306_enableBusStats(void)
+{
+    if (s_busStart != NULL)
+    {
+        return;
+    }
+    s_busStart = ssd1306_intf.start;
+    ssd1306_intf.start = busStart;
+    s_busSend = ssd1306_intf.send;
+    ssd1306_intf.send = busSend;
+    if (ssd1306_intf.send_buffer)
+    {
+        s_busSendBuffer = ssd1306_intf.send_buffer;
+        ssd1306_intf.send_buffer = busSendBuffer;
+    }
+    // lcd keeps its own copies of interface functions for pixel data
+    s_busPixels1 = ssd1306_lcd.send_pixels1;
+    ssd1306_lcd.send_pixels1 = busPixels1;
+    if (ssd1306_lcd.send_pixels_buffer1)
+    {
+        s_busPixelsBuffer1 = ssd1306_lcd.send_pixels_buffer1;
+        ssd1306_lcd.send_pixels_buffer1 = busPixelsBuffer1;
+    }
+    memset(&s_busStats, 0, sizeof(s_busStats));
+}
+
+void ssd1306_getBusStats(SSD1306BusStats *stats, uint8_t reset)
+{
+    *stats = s_busStats;
+    if (reset)
+    {
+        memset(&s_busStats, 0, sizeof(s_busStats));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//                       SHADOW FRAMEBUFFER
+///////////////////////////////////////////////////////////////////////////////
+
+static void shadowSetBlock(lcduint_t x, lcduint_t y, lcduint_t w)
+{
+    s_blockX0 = x;
+    s_blockX1 = w ? (x + w - 1) : (ssd1306_lcd.width - 1);
+    s_blockPage = y;
+    s_col = x;
+    s_page = y;
+    s_blockOpen = 1;
+}
+
+static void shadowNextPage(void)
+{
+    // Controller wraps to next page by itself once block width is written
+    if (s_col != s_blockX0)
+    {
+        s_col = s_blockX0;
+        s_page++;
+    }
+}
+
+static void shadowSendPixels1(uint8_t data)
+{
+    if ((s_page < (ssd1306_lcd.height >> 3)) && (s_col < ssd1306_lcd.width))
+    {
+        lcduint_t col = s_col + s_offset;
+        if (col >= ssd1306_lcd.width)
+        {
+            col -= ssd1306_lcd.width;
+        }
+        uint8_t *cell = &s_shadow[s_page * SHADOW_WIDTH + col];
+        if (*cell != data)
+        {
+            *cell = data;
+            s_dirty[s_page][col >> 3] |= (1 << (col & 0x07));
+        }
+    }
+    if (++s_col > s_blockX1)
+    {
+        s_col = s_blockX0;
+        if (++s_page >= (ssd1306_lcd.height >> 3))
+        {
+            s_page = s_blockPage;
+        }
+    }
+}
+
+static void shadowSendPixelsBuffer1(const uint8_t *buffer, uint16_t len)
+{
+    while (len--)
+    {
+        shadowSendPixels1(*buffer++);
+    }
+}
+
+static void shadowStop(void)
+{
+    // Closes draw session opened by shadowSetBlock(); commands still reach the display
+    if (s_blockOpen)
+    {
+        s_blockOpen = 0;
+        return;
+    }
+    s_stop();
+}
+
+int8_t ssd1306_enableShadowBuffer(void)
+{
+    if ((ssd1306_lcd.width > SHADOW_WIDTH) || ((ssd1306_lcd.height >> 3) > SHADOW_PAGES))
+    {
+        return -1;
+    }
+    if (s_shadowEnabled)
+    {
+        return 0;
+    }
+    memset(s_shadow, 0, sizeof(s_shadow));
+    memset(s_dirty, 0xFF, sizeof(s_dirty));
+    s_blockOpen = 0;
+    s_offset = 0;
+
+    s_setBlock = ssd1306_lcd.set_block;
+    s_nextPage = ssd1306_lcd.next_page;
+    s_sendPixels1 = ssd1306_lcd.send_pixels1;
+    s_sendPixelsBuffer1 = ssd1306_lcd.send_pixels_buffer1;
+    s_stop = ssd1306_intf.stop;
+    ssd1306_lcd.set_block = shadowSetBlock;
+    ssd1306_lcd.next_page = shadowNextPage;
+    ssd1306_lcd.send_pixels1 = shadowSendPixels1;
+    ssd1306_lcd.send_pixels_buffer1 = shadowSendPixelsBuffer1;
+    ssd1306_intf.stop = shadowStop;
+    s_shadowEnabled = 1;
+    return 0;
+}
+
+void ssd1306_disableShadowBuffer(void)
+{
+    if (!s_shadowEnabled)
+    {
+        return;
+    }
+    ssd1306_flush();
+    ssd1306_lcd.set_block = s_setBlock;
+    ssd1306_lcd.next_page = s_nextPage;
+    ssd1306_lcd.send_pixels1 = s_sendPixels1;
+    ssd1306_lcd.send_pixels_buffer1 = s_sendPixelsBuffer1;
+    ssd1306_intf.stop = s_stop;
+    s_shadowEnabled = 0;
+}
+
+void ssd1306_scrollShadow(uint8_t startPage, uint8_t endPage, int8_t columns)
+{
+    lcduint_t width = ssd1306_lcd.width;
+    uint8_t tmp[SHADOW_WIDTH];
+    if (!s_shadowEnabled)
+    {
+        return;
+    }
+    // Shift in range 0..width-1 towards last column, controller wraps content around
+    lcduint_t shift = (lcduint_t)((columns % (int)width + (int)width) % (int)width);
+    if (!shift)
+    {
+        return;
+    }
+    for (lcduint_t page = startPage; (page <= endPage) && (page < (ssd1306_lcd.height >> 3)); page++)
+    {
+        uint8_t *row = &s_shadow[page * SHADOW_WIDTH];
+        memcpy(tmp, row, width);
+        memcpy(&row[shift], tmp, width - shift);
+        memcpy(row, &tmp[width - shift], shift);
+    }
+}
+
+void ssd1306_invalidateShadow(uint8_t startPage, uint8_t endPage)
+{
+    if (!s_shadowEnabled)
+    {
+        return;
+    }
+    for (lcduint_t page = startPage; (page <= endPage) && (page < (ssd1306_lcd.height >> 3)); page++)
+    {
+        memset(s_dirty[page], 0xFF, sizeof(s_dirty[page]));
+    }
+}
+
+void ssd1306_setShadowOffset(uint8_t columns)
+{
+    lcduint_t width = ssd1306_lcd.width;
+    uint8_t tmp[SHADOW_WIDTH];
+    if (!s_shadowEnabled)
+    {
+        return;
+    }
+    columns %= width;
+    lcduint_t shift = (lcduint_t)((columns + width - s_offset) % width);
+    s_offset = columns;
+    if (!shift)
+    {
+        return;
+    }
+    // Content moves with the offset; bytes that change on the display are marked dirty
+    for (lcduint_t page = 0; page < (ssd1306_lcd.height >> 3); page++)
+    {
+        uint8_t *row = &s_shadow[page * SHADOW_WIDTH];
+        memcpy(tmp, row, width);
+        for (lcduint_t x = 0; x < width; x++)
+        {
+            lcduint_t src = (x + width - shift) % width;
+            if (row[x] != tmp[src])
+            {
+                row[x] = tmp[src];
+                s_dirty[page][x >> 3] |= (1 << (x & 0x07));
+            }
+        }
+    }
+}
+
+static void shadowSendBlock(lcduint_t x0, lcduint_t x1, lcduint_t page0, lcduint_t page1)
+{
+    lcduint_t w = x1 - x0 + 1;
+    s_setBlock(x0, page0, w);
+    for (lcduint_t page = page0; page <= page1; page++)
+    {
+        const uint8_t *src = &s_shadow[page * SHADOW_WIDTH + x0];
+        if (s_sendPixelsBuffer1)
+        {
+            s_sendPixelsBuffer1(src, w);
+        }
+        else
+        {
+            for (lcduint_t i = 0; i < w; i++)
+            {
+                s_sendPixels1(src[i]);
+            }
+        }
+        s_nextPage();
+    }
+    s_stop();
+}
+
+void ssd1306_flush(void)
+{
+    if (!s_shadowEnabled)
+    {
+        return;
+    }
+    lcduint_t pages = ssd1306_lcd.height >> 3;
+    lcduint_t width = ssd1306_lcd.width;
+    lcduint_t minX = width, maxX = 0, minPage = pages, maxPage = 0;
+    uint32_t runsCost = 0;
+
+    // Collect dirty runs; gaps cheaper than a new block are sent along with the run
+    for (lcduint_t page = 0; page < pages; page++)
+    {
+        uint8_t count = 0;
+        for (lcduint_t x = 0; x < width; x++)
+        {
+            if (!(x & 0x07) && !s_dirty[page][x >> 3])
+            {
+                x += 7;
+                continue;
+            }
+            if (!(s_dirty[page][x >> 3] & (1 << (x & 0x07))))
+            {
+                continue;
+            }
+            if (count && (x - s_runs[page][count - 1].x1 - 1 <= SHADOW_BLOCK_COST))
+            {
+                s_runs[page][count - 1].x1 = x;
+            }
+            else
+            {
+                s_runs[page][count].x0 = x;
+                s_runs[page][count].x1 = x;
+                count++;
+            }
+        }
+        s_runCount[page] = count;
+        if (!count)
+        {
+            continue;
+        }
+        for (uint8_t r = 0; r < count; r++)
+        {
+            runsCost += s_runs[page][r].x1 - s_runs[page][r].x0 + 1 + SHADOW_BLOCK_COST;
+        }
+        if (s_runs[page][0].x0 < minX) minX = s_runs[page][0].x0;
+        if (s_runs[page][count - 1].x1 > maxX) maxX = s_runs[page][count - 1].x1;
+        if (page < minPage) minPage = page;
+        maxPage = page;
+    }
+    if (minPage == pages)
+    {
+        return;
+    }
+
+    // One block over the bounding box if it is cheaper than separate runs
+    uint32_t boxCost = (uint32_t)(maxX - minX + 1) * (maxPage - minPage + 1) + SHADOW_BLOCK_COST;
+    if (boxCost <= runsCost)
+    {
+        shadowSendBlock(minX, maxX, minPage, maxPage);
+    }
+    else
+    {
+        for (lcduint_t page = minPage; page <= maxPage; page++)
+        {
+            for (uint8_t r = 0; r < s_runCount[page]; r++)
+            {
+                shadowSendBlock(s_runs[page][r].x0, s_runs[page][r].x1, page, page);
+            }
+        }
+    }
+    memset(s_dirty, 0, sizeof(s_dirty));
+}
@@ -0,0 +1,105 @@
+/**
+ * @file ssd1306_shadow.h Shadow framebuffer and bus statistics for 1-bit direct draw
+ */
+
+#ifndef _SSD1306_SHADOW_H_
+#define _SSD1306_SHADOW_H_
+
+#include "nano_gfx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LCD_SHADOW_BUFFER DIRECT DRAW: shadow framebuffer for 1-bit displays
+ * @{
+ * @brief Keeps direct draw functions in RAM and sends only changed bytes to the display.
+ *
+ * @details While shadow mode is enabled, all 1-bit direct draw functions (ssd1306_putPixel(),
+ *        ssd1306_fillRect(), ssd1306_printFixed(), ...) update a 1 KiB copy of GDRAM instead
+ *        of the display. Writes emulate controller addressing exactly, so every primitive
+ *        produces the same image as in direct mode. Bytes whose value changes are marked
+ *        dirty; ssd1306_flush() sends only dirty byte runs, merging nearby runs of a page
+ *        (or whole page ranges) when that costs fewer bus bytes than extra transactions.
+ *        Supports displays up to 128x64 pixels in ssd1306 compatible 1-bit mode.
+ */
+
+/** Bus traffic counters, see ssd1306_enableBusStats() */
+typedef struct
+{
+    /** Bus transactions started (ssd1306_intf.start() calls) */
+    uint32_t transactions;
+    /** Bytes sent after the device address: commands and pixel data */
+    uint32_t bytes;
+} SSD1306BusStats;
+
+/**
+ * Starts counting bus transactions and bytes sent to the display.
+ * Call once after display initialization and before ssd1306_enableShadowBuffer().
+ */
+void         ssd1306_enableBusStats(void);
+
+/**
+ * Returns bus counters accumulated since last reset.
+ * @param stats - destination for counters
+ * @param reset - non-zero to reset counters after reading
+ */
+void         ssd1306_getBusStats(SSD1306BusStats *stats, uint8_t reset);
+
+/**
+ * Redirects 1-bit direct draw functions to the shadow framebuffer.
+ * The whole buffer is cleared and marked dirty, so first ssd1306_flush() rewrites the display.
+ * @return 0 on success, -1 if display is larger than the shadow buffer
+ */
+int8_t       ssd1306_enableShadowBuffer(void);
+
+/**
+ * Flushes pending changes and returns direct draw functions to the display.
+ */
+void         ssd1306_disableShadowBuffer(void);
+
+/**
+ * Sends changed bytes of the shadow framebuffer to the display.
+ * Does nothing if shadow mode is not enabled.
+ */
+void         ssd1306_flush(void);
+
+/**
+ * Rotates pages [startPage, endPage] of the shadow framebuffer horizontally, without marking
+ * anything dirty, to follow content moved by the controller itself (ssd1306_startHorizontalScroll()).
+ * Call with no pending changes in these pages, i.e. after ssd1306_flush().
+ * @param startPage - first page to rotate
+ * @param endPage - last page to rotate
+ * @param columns - positive moves content towards last column, negative towards column 0
+ */
+void         ssd1306_scrollShadow(uint8_t startPage, uint8_t endPage, int8_t columns);
+
+/**
+ * Marks pages [startPage, endPage] of the shadow framebuffer dirty, so the next ssd1306_flush()
+ * rewrites them. Use when the display may no longer match the buffer, e.g. after a hardware
+ * scroll that was stopped late and moved content by an unknown number of columns.
+ * @param startPage - first page to resend
+ * @param endPage - last page to resend
+ */
+void         ssd1306_invalidateShadow(uint8_t startPage, uint8_t endPage);
+
+/**
+ * Moves the whole image horizontally: content already in the shadow framebuffer is moved
+ * to the new offset and marked dirty where it changes, and later draw calls add the offset
+ * to every x. Columns pushed past the last one wrap to column 0, as with the controller's
+ * own horizontal scroll, so callers keep the last columns blank. Reset to 0 by
+ * ssd1306_enableShadowBuffer(); does nothing if shadow mode is not enabled.
+ * @param columns - offset towards last column, 0 for none
+ */
+void         ssd1306_setShadowOffset(uint8_t columns);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SSD1306_SHADOW_H_
@@ -0,0 +1,205 @@
+#include "alarm_rules.h"
+#include "globals.h"
+#include "config.h"
+#include "sensor_table.h"
+#include "fixed_point.h"
+#include "oled_display.h"
+#include "http_server.h"
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "driver/soc.h"
+#include "freertos/task.h"
+
+/*
+ * Regras de alarme do nó. Limites em décimos; sensor_id NULL aplica a regra a
+ * todos os sensores. Ex.: { "temp_high", "ESP8266-002", ALARM_METRIC_TEMPERATURE, ALARM_ABOVE, 300, 10 }
+ */
+static const alarm_rule_def_t alarm_rule_defs[] = {
+    { "temp_high", NULL, ALARM_METRIC_TEMPERATURE, ALARM_ABOVE, 350, 10 },  // >= 35.0 °C, normaliza < 34.0
+    { "temp_low",  NULL, ALARM_METRIC_TEMPERATURE, ALARM_BELOW, 50,  10 },  // <= 5.0 °C, normaliza > 6.0
+    { "temp_rate", NULL, ALARM_METRIC_TEMPERATURE, ALARM_RATE,  20,  5 },   // >= 2.0 °C/min, normaliza < 1.5
+    { "hum_high",  NULL, ALARM_METRIC_HUMIDITY,    ALARM_ABOVE, 850, 30 },  // >= 85.0 %, normaliza < 82.0
+};
+
+_Static_assert(sizeof(alarm_rule_defs) / sizeof(alarm_rule_defs[0]) <= ALARM_MAX_RULES,
+               "alarm_rule_defs exceeds ALARM_MAX_RULES");
+
+// Regra compilada: 8 bytes, avaliada sem ramificar por tipo de grandeza
+typedef struct {
+    uint8_t sensor_mask;    // bit i = sensor_table[i]
+    uint8_t metric;         // alarm_metric_t
+    uint8_t kind;           // alarm_kind_t
+    uint8_t def;            // índice em alarm_rule_defs
+    int16_t set_x10;        // limite de disparo
+    int16_t clear_x10;      // limite de normalização (já com histerese)
+} alarm_rule_t;
+
+static alarm_rule_t rules[ALARM_MAX_RULES];
+static size_t rule_count = 0;
+static alarm_rule_stats_t rule_stats[ALARM_MAX_RULES];
+static uint16_t alarm_event_counter = 0;     // eventos deste boot (parte baixa do event_id)
+
+// Última amostra avaliada por sensor (base da taxa de variação)
+static int16_t prev_value[SENSOR_MAX_COUNT][2];
+static TickType_t prev_tick[SENSOR_MAX_COUNT];
+static bool has_prev[SENSOR_MAX_COUNT];
+
+void alarm_rules_init(void) {
+    rule_count = 0;
+    memset(rule_stats, 0, sizeof(rule_stats));
+    memset(has_prev, 0, sizeof(has_prev));
+    if (!ALARM_ENABLED) {
+        return;
+    }
+
+    for (size_t d = 0; d < sizeof(alarm_rule_defs) / sizeof(alarm_rule_defs[0]); d++) {
+        const alarm_rule_def_t *def = &alarm_rule_defs[d];
+        alarm_rule_t *r = &rules[rule_count];
+
+        r->sensor_mask = 0;
+        for (size_t i = 0; i < sensor_count; i++) {
+            if (def->sensor_id == NULL || strcmp(def->sensor_id, sensor_table[i].sensor_id) == 0) {
+                r->sensor_mask |= (uint8_t)(1U << i);
+            }
+        }
+        if (r->sensor_mask == 0 || def->hysteresis_x10 < 0 ||
+            strlen(def->name) >= sizeof(((alarm_event_t *)0)->rule)) {
+            ESP_LOGW(TAG, "Alarm rule '%s' ignored (unknown sensor, negative hysteresis or name too long)",
+                     def->name);
+            continue;
+        }
+
+        r->metric = (uint8_t)def->metric;
+        r->kind = (uint8_t)def->kind;
+        r->def = (uint8_t)d;
+        r->set_x10 = def->threshold_x10;
+        r->clear_x10 = (def->kind == ALARM_BELOW) ? def->threshold_x10 + def->hysteresis_x10
+                                                  : def->threshold_x10 - def->hysteresis_x10;
+        rule_count++;
+    }
+    ESP_LOGI(TAG, "Alarm rules compiled: %u active of %u defined",
+             (unsigned)rule_count, (unsigned)(sizeof(alarm_rule_defs) / sizeof(alarm_rule_defs[0])));
+}
+
+static void emit_event(size_t idx, uint8_t rule, bool raised, int16_t value, const measurement_data_t *m) {
+    alarm_event_t ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.uptime_ms = m->uptime_ms;
+    ev.boot_id = m->boot_id;
+    strncpy(ev.sensor_id, m->sensor_id, sizeof(ev.sensor_id) - 1);
+    // Nome e não índice: o evento pode ficar no SPIFFS até depois de uma atualização
+    strncpy(ev.rule, alarm_rules_name(rule), sizeof(ev.rule) - 1);
+    ev.raised = raised ? 1 : 0;
+    ev.value_x10 = value;
+    ev.threshold_x10 = raised ? rules[rule].set_x10 : rules[rule].clear_x10;
+    // O contador recomeça a cada boot: o boot_id na parte alta evita ids repetidos
+    ev.event_id = ((uint32_t)m->boot_id << 16) | ++alarm_event_counter;
+
+    ESP_LOGW(TAG, "ALARM %s %s on %s: value=" FIXED_X10_FMT " threshold=" FIXED_X10_FMT,
+             ev.rule, raised ? "raised" : "cleared", ev.sensor_id,
+             FIXED_X10_ARGS(value), FIXED_X10_ARGS(ev.threshold_x10));
+
+    if (alarm_queue == NULL || xQueueSend(alarm_queue, &ev, 0) != pdTRUE) {
+        ESP_LOGE(TAG, "Alarm queue full, event %u of %s lost", ev.event_id, ev.rule);
+    }
+    if (raised) {
+        // Display desligado por inatividade volta a mostrar a medição
+        oled_display_notify(OLED_EVT_ALARM);
+    }
+    http_events_notify(HTTP_EVT_STATUS);
+}
+
+void alarm_rules_evaluate(size_t idx, const measurement_data_t *m) {
+    if (rule_count == 0 || (m->quality & (MEAS_QUALITY_MISSING | MEAS_QUALITY_STALE))) {
+        return;
+    }
+
+    int16_t value[2] = { m->temperature_x10, m->humidity_x10 };
+    int16_t rate[2] = { 0, 0 };
+    bool has_rate = false;
+    TickType_t now = xTaskGetTickCount();
+    if (has_prev[idx]) {
+        uint32_t elapsed_ms = (now - prev_tick[idx]) * portTICK_PERIOD_MS;
+        if (elapsed_ms > 0) {
+            for (int k = 0; k < 2; k++) {
+                int32_t r = (int32_t)(((int64_t)(value[k] - prev_value[idx][k]) * 60000) / elapsed_ms);
+                rate[k] = (int16_t)(r > INT16_MAX ? INT16_MAX : (r < -INT16_MAX ? -INT16_MAX : r));
+            }
+            has_rate = true;
+        }
+    }
+
+    uint8_t bit = (uint8_t)(1U << idx);
+    for (uint8_t i = 0; i < rule_count; i++) {
+        const alarm_rule_t *r = &rules[i];
+        if (!(r->sensor_mask & bit)) {
+            continue;
+        }
+
+        uint32_t start = soc_get_ccount();
+        alarm_rule_stats_t *st = &rule_stats[i];
+        bool active = (st->active_mask & bit) != 0;
+        bool raise = false;
+        bool clear = false;
+        int16_t v = value[r->metric];
+
+        switch (r->kind) {
+        case ALARM_ABOVE:
+            raise = !active && v >= r->set_x10;
+            clear = active && v < r->clear_x10;
+            break;
+        case ALARM_BELOW:
+            raise = !active && v <= r->set_x10;
+            clear = active && v > r->clear_x10;
+            break;
+        case ALARM_RATE:
+            if (has_rate) {
+                v = (int16_t)abs(rate[r->metric]);
+                raise = !active && v >= r->set_x10;
+                clear = active && v < r->clear_x10;
+            }
+            break;
+        }
+
+        if (raise) {
+            st->active_mask |= bit;
+        } else if (clear) {
+            st->active_mask &= (uint8_t)~bit;
+        }
+        uint32_t cycles = soc_get_ccount() - start;
+
+        st->evaluations++;
+        st->cycles_last = cycles;
+        st->cycles_total += cycles;
+        if (cycles > st->cycles_max) {
+            st->cycles_max = cycles;
+        }
+
+        // Publicação fora da medição de custo: só a avaliação da regra é contabilizada
+        if (raise || clear) {
+            st->transitions++;
+            emit_event(idx, i, raise, v, m);
+        }
+    }
+
+    prev_value[idx][0] = value[0];
+    prev_value[idx][1] = value[1];
+    prev_tick[idx] = now;
+    has_prev[idx] = true;
+}
+
+size_t alarm_rules_count(void) {
+    return rule_count;
+}
+
+const char *alarm_rules_name(uint8_t rule) {
+    if (rule >= rule_count) {
+        return "unknown";
+    }
+    return alarm_rule_defs[rules[rule].def].name;
+}
+
+void alarm_rules_get_stats(uint8_t rule, alarm_rule_stats_t *out) {
+    *out = rule_stats[rule];
+}
@@ -0,0 +1,76 @@
+#ifndef ALARM_RULES_H
+#define ALARM_RULES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "types.h"
+
+typedef enum {
+    ALARM_METRIC_TEMPERATURE = 0,
+    ALARM_METRIC_HUMIDITY    = 1
+} alarm_metric_t;
+
+typedef enum {
+    ALARM_ABOVE = 0,    // dispara com valor >= limite; normaliza abaixo de limite - histerese
+    ALARM_BELOW = 1,    // dispara com valor <= limite; normaliza acima de limite + histerese
+    ALARM_RATE  = 2     // dispara com |variação| por minuto >= limite; normaliza abaixo de limite - histerese
+} alarm_kind_t;
+
+// Definição de uma regra (tabela em alarm_rules.c)
+typedef struct {
+    const char *name;           // publicado no evento
+    const char *sensor_id;      // NULL = todos os sensores de sensor_table
+    alarm_metric_t metric;
+    alarm_kind_t kind;
+    int16_t threshold_x10;      // décimos (°C, %, ou por minuto em ALARM_RATE)
+    int16_t hysteresis_x10;
+} alarm_rule_def_t;
+
+// Custo de avaliação de uma regra (ciclos de CPU)
+typedef struct {
+    uint32_t evaluations;
+    uint32_t transitions;       // eventos gerados (disparos + normalizações)
+    uint32_t cycles_last;
+    uint32_t cycles_max;
+    uint64_t cycles_total;
+    uint8_t active_mask;        // bit i = regra ativa no sensor_table[i]
+} alarm_rule_stats_t;
+
+/**
+ * @brief Compila a tabela de regras no formato compacto usado na avaliação
+ *
+ * Resolve sensor_id para máscara de sensores e pré-calcula os limites de
+ * disparo e normalização. Regras inválidas são descartadas com aviso.
+ */
+void alarm_rules_init(void);
+
+/**
+ * @brief Avalia as regras para uma amostra (chamado pela measurement_task)
+ *
+ * Amostras MISSING/STALE não são avaliadas. Transições geram alarm_event_t
+ * em alarm_queue.
+ *
+ * @param idx Índice do sensor em sensor_table
+ * @param m Amostra
+ */
+void alarm_rules_evaluate(size_t idx, const measurement_data_t *m);
+
+/**
+ * @brief Número de regras compiladas
+ */
+size_t alarm_rules_count(void);
+
+/**
+ * @brief Nome da regra compilada (para publicação do evento)
+ * @param rule Índice da regra compilada
+ */
+const char *alarm_rules_name(uint8_t rule);
+
+/**
+ * @brief Copia o custo de avaliação e o estado de uma regra compilada
+ * @param rule Índice da regra compilada
+ * @param out Destino das estatísticas
+ */
+void alarm_rules_get_stats(uint8_t rule, alarm_rule_stats_t *out);
+
+#endif // ALARM_RULES_H
@@ -1,2 +1,17 @@
 COMPONENT_SRCDIRS := .
 COMPONENT_ADD_INCLUDEDIRS := .
+
+# Painel web: main/www comprimido com gzip em www_assets.c (tools/www_pack.py), gerado
+# no diretório de build do componente como no CMakeLists.txt
+WWW_DIR := $(COMPONENT_PATH)/www
+WWW_PACK := $(COMPONENT_PATH)/../tools/www_pack.py
+COMPONENT_OBJS := $(patsubst %.c,%.o,$(notdir $(wildcard $(COMPONENT_PATH)/*.c))) www_assets.o
+COMPONENT_EXTRA_CLEAN := www_assets.c
+
+www_assets.c: $(WWW_PACK) $(wildcard $(WWW_DIR)/*)
+	$(summary) PACK $(patsubst $(PWD)/%,%,$(CURDIR))/$@
+	$(PYTHON) $(WWW_PACK) $(WWW_DIR) $@
+
+www_assets.o: www_assets.c
+	$(summary) CC $(patsubst $(PWD)/%,%,$(CURDIR))/$@
+	$(CC) $(CFLAGS) $(CPPFLAGS) $(addprefix -I ,$(COMPONENT_INCLUDES)) $(addprefix -I ,$(COMPONENT_EXTRA_INCLUDES)) -I $(COMPONENT_PATH) -c $< -o $@
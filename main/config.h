@@ -15,6 +15,11 @@
 #define MEASUREMENT_INTERVAL_MS     CONFIG_MEASUREMENT_INTERVAL_MS
 #define MAX_MEASUREMENTS_BUFFER     CONFIG_MAX_MEASUREMENTS_BUFFER
 #define FIRMWARE_VERSION            CONFIG_FIRMWARE_VERSION
+#ifdef CONFIG_MEASUREMENT_ALIGN_WALLCLOCK
+#define MEASUREMENT_ALIGN_WALLCLOCK 1
+#else
+#define MEASUREMENT_ALIGN_WALLCLOCK 0
+#endif
 
 // MQTT Batch Configuration (valores conservadores para testes)
 #define MQTT_BATCH_SIZE             3       // Reduzir batch para não sobrecarregar broker
@@ -26,6 +31,7 @@
 #define SPIFFS_BASE_PATH            "/spiffs"
 #define MEASUREMENTS_FILE           "/spiffs/measurements.dat"
 #define INDEX_FILE                  "/spiffs/ring_index.dat"
+#define ALARMS_FILE                 "/spiffs/alarms.dat"
 
 // NTP Servers (Brasil)
 #define NTP_SERVER1                 "200.160.1.186"   // a.st1.ntp.br
@@ -53,13 +59,134 @@
 
 // Quando definido, instruir a task de publish para processar imediatamente o backlog do SPIFFS
 #define PROCESS_BACKLOG_BIT         BIT3
+// Sincronização NTP concluída no callback do SNTP: a task NTP grava âncora e cache de hora no NVS
+#define NTP_PERSIST_BIT             BIT4
 
 // Definições de largura e altura do display
 #define SCREEN_WIDTH                 128
 #define SCREEN_HEIGHT                64
 
+// Framebuffer sombra do OLED: desenho na RAM, envio só dos bytes alterados por quadro
+#ifdef CONFIG_OLED_SHADOW_BUFFER
+#define OLED_SHADOW_BUFFER_ENABLED   1
+#else
+#define OLED_SHADOW_BUFFER_ENABLED   0
+#endif
+
+#ifdef CONFIG_OLED_STATIC_DRIVER
+#define OLED_STATIC_DRIVER_ENABLED   1
+#else
+#define OLED_STATIC_DRIVER_ENABLED   0
+#endif
+
+// Atraso do envio ao display após uma renderização, para agrupar renderizações próximas
+#define OLED_FLUSH_DEFER_MS          50
+
+// Repetições da medição de ciclos por dígito grande na inicialização do display
+#define OLED_GLYPH_BENCH_REPS        8
+
+// Tela de tendência: gráfico das últimas OLED_TREND_HOURS horas, alternando com a tela principal
+// (OLED_TREND_HOURS e OLED_MAIN_SCREEN_S somem do sdkconfig quando a tela está desabilitada)
+#ifdef CONFIG_OLED_TREND_SCREEN_S
+#define OLED_TREND_SCREEN_S          CONFIG_OLED_TREND_SCREEN_S
+#else
+#define OLED_TREND_SCREEN_S          0
+#endif
+#ifdef CONFIG_OLED_TREND_HOURS
+#define OLED_TREND_HOURS             CONFIG_OLED_TREND_HOURS
+#else
+#define OLED_TREND_HOURS             24
+#endif
+#ifdef CONFIG_OLED_MAIN_SCREEN_S
+#define OLED_MAIN_SCREEN_S           CONFIG_OLED_MAIN_SCREEN_S
+#else
+#define OLED_MAIN_SCREEN_S           20
+#endif
+#ifdef CONFIG_OLED_TREND_HW_SCROLL
+#define OLED_TREND_HW_SCROLL_ENABLED 1
+#else
+#define OLED_TREND_HW_SCROLL_ENABLED 0
+#endif
+// Passo do scroll horizontal do SSD1306: 25 quadros (~230 ms a ~107 Hz). O scroll é
+// desativado depois de 1,5 passo, de modo que desvios de ±30% na taxa de quadros
+// ainda resultam em exatamente uma coluna deslocada
+#define OLED_TREND_SCROLL_STOP_MS    350
+// Antes disso nem um painel 30% mais rápido dá o segundo passo (2 x 25 quadros a ~139 Hz).
+// O scroll parado depois (task de render atrasada) reenvia as páginas do gráfico
+#define OLED_TREND_SCROLL_LATE_MS    360
+
+// Anti burn-in: imagem deslocada de 0 a OLED_BURNIN_SHIFT_PX linhas pela linha inicial do SSD1306
+// e, com framebuffer sombra, o mesmo número de colunas pelo deslocamento do framebuffer
+#ifdef CONFIG_OLED_BURNIN_SHIFT_PX
+#define OLED_BURNIN_SHIFT_PX         CONFIG_OLED_BURNIN_SHIFT_PX
+#else
+#define OLED_BURNIN_SHIFT_PX         0
+#endif
+// Largura usada pelo layout: as últimas OLED_BURNIN_SHIFT_PX colunas ficam apagadas, pois o
+// deslocamento horizontal as leva para a esquerda
+#define OLED_LAYOUT_WIDTH            (SCREEN_WIDTH - OLED_BURNIN_SHIFT_PX)
+#ifdef CONFIG_OLED_BURNIN_PERIOD_S
+#define OLED_BURNIN_PERIOD_S         CONFIG_OLED_BURNIN_PERIOD_S
+#else
+#define OLED_BURNIN_PERIOD_S         300
+#endif
+
+// Energia do display: desligamento após OLED_IDLE_OFF_S sem atividade (0 = sempre ligado),
+// contraste reduzido entre OLED_DIM_START_HOUR e OLED_DIM_END_HOUR (iguais = sem redução)
+#ifdef CONFIG_OLED_IDLE_OFF_S
+#define OLED_IDLE_OFF_S              CONFIG_OLED_IDLE_OFF_S
+#else
+#define OLED_IDLE_OFF_S              0
+#endif
+// Mudança da medição, desde a última atividade, que religa o painel e reinicia a contagem
+#define OLED_WAKE_TEMP_DELTA_X10     10      // 1,0 °C
+#define OLED_WAKE_HUM_DELTA_X10      50      // 5,0 %UR
+#ifdef CONFIG_OLED_CONTRAST_DAY
+#define OLED_CONTRAST_DAY            CONFIG_OLED_CONTRAST_DAY
+#else
+#define OLED_CONTRAST_DAY            0x7F
+#endif
+#ifdef CONFIG_OLED_DIM_START_HOUR
+#define OLED_DIM_START_HOUR          CONFIG_OLED_DIM_START_HOUR
+#else
+#define OLED_DIM_START_HOUR          0
+#endif
+#ifdef CONFIG_OLED_DIM_END_HOUR
+#define OLED_DIM_END_HOUR            CONFIG_OLED_DIM_END_HOUR
+#else
+#define OLED_DIM_END_HOUR            0
+#endif
+#ifdef CONFIG_OLED_CONTRAST_NIGHT
+#define OLED_CONTRAST_NIGHT          CONFIG_OLED_CONTRAST_NIGHT
+#else
+#define OLED_CONTRAST_NIGHT          OLED_CONTRAST_DAY
+#endif
+
+// Servidor HTTP: slots de conexão (uma task cada) e tempo ocioso do keep-alive
+#ifdef CONFIG_HTTP_MAX_CONNECTIONS
+#define HTTP_MAX_CONNECTIONS         CONFIG_HTTP_MAX_CONNECTIONS
+#else
+#define HTTP_MAX_CONNECTIONS         3
+#endif
+#ifdef CONFIG_HTTP_KEEPALIVE_S
+#define HTTP_KEEPALIVE_S             CONFIG_HTTP_KEEPALIVE_S
+#else
+#define HTTP_KEEPALIVE_S             5
+#endif
+#define HTTP_ACCEPT_QUEUE_LEN        4
+// Streams /events (SSE) deixam um slot livre para as demais requisições
+#define HTTP_SSE_MAX_STREAMS         (HTTP_MAX_CONNECTIONS - 1)
+#define HTTP_SSE_PING_S              15
+#define HTTP_SEND_TIMEOUT_MS         10000
+
 // Número máximo de mensagens pendentes
 #define MAX_PENDING_MSGS            10
+// Pendente sem PUBACK após este tempo é descartado (outbox do cliente expirou)
+#define MQTT_PENDING_TIMEOUT_MS     60000
+
+// Pool de registros de medição e anel measurement_task -> mqtt_publish_task (ver measurement_pool.c)
+#define MEAS_RING_LEN               8       // potência de 2
+#define MEAS_POOL_SIZE              (MEAS_RING_LEN + MAX_PENDING_MSGS + 2)
 
 // I2C Configuration
 #define I2C_MODE_MASTER             0
@@ -68,8 +195,118 @@
 #define I2C_OLED_ADDR               0x3C
 #define I2C_NUM_0                   0
 
+// Amostragem adaptativa (ver sampling_policy.c): só atua sem conexão MQTT
+#ifdef CONFIG_ADAPTIVE_SAMPLING
+#define ADAPTIVE_SAMPLING_ENABLED   1
+#else
+#define ADAPTIVE_SAMPLING_ENABLED   0
+#endif
+// Ocupação do backlog SPIFFS (%) -> intervalo mínimo (nunca abaixo do intervalo do sensor)
+#define ADAPTIVE_FILL_PCT_1         50
+#define ADAPTIVE_INTERVAL_MS_1      10000
+#define ADAPTIVE_FILL_PCT_2         80
+#define ADAPTIVE_INTERVAL_MS_2      60000
+#define ADAPTIVE_FILL_PCT_3         95
+#define ADAPTIVE_INTERVAL_MS_3      300000
+// Valores estáveis: N amostras seguidas dentro da faixa multiplicam o intervalo
+#define ADAPTIVE_STABLE_SAMPLES     6
+#define ADAPTIVE_STABLE_TEMP_X10    2       // 0.2 °C
+#define ADAPTIVE_STABLE_HUM_X10     10      // 1.0 %
+#define ADAPTIVE_STABLE_FACTOR      3
+#define ADAPTIVE_MAX_INTERVAL_MS    900000  // 15 min
+
 // DHT22 Configuration
-#define DHT22_PIN                   4  // GPIO4
+#define DHT22_PIN                   4  // GPIO4 (sensor principal em sensor_table.c)
+
+// Espaçamento mínimo entre leituras de sensores diferentes: cada leitura DHT
+// desabilita interrupções por ~25 ms, então não enfileirar leituras em sequência
+#define SENSOR_STAGGER_MIN_MS       250
+
+// Pipeline de aquisição do sensor (ver sensor_pipeline.c)
+#ifdef CONFIG_SENSOR_READ_RETRIES
+#define SENSOR_READ_RETRIES         CONFIG_SENSOR_READ_RETRIES
+#else
+#define SENSOR_READ_RETRIES         2
+#endif
+#ifdef CONFIG_SENSOR_OVERSAMPLE
+#define SENSOR_OVERSAMPLE           CONFIG_SENSOR_OVERSAMPLE
+#else
+#define SENSOR_OVERSAMPLE           1
+#endif
+#ifdef CONFIG_SENSOR_STALE_MAX_MS
+#define SENSOR_STALE_MAX_MS         CONFIG_SENSOR_STALE_MAX_MS
+#else
+#define SENSOR_STALE_MAX_MS         60000
+#endif
+
+#define SENSOR_FILTER_NONE          0
+#define SENSOR_FILTER_MEDIAN        1
+#define SENSOR_FILTER_EMA           2
+#if defined(CONFIG_SENSOR_FILTER_NONE)
+#define SENSOR_FILTER_MODE          SENSOR_FILTER_NONE
+#elif defined(CONFIG_SENSOR_FILTER_EMA)
+#define SENSOR_FILTER_MODE          SENSOR_FILTER_EMA
+#else
+#define SENSOR_FILTER_MODE          SENSOR_FILTER_MEDIAN
+#endif
+#ifdef CONFIG_SENSOR_FILTER_WINDOW
+#define SENSOR_FILTER_WINDOW        CONFIG_SENSOR_FILTER_WINDOW
+#else
+#define SENSOR_FILTER_WINDOW        3
+#endif
+#ifdef CONFIG_SENSOR_EMA_ALPHA_PCT
+#define SENSOR_EMA_ALPHA_PCT        CONFIG_SENSOR_EMA_ALPHA_PCT
+#else
+#define SENSOR_EMA_ALPHA_PCT        30
+#endif
+
+#define DHT22_MIN_INTERVAL_MS       2000    // Datasheet: no mínimo 2 s entre leituras
+#define DHT11_MIN_INTERVAL_MS       1000
+
+// Faixa plausível e taxa máxima de variação, em décimos (rejeita picos de leitura corrompida)
+#define SENSOR_TEMP_MIN_X10         (-400)  // -40.0 °C
+#define SENSOR_TEMP_MAX_X10         800     // 80.0 °C
+#define SENSOR_HUM_MIN_X10          0
+#define SENSOR_HUM_MAX_X10          1000    // 100.0 %
+#define SENSOR_MAX_TEMP_RATE_X10    50      // 5.0 °C por minuto
+#define SENSOR_MAX_HUM_RATE_X10     200     // 20.0 % por minuto
+#define SENSOR_MIN_TEMP_STEP_X10    20      // variação sempre aceita, independente do tempo
+#define SENSOR_MIN_HUM_STEP_X10     50
+#define SENSOR_RATE_REJECT_LIMIT    3       // após N rejeições seguidas, aceitar como degrau real
+
+// Estatísticas por janela (ver window_stats.c); duração em minutos, 0 desabilita a janela
+#ifdef CONFIG_WINDOW_STATS_ENABLE
+#define WINDOW_STATS_ENABLED        1
+#define WINDOW_STATS_SHORT_MIN      CONFIG_WINDOW_STATS_SHORT_MIN
+#define WINDOW_STATS_MEDIUM_MIN     CONFIG_WINDOW_STATS_MEDIUM_MIN
+#define WINDOW_STATS_LONG_MIN       CONFIG_WINDOW_STATS_LONG_MIN
+#define MQTT_TOPIC_SUMMARY          CONFIG_MQTT_TOPIC_SUMMARY
+#else
+#define WINDOW_STATS_ENABLED        0
+#define WINDOW_STATS_SHORT_MIN      0
+#define WINDOW_STATS_MEDIUM_MIN     0
+#define WINDOW_STATS_LONG_MIN       0
+#define MQTT_TOPIC_SUMMARY          ""
+#endif
+#ifdef CONFIG_WINDOW_STATS_SUMMARY_ONLY
+#define WINDOW_STATS_SUMMARY_ONLY   1
+#else
+#define WINDOW_STATS_SUMMARY_ONLY   0
+#endif
+#define WINDOW_STATS_COUNT          3
+#define SUMMARY_QUEUE_LEN           6       // resumos aguardando a mqtt_publish_task
+
+// Regras de alarme (ver alarm_rules.c)
+#ifdef CONFIG_ALARM_ENABLE
+#define ALARM_ENABLED               1
+#define MQTT_TOPIC_ALARM            CONFIG_MQTT_TOPIC_ALARM
+#else
+#define ALARM_ENABLED               0
+#define MQTT_TOPIC_ALARM            ""
+#endif
+#define ALARM_MAX_RULES             16
+#define ALARM_QUEUE_LEN             8       // eventos aguardando a mqtt_publish_task
+#define ALARM_BACKLOG_LEN           16      // eventos guardados sem MQTT (o mais antigo é descartado)
 
 // MQTT Keep-alive Configuration
 #define MQTT_KEEPALIVE_SEC          20      // Keep-alive otimizado para estabilidade
@@ -82,6 +319,10 @@
 #define NTP_RESYNC_THRESHOLD        86400   // Forçar resync após 24h sem sincronização
 #define NTP_CACHE_MAX_AGE           7200    // Cache máximo válido: 2 horas (evitar data antiga)
 
+// Time Base Configuration (ver timebase.h)
+#define TIMEBASE_ANCHOR_SLOTS       8       // Âncoras de boot mantidas no NVS (boots recentes resolvíveis)
+#define TIMEBASE_ANCHOR_WAIT_MS     600000  // Segurar o backlog até 10 min de uptime esperando o NTP
+
 // Timezone Configuration
 #define USE_LOCAL_TIMESTAMP         0       // 0=UTC (recomendado), 1=Local Time (GMT-3)
                                             // UTC é padrão para sistemas distribuídos IoT
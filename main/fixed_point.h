@@ -0,0 +1,40 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Temperatura e umidade circulam como int16 em décimos (x10), exatamente como
+ * o driver DHT entrega: 253 = 25.3 °C, -15 = -1.5 °C, 625 = 62.5 %.
+ * Nenhum caminho de medição usa float nem printf com %f.
+ */
+
+// Valor ausente (amostra MEAS_QUALITY_MISSING)
+#define MEAS_VALUE_INVALID          INT16_MIN
+
+// Uso em printf: printf("T=" FIXED_X10_FMT "°C", FIXED_X10_ARGS(t))
+#define FIXED_X10_FMT               "%s%d.%d"
+#define FIXED_X10_ARGS(v)           ((v) < 0 ? "-" : ""), (int)(((v) < 0 ? -(v) : (v)) / 10), (int)(((v) < 0 ? -(v) : (v)) % 10)
+
+// Arredonda um valor Q8 para inteiro (simétrico para negativos)
+static inline int16_t fixed_q8_round(int32_t v) {
+    return (int16_t)(v >= 0 ? (v + 128) >> 8 : -((-v + 128) >> 8));
+}
+
+/**
+ * @brief Formata um valor em décimos como texto decimal ("25.3", "-0.5")
+ * @param buf Buffer de destino
+ * @param len Tamanho do buffer
+ * @param value Valor em décimos
+ * @param invalid Texto usado quando value == MEAS_VALUE_INVALID
+ * @return Número de caracteres escritos (como snprintf)
+ */
+static inline int fixed_x10_format(char *buf, size_t len, int16_t value, const char *invalid) {
+    if (value == MEAS_VALUE_INVALID) {
+        return snprintf(buf, len, "%s", invalid);
+    }
+    return snprintf(buf, len, FIXED_X10_FMT, FIXED_X10_ARGS(value));
+}
+
+#endif // FIXED_POINT_H
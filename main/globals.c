@@ -1,4 +1,5 @@
 #include "globals.h"
+#include "fixed_point.h"
 #include <stdatomic.h>
 
 // Definição das variáveis globais
@@ -6,13 +7,14 @@
 const char *TAG = "DATALOGGER";
 
 // Variáveis globais para última medição
-float g_last_temperature = -99.0f;
-float g_last_humidity = -99.0f;
+int16_t g_last_temperature_x10 = MEAS_VALUE_INVALID;
+int16_t g_last_humidity_x10 = MEAS_VALUE_INVALID;
 
 // Event Groups e Queues
 EventGroupHandle_t wifi_event_group = NULL;
 EventGroupHandle_t system_event_group = NULL;
-QueueHandle_t measurement_queue = NULL;
+QueueHandle_t summary_queue = NULL;
+QueueHandle_t alarm_queue = NULL;
 
 // Handles
 esp_mqtt_client_handle_t mqtt_client = NULL;
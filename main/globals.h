@@ -14,14 +14,15 @@
 
 extern const char *TAG;
 
-// Variáveis globais para última medição
-extern float g_last_temperature;
-extern float g_last_humidity;
+// Variáveis globais para última medição (décimos; MEAS_VALUE_INVALID até a primeira leitura)
+extern int16_t g_last_temperature_x10;
+extern int16_t g_last_humidity_x10;
 
 // Event Groups e Queues
 extern EventGroupHandle_t wifi_event_group;
 extern EventGroupHandle_t system_event_group;
-extern QueueHandle_t measurement_queue;
+extern QueueHandle_t summary_queue;
+extern QueueHandle_t alarm_queue;
 
 // Handles
 extern esp_mqtt_client_handle_t mqtt_client;
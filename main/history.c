@@ -0,0 +1,122 @@
+#include "history.h"
+#include "fixed_point.h"
+#include "timebase.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HISTORY_CSV_HEADER  "timestamp,sensor_id,temperature,humidity,quality,interval_s,measurement_id\n"
+
+typedef struct {
+    uint32_t from;
+    uint32_t to;
+    bool filtered;      // from ou to presente: registros sem timestamp ficam de fora
+    bool csv;
+} history_query_t;
+
+// Timestamp opcional da query; false se presente e inválido
+static bool parse_time(const http_request_t *req, const char *name, uint32_t *value, bool *present) {
+    char buf[16];
+    if (!http_query_param(req, name, buf, sizeof(buf))) {
+        return true;
+    }
+    char *end;
+    errno = 0;
+    unsigned long v = strtoul(buf, &end, 10);
+    if (end == buf || *end != '\0' || buf[0] == '-' || errno != 0 || v > UINT32_MAX) {
+        return false;
+    }
+    *value = (uint32_t)v;
+    *present = true;
+    return true;
+}
+
+static bool parse_query(const http_request_t *req, history_query_t *q) {
+    char format[8];
+    q->from = 0;
+    q->to = UINT32_MAX;
+    q->filtered = false;
+    q->csv = false;
+    if (http_query_param(req, "format", format, sizeof(format))) {
+        if (strcmp(format, "csv") == 0) {
+            q->csv = true;
+        } else if (strcmp(format, "json") != 0) {
+            return false;
+        }
+    }
+    return parse_time(req, "from", &q->from, &q->filtered) && parse_time(req, "to", &q->to, &q->filtered) &&
+           q->from <= q->to;
+}
+
+// Uma linha (CSV) ou um objeto (JSON, sem a vírgula); 0 se o registro fica de fora
+static int format_record(char *buf, size_t len, const measurement_data_t *m, const history_query_t *q) {
+    uint32_t ts;
+    bool has_ts = timebase_to_timestamp(m->boot_id, m->uptime_ms, &ts);
+    if (q->filtered && (!has_ts || ts < q->from || ts > q->to)) {
+        return 0;
+    }
+
+    const char *none = q->csv ? "" : "null";
+    char ts_str[12];
+    char temp_str[12];
+    char hum_str[12];
+    if (has_ts) {
+        snprintf(ts_str, sizeof(ts_str), "%u", ts);
+    } else {
+        snprintf(ts_str, sizeof(ts_str), "%s", none);
+    }
+    if (m->quality & MEAS_QUALITY_MISSING) {
+        snprintf(temp_str, sizeof(temp_str), "%s", none);
+        snprintf(hum_str, sizeof(hum_str), "%s", none);
+    } else {
+        fixed_x10_format(temp_str, sizeof(temp_str), m->temperature_x10, none);
+        fixed_x10_format(hum_str, sizeof(hum_str), m->humidity_x10, none);
+    }
+
+    if (q->csv) {
+        return snprintf(buf, len, "%s,%.16s,%s,%s,%u,%u,%u\n", ts_str, m->sensor_id, temp_str, hum_str,
+                        m->quality, m->interval_s, m->measurement_id);
+    }
+    return snprintf(buf, len,
+                    "{\"timestamp\":%s,\"sensor_id\":\"%.16s\",\"temperature\":%s,\"humidity\":%s,"
+                    "\"quality\":%u,\"interval_s\":%u,\"measurement_id\":%u}",
+                    ts_str, m->sensor_id, temp_str, hum_str, m->quality, m->interval_s, m->measurement_id);
+}
+
+void history_handle(http_conn_t *c, const http_request_t *req, const history_source_t *src) {
+    history_query_t q;
+    if (!parse_query(req, &q)) {
+        http_send_error(c, 400);
+        return;
+    }
+
+    // Registros gravados durante a resposta ficam para a próxima requisição
+    uint32_t pos, end;
+    src->range(&pos, &end);
+
+    http_begin(c, 200, q.csv ? "text/csv" : "application/json", "Cache-Control: no-store\r\n",
+               HTTP_LENGTH_UNKNOWN);
+    http_write_str(c, q.csv ? HISTORY_CSV_HEADER : "[");
+
+    measurement_data_t batch[HISTORY_READ_BATCH];
+    char line[192];
+    bool first = true;
+    size_t n;
+    while (!c->failed && (n = src->read(&pos, end, batch, HISTORY_READ_BATCH)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            int len = format_record(line + 1, sizeof(line) - 1, &batch[i], &q);
+            if (len <= 0) {
+                continue;
+            }
+            // Vírgula entre objetos JSON escrita junto com o objeto
+            bool comma = !q.csv && !first;
+            line[0] = ',';
+            http_write(c, comma ? line : line + 1, (size_t)len + comma);
+            first = false;
+        }
+    }
+    if (!q.csv) {
+        http_write_str(c, "]\n");
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "http_conn.h"
+#include "types.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * GET /history: registros guardados no SPIFFS, em CSV ou JSON, filtrados pelo
+ * timestamp publicado. A resposta sai em chunked pelo buffer do slot HTTP e os
+ * registros são lidos em lotes de HISTORY_READ_BATCH, então a memória usada não
+ * depende do tamanho do intervalo. Sem lwIP nem FreeRTOS: os registros chegam por
+ * history_source_t (SPIFFS no firmware, arquivo comum em tools/http_load).
+ */
+
+#define HISTORY_READ_BATCH  8       // registros por leitura (HISTORY_READ_BATCH × sizeof(measurement_data_t) na pilha do slot)
+
+// Origem dos registros, em ordem de escrita
+typedef struct {
+    // Posições dos registros guardados: [*first, *end)
+    void (*range)(uint32_t *first, uint32_t *end);
+    // Lê até max registros a partir de *pos, antes de end, e avança *pos; 0 no fim ou em erro
+    size_t (*read)(uint32_t *pos, uint32_t end, measurement_data_t *buf, size_t max);
+} history_source_t;
+
+/**
+ * @brief Atende GET /history?from=&to=&format=csv|json
+ *
+ * from e to são timestamps como os publicados (s, inclusivos); sem eles, todos os
+ * registros, inclusive os de boots sem âncora (timestamp null). format padrão json.
+ * Parâmetros inválidos respondem 400.
+ */
+void history_handle(http_conn_t *c, const http_request_t *req, const history_source_t *src);
+
+#endif // HISTORY_H
@@ -0,0 +1,408 @@
+#include "http_conn.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define CHUNK_HEAD_LEN  6       // "%04x\r\n"
+#define CHUNK_TAIL_LEN  7       // "\r\n" do chunk + "0\r\n\r\n" do último
+
+static const char *status_text(int status) {
+    switch (status) {
+    case 200:
+        return "OK";
+    case 304:
+        return "Not Modified";
+    case 400:
+        return "Bad Request";
+    case 404:
+        return "Not Found";
+    case 405:
+        return "Method Not Allowed";
+    case 408:
+        return "Request Timeout";
+    case 431:
+        return "Request Header Fields Too Large";
+    case 501:
+        return "Not Implemented";
+    case 503:
+        return "Service Unavailable";
+    default:
+        return "";
+    }
+}
+
+static void tx_failed(http_conn_t *c) {
+    c->failed = true;
+    c->keep_alive = false;
+    c->errors_total++;
+}
+
+static void tx_send(http_conn_t *c, const void *data, size_t len) {
+    if (!c->failed && len > 0 && !c->io.send(c->io.ctx, data, len)) {
+        tx_failed(c);
+    }
+}
+
+// Fecha o chunk aberto (tamanho na reserva do início) e envia o buffer
+static void tx_flush(http_conn_t *c, bool last) {
+    if (c->chunked) {
+        size_t n = c->tx_len - c->chunk_start - CHUNK_HEAD_LEN;
+        if (n > 0) {
+            char head[CHUNK_HEAD_LEN + 1];
+            snprintf(head, sizeof(head), "%04x\r\n", (unsigned)n);
+            memcpy(c->tx + c->chunk_start, head, CHUNK_HEAD_LEN);
+            memcpy(c->tx + c->tx_len, "\r\n", 2);
+            c->tx_len += 2;
+        } else {
+            // Chunk vazio não é enviado: "0\r\n" encerraria o corpo
+            c->tx_len = c->chunk_start;
+        }
+        if (last) {
+            memcpy(c->tx + c->tx_len, "0\r\n\r\n", 5);
+            c->tx_len += 5;
+        }
+    }
+    tx_send(c, c->tx, c->tx_len);
+    c->tx_len = 0;
+    c->chunk_start = 0;
+    if (c->chunked && !last) {
+        c->tx_len = CHUNK_HEAD_LEN;
+    }
+}
+
+void http_begin(http_conn_t *c, int status, const char *content_type, const char *headers, size_t length) {
+    if (status == 304) {
+        length = 0;
+    }
+    // Sem tamanho, HTTP/1.0 recebe o corpo cru e o fim é o fechamento da conexão
+    c->chunked = length == HTTP_LENGTH_UNKNOWN && c->keep_alive;
+    if (length == HTTP_LENGTH_UNKNOWN && !c->chunked) {
+        c->keep_alive = false;
+    }
+    c->body_left = c->chunked ? 0 : length;
+    c->responding = true;
+
+    int n = snprintf((char *)c->tx, sizeof(c->tx), "HTTP/1.1 %d %s\r\nContent-Type: %s\r\n%s", status,
+                     status_text(status), content_type, headers != NULL ? headers : "");
+    if (n < 0 || (size_t)n >= sizeof(c->tx) - 96) {
+        n = snprintf((char *)c->tx, sizeof(c->tx), "HTTP/1.1 %d %s\r\nContent-Type: %s\r\n", status,
+                     status_text(status), content_type);
+    }
+    size_t len = (size_t)n;
+    if (c->chunked) {
+        len += (size_t)snprintf((char *)c->tx + len, sizeof(c->tx) - len, "Transfer-Encoding: chunked\r\n");
+    } else if (length != HTTP_LENGTH_UNKNOWN && status != 304) {
+        len += (size_t)snprintf((char *)c->tx + len, sizeof(c->tx) - len, "Content-Length: %u\r\n",
+                                (unsigned)length);
+    }
+    len += (size_t)snprintf((char *)c->tx + len, sizeof(c->tx) - len, "Connection: %s\r\n\r\n",
+                            c->keep_alive ? "keep-alive" : "close");
+    c->tx_len = len;
+    c->chunk_start = len;
+    if (c->chunked) {
+        c->tx_len += CHUNK_HEAD_LEN;
+    }
+}
+
+void http_write(http_conn_t *c, const void *data, size_t len) {
+    const uint8_t *p = data;
+    if (!c->chunked) {
+        len = len < c->body_left ? len : c->body_left;
+        c->body_left -= len;
+        // Bloco maior que o buffer vai direto, sem cópia
+        if (len >= sizeof(c->tx) - c->tx_len) {
+            tx_send(c, c->tx, c->tx_len);
+            c->tx_len = 0;
+            tx_send(c, p, len);
+            return;
+        }
+    }
+    while (len > 0) {
+        size_t room = sizeof(c->tx) - c->tx_len - (c->chunked ? CHUNK_TAIL_LEN : 0);
+        if (room == 0) {
+            tx_flush(c, false);
+            continue;
+        }
+        size_t n = len < room ? len : room;
+        memcpy(c->tx + c->tx_len, p, n);
+        c->tx_len += n;
+        p += n;
+        len -= n;
+    }
+}
+
+void http_write_str(http_conn_t *c, const char *s) {
+    http_write(c, s, strlen(s));
+}
+
+void http_write_static(http_conn_t *c, const void *data, size_t len) {
+    if (c->chunked || c->io.send_static == NULL) {
+        http_write(c, data, len);
+        return;
+    }
+    len = len < c->body_left ? len : c->body_left;
+    c->body_left -= len;
+    tx_send(c, c->tx, c->tx_len);
+    c->tx_len = 0;
+    if (!c->failed && len > 0 && !c->io.send_static(c->io.ctx, data, len)) {
+        tx_failed(c);
+    }
+}
+
+void http_flush(http_conn_t *c) {
+    if (c->responding) {
+        tx_flush(c, false);
+    }
+}
+
+void http_end(http_conn_t *c) {
+    if (!c->responding) {
+        return;
+    }
+    tx_flush(c, true);
+    // Corpo menor que o Content-Length anunciado deixaria o cliente esperando
+    if (c->body_left > 0) {
+        c->keep_alive = false;
+        c->failed = true;
+    }
+    c->responding = false;
+    c->chunked = false;
+}
+
+void http_send_error(http_conn_t *c, int status) {
+    char body[48];
+    int n = snprintf(body, sizeof(body), "%d %s\n", status, status_text(status));
+    c->errors_total++;
+    http_begin(c, status, "text/plain", status == 405 ? "Allow: GET\r\n" : NULL, (size_t)n);
+    http_write(c, body, (size_t)n);
+    http_end(c);
+}
+
+const char *http_request_header(const http_request_t *req, const char *name) {
+    size_t name_len = strlen(name);
+    for (const char *line = req->headers; *line != '\0'; line += strlen(line) + 1) {
+        if (strncasecmp(line, name, name_len) == 0 && line[name_len] == ':') {
+            const char *value = line + name_len + 1;
+            while (*value == ' ' || *value == '\t') {
+                value++;
+            }
+            return value;
+        }
+    }
+    return NULL;
+}
+
+bool http_query_param(const http_request_t *req, const char *name, char *buf, size_t len) {
+    size_t name_len = strlen(name);
+    const char *p = req->query;
+    while (*p != '\0') {
+        size_t field = strcspn(p, "&");
+        if (strncmp(p, name, name_len) == 0 && (p[name_len] == '=' || field == name_len)) {
+            size_t skip = field > name_len ? name_len + 1 : name_len;
+            size_t n = field - skip;
+            if (n >= len) {
+                n = len - 1;
+            }
+            memcpy(buf, p + skip, n);
+            buf[n] = '\0';
+            return true;
+        }
+        p += field;
+        if (*p == '&') {
+            p++;
+        }
+    }
+    return false;
+}
+
+// Procura o fim do cabeçalho; devolve o tamanho com o "\r\n\r\n" ou 0 se ainda incompleto
+static size_t header_end(const char *buf, size_t len) {
+    for (size_t i = 3; i < len; i++) {
+        if (buf[i] == '\n' && buf[i - 1] == '\r' && buf[i - 2] == '\n' && buf[i - 3] == '\r') {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// Lê até ter um cabeçalho completo em rx; devolve seu tamanho, 0 se a conexão deve fechar
+static size_t read_header(http_conn_t *c, uint32_t idle_ms) {
+    size_t end;
+    uint32_t idle_waited = 0;
+    while ((end = header_end(c->rx, c->rx_len)) == 0) {
+        if (c->rx_len == sizeof(c->rx)) {
+            c->keep_alive = false;
+            http_send_error(c, 431);
+            return 0;
+        }
+        uint32_t timeout = c->rx_len == 0 ? idle_ms : HTTP_REQUEST_TIMEOUT_MS;
+        // Keep-alive ocioso: espera em fatias e cede o slot se houver conexão na fila
+        bool idle = c->rx_len == 0 && c->requests > 0 && c->io.waiting != NULL;
+        if (idle && timeout > HTTP_IDLE_POLL_MS) {
+            timeout = HTTP_IDLE_POLL_MS;
+        }
+        int n = c->io.recv(c->io.ctx, c->rx + c->rx_len, sizeof(c->rx) - c->rx_len, timeout);
+        if (n == 0 && idle) {
+            idle_waited += timeout;
+            if (idle_waited < idle_ms && !c->io.waiting(c->io.ctx)) {
+                continue;
+            }
+            return 0;
+        }
+        if (n <= 0) {
+            if (n == 0 && c->rx_len > 0) {
+                c->keep_alive = false;
+                http_send_error(c, 408);
+            }
+            return 0;
+        }
+        c->rx_len += (size_t)n;
+    }
+    return end;
+}
+
+// Quebra o cabeçalho em rx no próprio buffer: linha de requisição e uma string por cabeçalho
+static bool parse_header(http_conn_t *c, size_t end, http_request_t *req) {
+    char *p = c->rx;
+    for (size_t i = 0; i + 1 < end; i++) {
+        if (p[i] == '\r' && p[i + 1] == '\n') {
+            p[i] = '\0';
+            p[i + 1] = '\0';
+        }
+    }
+
+    char *target = strchr(p, ' ');
+    char *version = target != NULL ? strchr(target + 1, ' ') : NULL;
+    if (version == NULL) {
+        return false;
+    }
+    *target++ = '\0';
+    *version++ = '\0';
+    if (*target != '/' || strncmp(version, "HTTP/1.", 7) != 0) {
+        return false;
+    }
+    req->method = p;
+    req->path = target;
+    char *query = strchr(target, '?');
+    if (query != NULL) {
+        *query++ = '\0';
+    }
+    req->query = query != NULL ? query : "";
+    req->http11 = version[7] != '0';
+
+    // Cabeçalhos começam depois do "\0\0" da linha de requisição; os "\0\0" intermediários
+    // viram "\0" seguido de linha vazia, então as linhas são unidas pulando o segundo zero
+    char *line = version + strlen(version) + 2;
+    char *out = line;
+    req->headers = line;
+    while (*line != '\0') {
+        size_t len = strlen(line);
+        memmove(out, line, len + 1);
+        out += len + 1;
+        line += len + 2;
+    }
+    *out = '\0';
+
+    const char *conn = http_request_header(req, "Connection");
+    if (req->http11) {
+        req->keep_alive = conn == NULL || strcasecmp(conn, "close") != 0;
+    } else {
+        req->keep_alive = false;
+    }
+    return true;
+}
+
+// Descarta o corpo da requisição (nenhuma rota usa corpo); false se a conexão deve fechar
+static bool discard_body(http_conn_t *c, const http_request_t *req, size_t *consumed) {
+    const char *length = http_request_header(req, "Content-Length");
+    if (http_request_header(req, "Transfer-Encoding") != NULL) {
+        c->keep_alive = false;
+        http_send_error(c, 501);
+        return false;
+    }
+    if (length == NULL) {
+        return true;
+    }
+    unsigned long left = strtoul(length, NULL, 10);
+    size_t in_buf = c->rx_len - *consumed;
+    size_t n = left < in_buf ? left : in_buf;
+    *consumed += n;
+    left -= n;
+    while (left > 0) {
+        char scratch[64];
+        int r = c->io.recv(c->io.ctx, scratch, left < sizeof(scratch) ? left : sizeof(scratch),
+                           HTTP_REQUEST_TIMEOUT_MS);
+        if (r <= 0) {
+            return false;
+        }
+        left -= (unsigned long)r;
+    }
+    return true;
+}
+
+static bool path_matches(const char *route, const char *path) {
+    size_t len = strlen(route);
+    if (len > 0 && route[len - 1] == '*') {
+        return strncmp(route, path, len - 1) == 0;
+    }
+    return strcmp(route, path) == 0;
+}
+
+static void dispatch(http_conn_t *c, const http_request_t *req, const http_route_t *routes, size_t route_count) {
+    bool path_found = false;
+    for (size_t i = 0; i < route_count; i++) {
+        if (!path_matches(routes[i].path, req->path)) {
+            continue;
+        }
+        path_found = true;
+        if (strcmp(routes[i].method, req->method) == 0) {
+            routes[i].handler(c, req);
+            http_end(c);
+            return;
+        }
+    }
+    http_send_error(c, path_found ? 405 : 404);
+}
+
+void http_conn_serve(http_conn_t *c, const http_io_t *io, const http_route_t *routes, size_t route_count,
+                     uint32_t idle_ms) {
+    c->io = *io;
+    c->rx_len = 0;
+    c->tx_len = 0;
+    c->responding = false;
+    c->chunked = false;
+    c->failed = false;
+    c->requests = 0;
+    c->connections_total++;
+
+    do {
+        c->keep_alive = true;
+        size_t end = read_header(c, idle_ms);
+        if (end == 0) {
+            break;
+        }
+        http_request_t req;
+        if (!parse_header(c, end, &req)) {
+            c->keep_alive = false;
+            http_send_error(c, 400);
+            break;
+        }
+        size_t consumed = end;
+        if (!discard_body(c, &req, &consumed)) {
+            break;
+        }
+        // Conexões esperando slot: uma conexão que nunca fica ociosa cede o slot depois de
+        // HTTP_KEEPALIVE_FAIR_REQUESTS requisições (a ociosa cede em read_header)
+        c->keep_alive = req.keep_alive && idle_ms > 0 &&
+                        !(c->requests + 1 >= HTTP_KEEPALIVE_FAIR_REQUESTS && c->io.waiting != NULL &&
+                          c->io.waiting(c->io.ctx));
+        c->requests++;
+        c->requests_total++;
+        dispatch(c, &req, routes, route_count);
+
+        // Requisição seguinte (pipelining) que já chegou junto
+        c->rx_len -= consumed;
+        memmove(c->rx, c->rx + consumed, c->rx_len);
+    } while (c->keep_alive && !c->failed);
+}
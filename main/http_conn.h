@@ -0,0 +1,139 @@
+#ifndef HTTP_CONN_H
+#define HTTP_CONN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Núcleo HTTP/1.1 de uma conexão, sem lwIP nem FreeRTOS: parser de requisições
+ * (o cabeçalho pode chegar em vários netbufs), tabela de rotas estática e escrita
+ * de respostas por um buffer do tamanho de alguns segmentos TCP, com chunked
+ * encoding quando o tamanho do corpo não é conhecido. O transporte entra por
+ * http_io_t: netconn no firmware (http_server.c), sockets POSIX no teste de carga
+ * de host (tools/http_load).
+ */
+
+#define HTTP_RX_BUF_LEN         512     // linha de requisição + cabeçalhos (+ início da próxima)
+#define HTTP_TX_BUF_LEN         1024    // cabeçalho da resposta + um chunk
+#define HTTP_REQUEST_TIMEOUT_MS 5000    // requisição começada e não terminada
+// Com conexões esperando slot (http_io_t.waiting): a conexão ociosa por HTTP_IDLE_POLL_MS
+// cede o slot, e a ocupada cede depois de HTTP_KEEPALIVE_FAIR_REQUESTS requisições
+#define HTTP_IDLE_POLL_MS       100
+#define HTTP_KEEPALIVE_FAIR_REQUESTS 32
+#define HTTP_LENGTH_UNKNOWN     SIZE_MAX
+
+// Transporte de uma conexão
+typedef struct {
+    void *ctx;
+    // Lê até len bytes: > 0 bytes lidos, 0 tempo esgotado, < 0 conexão fechada ou erro
+    int (*recv)(void *ctx, char *buf, size_t len, uint32_t timeout_ms);
+    // Envia len bytes; false se a conexão caiu
+    bool (*send)(void *ctx, const void *data, size_t len);
+    // Opcional: envia dados que nunca mudam nem saem da memória (assets em flash) sem
+    // copiá-los para o buffer de envio; ausente, http_write_static() usa send
+    bool (*send_static)(void *ctx, const void *data, size_t len);
+    // Opcional: há conexões esperando slot, então a atual cede o slot quando ficar ociosa
+    bool (*waiting)(void *ctx);
+} http_io_t;
+
+typedef struct {
+    const char *method;
+    const char *path;       // sem a query string
+    const char *query;      // após '?', "" se não houver
+    const char *headers;    // linhas "Nome: valor" terminadas em '\0', a última vazia
+    bool http11;
+    bool keep_alive;        // a resposta mantém a conexão aberta
+} http_request_t;
+
+typedef struct http_conn http_conn_t;
+
+typedef void (*http_handler_t)(http_conn_t *c, const http_request_t *req);
+
+typedef struct {
+    const char *method;
+    const char *path;       // terminado em '*': prefixo
+    http_handler_t handler;
+} http_route_t;
+
+struct http_conn {
+    http_io_t io;
+    char rx[HTTP_RX_BUF_LEN];
+    size_t rx_len;          // bytes válidos em rx: requisição atual e o que veio depois dela
+    uint8_t tx[HTTP_TX_BUF_LEN];
+    size_t tx_len;
+    size_t chunk_start;     // início do chunk aberto em tx (reserva do tamanho)
+    size_t body_left;       // corpo de tamanho conhecido ainda não escrito
+    bool responding;        // cabeçalho da resposta já escrito, falta http_end()
+    bool chunked;
+    bool keep_alive;
+    bool failed;            // envio falhou: o resto da resposta é descartado
+    // Contadores da conexão atual e acumulados do slot
+    uint32_t requests;
+    uint32_t requests_total;
+    uint32_t connections_total;
+    uint32_t errors_total;  // respostas 4xx/5xx geradas pelo núcleo e envios que falharam
+};
+
+/**
+ * @brief Atende requisições na conexão até ela fechar, ficar ociosa ou pedir Connection: close
+ * @param io Transporte da conexão
+ * @param routes Tabela de rotas (método exato; path exato ou prefixo terminado em '*'), na ordem de busca
+ * @param idle_ms Tempo máximo de espera pela próxima requisição em keep-alive
+ */
+void http_conn_serve(http_conn_t *c, const http_io_t *io, const http_route_t *routes, size_t route_count,
+                     uint32_t idle_ms);
+
+/**
+ * @brief Valor de um cabeçalho da requisição (nome sem diferença de maiúsculas), NULL se ausente
+ */
+const char *http_request_header(const http_request_t *req, const char *name);
+
+/**
+ * @brief Copia o valor de um parâmetro da query string (sem decodificar %XX)
+ *
+ * Valor maior que buf é truncado; "nome" sem '=' vale "".
+ * @return false se o parâmetro não existe
+ */
+bool http_query_param(const http_request_t *req, const char *name, char *buf, size_t len);
+
+/**
+ * @brief Escreve a linha de status e os cabeçalhos da resposta
+ * @param content_type Tipo do corpo
+ * @param headers Cabeçalhos extras, cada um terminado em "\r\n" (pode ser NULL)
+ * @param length Tamanho do corpo, ou HTTP_LENGTH_UNKNOWN (chunked em HTTP/1.1, fecha a conexão em 1.0);
+ *               ignorado em 304, que não tem corpo
+ */
+void http_begin(http_conn_t *c, int status, const char *content_type, const char *headers, size_t length);
+
+/**
+ * @brief Acrescenta bytes ao corpo; o envio acontece quando o buffer enche e em http_end()
+ */
+void http_write(http_conn_t *c, const void *data, size_t len);
+
+void http_write_str(http_conn_t *c, const char *s);
+
+/**
+ * @brief Acrescenta ao corpo dados constantes, que continuam válidos depois do envio
+ *
+ * Com tamanho conhecido o cabeçalho pendente sai primeiro e os dados vão por
+ * io.send_static, sem passar pelo buffer; em chunked é o mesmo que http_write().
+ */
+void http_write_static(http_conn_t *c, const void *data, size_t len);
+
+/**
+ * @brief Envia já o que estiver no buffer (um chunk), sem terminar a resposta; para streams
+ */
+void http_flush(http_conn_t *c);
+
+/**
+ * @brief Termina a resposta (último chunk) e envia o que estiver no buffer
+ */
+void http_end(http_conn_t *c);
+
+/**
+ * @brief Resposta curta de erro com corpo em texto
+ */
+void http_send_error(http_conn_t *c, int status);
+
+#endif // HTTP_CONN_H
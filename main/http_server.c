@@ -1,24 +1,533 @@
 #include "http_server.h"
 #include "globals.h"
 #include "config.h"
+#include "measurement.h"
+#include "sensor_table.h"
+#include "fixed_point.h"
+#include "window_stats.h"
+#include "alarm_rules.h"
+#include "spiffs_manager.h"
+#include "measurement_pool.h"
+#include "sampling_policy.h"
+#include "timebase.h"
+#include "oled_display.h"
+#include "http_conn.h"
+#include "www.h"
+#include "history.h"
 #include <stdio.h>
 #include <string.h>
-#include <time.h>
 #include "esp_log.h"
 #include "lwip/api.h"
+#include "lwip/tcp.h"
+#include "lwip/priv/tcpip_priv.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+// Slot de conexão: uma task por slot atende uma conexão por vez
+typedef struct {
+    http_conn_t conn;
+    struct netconn *nc;
+    struct netbuf *pending;     // netbuf recebido e ainda não consumido por inteiro
+    u16_t offset;
+    bool busy;
+    uint32_t stack_free;        // menor folga da pilha da task do slot (uxTaskGetStackHighWaterMark)
+} http_slot_t;
 
-// Verifica se o request começa com o path especificado
-static bool request_starts_with(const char *buf, const char *path) {
-    // Formato: "GET /path HTTP/1.1"
-    char expected[64];
-    snprintf(expected, sizeof(expected), "GET %s ", path);
-    return strncmp(buf, expected, strlen(expected)) == 0;
+static http_slot_t http_slots[HTTP_MAX_CONNECTIONS];
+static QueueHandle_t accept_queue = NULL;
+
+// Sem LWIP_SO_RCVTIMEO o netconn_recv não tem timeout: não há espera ociosa de keep-alive
+// (fecha após cada resposta) e o stream /events só percebe a aba fechada quando a escrita falha
+#if LWIP_SO_RCVTIMEO
+#define HTTP_IDLE_MS    (HTTP_KEEPALIVE_S * 1000U)
+#else
+#define HTTP_IDLE_MS    0
+#endif
+
+// Slots com stream /events aberto: task a notificar em http_events_notify()
+static TaskHandle_t sse_tasks[HTTP_MAX_CONNECTIONS];
+static int sse_streams = 0;
+static uint32_t sse_events_sent = 0;
+
+// Formata um valor de medição; amostras "missing" viram null (JSON) ou "--" (HTML)
+static void format_value(char *buf, size_t len, const measurement_data_t *m, int16_t value_x10, bool json) {
+    const char *missing = json ? "null" : "--";
+    if (m->quality & MEAS_QUALITY_MISSING) {
+        snprintf(buf, len, "%s", missing);
+    } else {
+        fixed_x10_format(buf, len, value_x10, missing);
+    }
+}
+
+// Timestamp da medição resolvido pela âncora do boot ("null" se ainda não há âncora)
+static void format_timestamp(char *buf, size_t len, const measurement_data_t *m) {
+    uint32_t ts;
+    if (timebase_to_timestamp(m->boot_id, m->uptime_ms, &ts)) {
+        snprintf(buf, len, "%u", ts);
+    } else {
+        snprintf(buf, len, "null");
+    }
+}
+
+// JSON da última medição do sensor principal (GET /data e evento "measurement")
+static void format_data_json(char *json, size_t len) {
+    char temp_str[12], hum_str[12];
+    format_value(temp_str, sizeof(temp_str), &last_measurement, last_measurement.temperature_x10, true);
+    format_value(hum_str, sizeof(hum_str), &last_measurement, last_measurement.humidity_x10, true);
+
+    char time_json[112];
+    timebase_format_json(time_json, sizeof(time_json), last_measurement.boot_id, last_measurement.uptime_ms);
+
+    snprintf(json, len,
+             "{\"sensor_id\":\"%s\",%s,\"temperature\":%s,\"humidity\":%s,\"quality\":%u}",
+             last_measurement.sensor_id,
+             time_json,
+             temp_str,
+             hum_str,
+             last_measurement.quality);
+}
+
+// Estado de conexão e alarmes (evento "status")
+static void format_status_json(char *json, size_t len) {
+    EventBits_t wifi_bits = wifi_event_group != NULL ? xEventGroupGetBits(wifi_event_group) : 0;
+    EventBits_t sys_bits = system_event_group != NULL ? xEventGroupGetBits(system_event_group) : 0;
+    unsigned alarms_active = 0;
+    for (uint8_t r = 0; r < alarm_rules_count(); r++) {
+        alarm_rule_stats_t as;
+        alarm_rules_get_stats(r, &as);
+        alarms_active += as.active_mask != 0;
+    }
+    snprintf(json, len,
+             "{\"wifi\":%s,\"mqtt\":%s,\"synced\":%s,\"mac\":\"%02X:%02X:%02X:%02X:%02X:%02X\",\"alarms_active\":%u}",
+             (wifi_bits & WIFI_CONNECTED_BIT) ? "true" : "false",
+             (sys_bits & MQTT_CONNECTED_BIT) ? "true" : "false",
+             (sys_bits & NTP_SYNCED_BIT) ? "true" : "false",
+             last_measurement.mac_address[0], last_measurement.mac_address[1],
+             last_measurement.mac_address[2], last_measurement.mac_address[3],
+             last_measurement.mac_address[4], last_measurement.mac_address[5],
+             alarms_active);
+}
+
+// Endpoint: GET /data (JSON com última medição)
+static void handle_data(http_conn_t *c, const http_request_t *req) {
+    char json[384];
+    format_data_json(json, sizeof(json));
+    http_begin(c, 200, "application/json", "Cache-Control: no-store\r\n", strlen(json));
+    http_write_str(c, json);
+}
+
+// Endpoint: GET /status (JSON com status completo do sistema)
+static void handle_status(http_conn_t *c, const http_request_t *req) {
+    http_begin(c, 200, "application/json", "Cache-Control: no-store\r\n", HTTP_LENGTH_UNKNOWN);
+
+    char mac_str[20];
+    snprintf(mac_str, sizeof(mac_str), "%02X:%02X:%02X:%02X:%02X:%02X",
+        last_measurement.mac_address[0], last_measurement.mac_address[1],
+        last_measurement.mac_address[2], last_measurement.mac_address[3],
+        last_measurement.mac_address[4], last_measurement.mac_address[5]);
+
+    bool wifi_connected = false;
+    bool mqtt_connected = false;
+    if (wifi_event_group != NULL) {
+        EventBits_t bits = xEventGroupGetBits(wifi_event_group);
+        wifi_connected = (bits & WIFI_CONNECTED_BIT) != 0;
+    }
+    if (system_event_group != NULL) {
+        EventBits_t bits = xEventGroupGetBits(system_event_group);
+        mqtt_connected = (bits & MQTT_CONNECTED_BIT) != 0;
+    }
+
+    char temp_str[12], hum_str[12];
+    format_value(temp_str, sizeof(temp_str), &last_measurement, last_measurement.temperature_x10, true);
+    format_value(hum_str, sizeof(hum_str), &last_measurement, last_measurement.humidity_x10, true);
+
+    window_stats_counters_t wc;
+    window_stats_get_counters(&wc);
+
+    char ts_str[12];
+    format_timestamp(ts_str, sizeof(ts_str), &last_measurement);
+
+    char json[512];
+    snprintf(json, sizeof(json),
+             "{\"firmware\":\"%s\",\"sensor_id\":\"%s\",\"mac\":\"%s\","
+             "\"wifi_connected\":%s,\"mqtt_connected\":%s,"
+             "\"mqtt_sent\":%lu,\"backlog_count\":%lu,"
+             "\"last_measurement\":{\"timestamp\":%s,\"temperature\":%s,\"humidity\":%s,\"quality\":%u},"
+             "\"windows\":{\"summary_only\":%s,\"closed\":%lu,\"dropped\":%lu},"
+             "\"record_pool\":{\"size\":%d,\"free\":%lu,\"ring\":%lu},"
+             "\"stack_free\":{\"measurement\":%lu},"
+             "\"sensors\":[",
+             FIRMWARE_VERSION,
+             last_measurement.sensor_id,
+             mac_str,
+             wifi_connected ? "true" : "false",
+             mqtt_connected ? "true" : "false",
+             (unsigned long)mqtt_messages_sent,
+             (unsigned long)ring_idx.count,
+             ts_str,
+             temp_str,
+             hum_str,
+             last_measurement.quality,
+             WINDOW_STATS_SUMMARY_ONLY ? "true" : "false",
+             (unsigned long)wc.windows_closed,
+             (unsigned long)wc.summaries_dropped,
+             MEAS_POOL_SIZE,
+             (unsigned long)meas_pool_free_count(),
+             (unsigned long)meas_ring_count(),
+             (unsigned long)measurement_stack_free());
+    http_write_str(c, json);
+
+    // Um objeto por sensor da tabela (escrito em partes para manter a pilha pequena)
+    for (size_t i = 0; i < sensor_count; i++) {
+        measurement_data_t m;
+        sensor_pipeline_stats_t ps;
+        measurement_get_sensor_last(i, &m);
+        measurement_get_pipeline_stats(i, &ps);
+        format_value(temp_str, sizeof(temp_str), &m, m.temperature_x10, true);
+        format_value(hum_str, sizeof(hum_str), &m, m.humidity_x10, true);
+        format_timestamp(ts_str, sizeof(ts_str), &m);
+
+        snprintf(json, sizeof(json),
+                 "%s{\"sensor_id\":\"%s\",\"pin\":%d,\"type\":%d,\"interval_ms\":%lu,"
+                 "\"timestamp\":%s,\"temperature\":%s,\"humidity\":%s,\"quality\":%u,"
+                 "\"samples\":%lu,\"reads\":%lu,\"read_failures\":%lu,"
+                 "\"rejected_range\":%lu,\"rejected_rate\":%lu,\"retried\":%lu,"
+                 "\"stale\":%lu,\"missing\":%lu,"
+                 "\"bus_us\":%lu,\"cpu_us\":%lu,\"cpu_us_max\":%lu,",
+                 i > 0 ? "," : "",
+                 sensor_table[i].sensor_id,
+                 sensor_table[i].pin,
+                 sensor_table[i].type,
+                 (unsigned long)sensor_table[i].interval_ms,
+                 ts_str,
+                 temp_str,
+                 hum_str,
+                 m.quality,
+                 (unsigned long)ps.samples,
+                 (unsigned long)ps.reads,
+                 (unsigned long)ps.read_failures,
+                 (unsigned long)ps.rejected_range,
+                 (unsigned long)ps.rejected_rate,
+                 (unsigned long)ps.retried,
+                 (unsigned long)ps.stale,
+                 (unsigned long)ps.missing,
+                 (unsigned long)ps.bus_us_last,
+                 (unsigned long)ps.cpu_us_last,
+                 (unsigned long)ps.cpu_us_max);
+        http_write_str(c, json);
+
+        measurement_schedule_stats_t ss;
+        measurement_get_schedule_stats(i, &ss);
+        snprintf(json, sizeof(json),
+                 "\"schedule\":{\"aligned\":%s,\"slots\":%lu,\"overruns\":%lu,"
+                 "\"jitter_us\":{\"last\":%ld,\"max\":%ld,\"avg\":%ld}},",
+                 ss.aligned ? "true" : "false",
+                 (unsigned long)ss.slots,
+                 (unsigned long)ss.overruns,
+                 (long)ss.last_jitter_us,
+                 (long)ss.max_jitter_us,
+                 (long)ss.avg_jitter_us);
+        http_write_str(c, json);
+
+        // Última decisão do intervalo adaptativo
+        sampling_decision_t sd;
+        sampling_policy_get(i, &sd);
+        snprintf(json, sizeof(json),
+                 "\"sampling\":{\"base_ms\":%lu,\"interval_ms\":%lu,\"storage\":%s,"
+                 "\"stable\":%s,\"fill_pct\":%u,\"link_up\":%s,\"stable_count\":%u,"
+                 "\"changes\":%lu}}",
+                 (unsigned long)sd.base_ms,
+                 (unsigned long)sd.interval_ms,
+                 (sd.reasons & SAMPLING_REASON_STORAGE) ? "true" : "false",
+                 (sd.reasons & SAMPLING_REASON_STABLE) ? "true" : "false",
+                 sd.fill_pct,
+                 sd.link_up ? "true" : "false",
+                 sd.stable_count,
+                 (unsigned long)sd.changes);
+        http_write_str(c, json);
+    }
+    // Tráfego I2C do display por quadro
+    oled_display_stats_t ds;
+    oled_display_get_stats(&ds);
+    snprintf(json, sizeof(json),
+             "],\"display\":{\"shadow\":%s,\"frames\":%lu,"
+             "\"i2c_bytes\":{\"last\":%lu,\"max\":%lu,\"avg\":%lu},"
+             "\"i2c_transactions\":{\"last\":%lu,\"max\":%lu,\"avg\":%lu},"
+             "\"full_refresh\":{\"us\":%lu,\"bytes\":%lu,\"transactions\":%lu,\"bytes_per_s\":%lu,"
+             "\"cycles\":{\"runtime\":%lu,\"static\":%lu}},"
+             "\"digit_cycles\":{\"scaled\":%lu,\"cached\":%lu},",
+             ds.shadow ? "true" : "false",
+             (unsigned long)ds.frames,
+             (unsigned long)ds.bytes_last,
+             (unsigned long)ds.bytes_max,
+             (unsigned long)(ds.frames ? ds.bytes_total / ds.frames : 0),
+             (unsigned long)ds.transactions_last,
+             (unsigned long)ds.transactions_max,
+             (unsigned long)(ds.frames ? ds.transactions_total / ds.frames : 0),
+             (unsigned long)ds.refresh_us,
+             (unsigned long)ds.refresh_bytes,
+             (unsigned long)ds.refresh_transactions,
+             (unsigned long)(ds.refresh_us ? (uint64_t)ds.refresh_bytes * 1000000U / ds.refresh_us : 0),
+             (unsigned long)ds.refresh_cycles_runtime,
+             (unsigned long)ds.refresh_cycles_static,
+             (unsigned long)ds.digit_cycles_scaled,
+             (unsigned long)ds.digit_cycles_cached);
+    http_write_str(c, json);
+    snprintf(json, sizeof(json),
+             "\"trend\":{\"scrolls\":%lu,\"late\":%lu,\"redraws\":%lu},\"shift_rows\":%u,\"shift_cols\":%u,",
+             (unsigned long)ds.trend_scrolls,
+             (unsigned long)ds.trend_scroll_resends,
+             (unsigned long)ds.trend_redraws,
+             (unsigned)ds.shift_rows,
+             (unsigned)ds.shift_cols);
+    http_write_str(c, json);
+    // Energia do painel: tempo ligado/desligado e estimativa do tráfego evitado
+    snprintf(json, sizeof(json),
+             "\"power\":{\"on\":%s,\"contrast\":%u,\"on_s\":%lu,\"off_s\":%lu,"
+             "\"offs\":%lu,\"wakes\":%lu,\"bytes_skipped_est\":%lu},",
+             ds.panel_on ? "true" : "false",
+             (unsigned)ds.contrast,
+             (unsigned long)(ds.on_us / 1000000),
+             (unsigned long)(ds.off_us / 1000000),
+             (unsigned long)ds.power_offs,
+             (unsigned long)ds.wakes,
+             (unsigned long)ds.bytes_skipped_est);
+    http_write_str(c, json);
+    // CPU da renderização e do envio (com framebuffer sombra, envio = tempo de barramento)
+    snprintf(json, sizeof(json),
+             "\"renders\":%lu,\"cpu_us\":{\"render\":{\"last\":%lu,\"max\":%lu,\"avg\":%lu,\"total_ms\":%lu},"
+             "\"flush\":{\"last\":%lu,\"max\":%lu,\"avg\":%lu,\"total_ms\":%lu}}},"
+             "\"alarm_backlog\":%lu,\"alarms\":[",
+             (unsigned long)ds.renders,
+             (unsigned long)ds.render_us_last,
+             (unsigned long)ds.render_us_max,
+             (unsigned long)(ds.renders ? ds.render_us_total / ds.renders : 0),
+             (unsigned long)(ds.render_us_total / 1000),
+             (unsigned long)ds.flush_us_last,
+             (unsigned long)ds.flush_us_max,
+             (unsigned long)(ds.frames ? ds.flush_us_total / ds.frames : 0),
+             (unsigned long)(ds.flush_us_total / 1000),
+             (unsigned long)spiffs_alarm_count());
+    http_write_str(c, json);
+
+    // Estado e custo de avaliação de cada regra de alarme (ciclos de CPU)
+    for (uint8_t r = 0; r < alarm_rules_count(); r++) {
+        alarm_rule_stats_t as;
+        alarm_rules_get_stats(r, &as);
+        snprintf(json, sizeof(json),
+                 "%s{\"rule\":\"%s\",\"active_mask\":%u,\"evaluations\":%lu,"
+                 "\"transitions\":%lu,\"cycles\":{\"last\":%lu,\"max\":%lu,\"avg\":%lu}}",
+                 r > 0 ? "," : "",
+                 alarm_rules_name(r),
+                 as.active_mask,
+                 (unsigned long)as.evaluations,
+                 (unsigned long)as.transitions,
+                 (unsigned long)as.cycles_last,
+                 (unsigned long)as.cycles_max,
+                 (unsigned long)(as.evaluations ? as.cycles_total / as.evaluations : 0));
+        http_write_str(c, json);
+    }
+    // Slots do servidor HTTP (leitura sem trava: contadores de 32 bits)
+    uint32_t connections = 0, requests = 0, errors = 0;
+    unsigned busy = 0;
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        connections += http_slots[i].conn.connections_total;
+        requests += http_slots[i].conn.requests_total;
+        errors += http_slots[i].conn.errors_total;
+        busy += http_slots[i].busy;
+    }
+    snprintf(json, sizeof(json),
+             "],\"http\":{\"slots\":%d,\"busy\":%u,\"connections\":%lu,\"requests\":%lu,\"errors\":%lu,"
+             "\"streams\":%d,\"events\":%lu,\"stack_free\":[",
+             HTTP_MAX_CONNECTIONS,
+             busy,
+             (unsigned long)connections,
+             (unsigned long)requests,
+             (unsigned long)errors,
+             sse_streams,
+             (unsigned long)sse_events_sent);
+    http_write_str(c, json);
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        snprintf(json, sizeof(json), "%s%lu", i ? "," : "", (unsigned long)http_slots[i].stack_free);
+        http_write_str(c, json);
+    }
+    http_write_str(c, "]}}");
+}
+
+static const history_source_t spiffs_history = {
+    .range = spiffs_measurement_range,
+    .read = spiffs_read_measurements,
+};
+
+// Endpoint: GET /history (registros do SPIFFS em CSV ou JSON, chunked)
+static void handle_history(http_conn_t *c, const http_request_t *req) {
+    history_handle(c, req, &spiffs_history);
+}
+
+static bool sse_acquire(size_t idx) {
+    bool ok = false;
+    portENTER_CRITICAL();
+    if (sse_streams < HTTP_SSE_MAX_STREAMS) {
+        sse_tasks[idx] = xTaskGetCurrentTaskHandle();
+        sse_streams++;
+        ok = true;
+    }
+    portEXIT_CRITICAL();
+    return ok;
+}
+
+static void sse_release(size_t idx) {
+    portENTER_CRITICAL();
+    sse_tasks[idx] = NULL;
+    sse_streams--;
+    portEXIT_CRITICAL();
+}
+
+void http_events_notify(uint32_t events) {
+    TaskHandle_t tasks[HTTP_MAX_CONNECTIONS];
+    portENTER_CRITICAL();
+    memcpy(tasks, sse_tasks, sizeof(tasks));
+    portEXIT_CRITICAL();
+    // As tasks dos slots nunca são apagadas: o handle copiado continua válido
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        if (tasks[i] != NULL) {
+            xTaskNotify(tasks[i], events, eSetBits);
+        }
+    }
+}
+
+static void write_event(http_conn_t *c, const char *name, const char *json) {
+    http_write_str(c, "event: ");
+    http_write_str(c, name);
+    http_write_str(c, "\ndata: ");
+    http_write_str(c, json);
+    http_write_str(c, "\n\n");
+    sse_events_sent++;
+}
+
+// Endpoint: GET /events (Server-Sent Events: medição nova e mudança de estado)
+static void handle_events(http_conn_t *c, const http_request_t *req) {
+    http_slot_t *slot = c->io.ctx;
+    size_t idx = (size_t)(slot - http_slots);
+    // Um slot fica sempre livre para requisições comuns
+    if (!sse_acquire(idx)) {
+        http_send_error(c, 503);
+        return;
+    }
+    xTaskNotifyWait(0, UINT32_MAX, NULL, 0);    // avisos de um stream anterior deste slot
+    http_begin(c, 200, "text/event-stream", "Cache-Control: no-store\r\n", HTTP_LENGTH_UNKNOWN);
+    http_write_str(c, "retry: 5000\n\n");
+    // Painel web aberto (toda aba abre este stream): conta como atividade para o display
+    oled_display_notify(OLED_EVT_ACTIVITY);
+
+    // Ao conectar, o estado atual; depois só o que mudou
+    uint32_t events = HTTP_EVT_MEASUREMENT | HTTP_EVT_STATUS;
+    char json[384];
+    while (!c->failed) {
+        if (events & HTTP_EVT_MEASUREMENT) {
+            format_data_json(json, sizeof(json));
+            write_event(c, "measurement", json);
+        }
+        if (events & HTTP_EVT_STATUS) {
+            format_status_json(json, sizeof(json));
+            write_event(c, "status", json);
+        }
+        if (events == 0) {
+            // Comentário: mantém proxies e NAT abertos e detecta o cliente que sumiu
+            http_write_str(c, ": ping\n\n");
+        }
+        http_flush(c);
+
+        events = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &events, pdMS_TO_TICKS(HTTP_SSE_PING_S * 1000));
+#if LWIP_SO_RCVTIMEO
+        // Aba fechada: o FIN do navegador aparece como erro no recv
+        if (c->io.recv(c->io.ctx, json, sizeof(json), 1) < 0) {
+            break;
+        }
+#endif
+    }
+    c->keep_alive = false;
+    sse_release(idx);
+}
+
+static const http_route_t routes[] = {
+    { "GET", "/data", handle_data },
+    { "GET", "/status", handle_status },
+    { "GET", "/events", handle_events },
+    { "GET", "/history", handle_history },
+    { "GET", "/*", www_handle },        // painel: /, /app.js, /style.css
+};
+
+// Transporte netconn do núcleo HTTP: o netbuf recebido é consumido aos poucos, o
+// cabeçalho pode estar dividido entre netbufs e o resto de um netbuf fica para a
+// próxima requisição
+static int slot_recv(void *ctx, char *buf, size_t len, uint32_t timeout_ms) {
+    http_slot_t *slot = ctx;
+    if (slot->pending == NULL) {
+#if LWIP_SO_RCVTIMEO
+        netconn_set_recvtimeout(slot->nc, (int)timeout_ms);
+#endif
+        err_t err = netconn_recv(slot->nc, &slot->pending);
+        if (err == ERR_TIMEOUT) {
+            return 0;
+        }
+        if (err != ERR_OK || slot->pending == NULL) {
+            slot->pending = NULL;
+            return -1;
+        }
+        slot->offset = 0;
+    }
+    u16_t n = netbuf_copy_partial(slot->pending, buf, len > 0xFFFF ? 0xFFFF : (u16_t)len, slot->offset);
+    slot->offset += n;
+    if (slot->offset >= netbuf_len(slot->pending)) {
+        netbuf_delete(slot->pending);
+        slot->pending = NULL;
+    }
+    return n;
+}
+
+static bool slot_send(void *ctx, const void *data, size_t len) {
+    http_slot_t *slot = ctx;
+    return netconn_write(slot->nc, data, len, NETCONN_COPY) == ERR_OK;
+}
+
+// Assets do painel: const, nunca mudam; o lwIP referencia os bytes em vez de copiá-los
+// para o buffer de envio, que fica livre para as outras conexões
+static bool slot_send_static(void *ctx, const void *data, size_t len) {
+    http_slot_t *slot = ctx;
+    return netconn_write(slot->nc, data, len, NETCONN_NOCOPY) == ERR_OK;
+}
+
+static bool slot_waiting(void *ctx) {
+    return uxQueueMessagesWaiting(accept_queue) > 0;
+}
+
+// O pcb pertence à tcpip_thread: tcpip_api_call() roda a função com o core lock
+// (LWIP_TCPIP_CORE_LOCKING) ou dentro da própria thread, e espera terminar
+typedef struct {
+    struct tcpip_api_call_data call;
+    struct netconn *nc;
+} nagle_call_t;
+
+static err_t nagle_disable_fn(struct tcpip_api_call_data *call) {
+    struct netconn *nc = ((nagle_call_t *)call)->nc;
+    // Conexão já derrubada pelo cliente: o pcb foi liberado
+    if (nc->pcb.tcp != NULL) {
+        tcp_nagle_disable(nc->pcb.tcp);
+    }
+    return ERR_OK;
+}
+
+void http_server_init(void) {
+    accept_queue = xQueueCreate(HTTP_ACCEPT_QUEUE_LEN, sizeof(struct netconn *));
+    if (accept_queue == NULL) {
+        ESP_LOGE(TAG, "Failed to create HTTP accept queue");
+    }
 }
 
 void http_server_task(void *pvParameters) {
-    ESP_LOGI(TAG, "HTTP server task started");
+    ESP_LOGI(TAG, "HTTP server task started (%d slots, keep-alive %d s)", HTTP_MAX_CONNECTIONS, HTTP_KEEPALIVE_S);
     struct netconn *conn, *newconn;
     conn = netconn_new(NETCONN_TCP);
     netconn_bind(conn, NULL, 80);
@@ -26,150 +535,49 @@ void http_server_task(void *pvParameters) {
 
     while (1) {
         if (netconn_accept(conn, &newconn) == ERR_OK) {
-            struct netbuf *inbuf;
-            char *buf;
-            u16_t buflen;
-
-            if (netconn_recv(newconn, &inbuf) == ERR_OK && inbuf != NULL) {
-                netbuf_data(inbuf, (void**)&buf, &buflen);
-
-                // Endpoint: GET /data (JSON com última medição)
-                if (request_starts_with(buf, "/data")) {
-                    const char *hdr =
-                        "HTTP/1.1 200 OK\r\n"
-                        "Content-Type: application/json\r\n"
-                        "Connection: close\r\n"
-                        "Cache-Control: no-store\r\n\r\n";
-                    netconn_write(newconn, hdr, strlen(hdr), NETCONN_COPY);
-
-                    char json[384];
-                    snprintf(json, sizeof(json),
-                             "{\"sensor_id\":\"%s\",\"timestamp\":%lu,\"temperature\":%.1f,\"humidity\":%.1f}",
-                             last_measurement.sensor_id,
-                             (unsigned long)last_measurement.timestamp,
-                             last_measurement.temperature,
-                             last_measurement.humidity);
-                    netconn_write(newconn, json, strlen(json), NETCONN_COPY);
-                }
-                // Endpoint: GET /status (JSON com status completo do sistema)
-                else if (request_starts_with(buf, "/status")) {
-                    const char *hdr =
-                        "HTTP/1.1 200 OK\r\n"
-                        "Content-Type: application/json\r\n"
-                        "Connection: close\r\n"
-                        "Cache-Control: no-store\r\n\r\n";
-                    netconn_write(newconn, hdr, strlen(hdr), NETCONN_COPY);
-
-                    char mac_str[20];
-                    snprintf(mac_str, sizeof(mac_str), "%02X:%02X:%02X:%02X:%02X:%02X",
-                        last_measurement.mac_address[0], last_measurement.mac_address[1],
-                        last_measurement.mac_address[2], last_measurement.mac_address[3],
-                        last_measurement.mac_address[4], last_measurement.mac_address[5]);
-
-                    bool wifi_connected = false;
-                    bool mqtt_connected = false;
-                    if (wifi_event_group != NULL) {
-                        EventBits_t bits = xEventGroupGetBits(wifi_event_group);
-                        wifi_connected = (bits & WIFI_CONNECTED_BIT) != 0;
-                    }
-                    if (system_event_group != NULL) {
-                        EventBits_t bits = xEventGroupGetBits(system_event_group);
-                        mqtt_connected = (bits & MQTT_CONNECTED_BIT) != 0;
-                    }
-
-                    char json[512];
-                    snprintf(json, sizeof(json),
-                             "{\"firmware\":\"%s\",\"sensor_id\":\"%s\",\"mac\":\"%s\","
-                             "\"wifi_connected\":%s,\"mqtt_connected\":%s,"
-                             "\"mqtt_sent\":%lu,\"backlog_count\":%lu,"
-                             "\"last_measurement\":{\"timestamp\":%lu,\"temperature\":%.1f,\"humidity\":%.1f}}",
-                             FIRMWARE_VERSION,
-                             last_measurement.sensor_id,
-                             mac_str,
-                             wifi_connected ? "true" : "false",
-                             mqtt_connected ? "true" : "false",
-                             (unsigned long)mqtt_messages_sent,
-                             (unsigned long)ring_idx.count,
-                             (unsigned long)last_measurement.timestamp,
-                             last_measurement.temperature,
-                             last_measurement.humidity);
-                    netconn_write(newconn, json, strlen(json), NETCONN_COPY);
-                }
-                // Endpoint: GET / (página HTML principal)
-                else {
-                    const char *hdr =
-                        "HTTP/1.1 200 OK\r\n"
-                        "Content-Type: text/html; charset=UTF-8\r\n"
-                        "Connection: close\r\n"
-                        "Cache-Control: no-store\r\n\r\n";
-                    netconn_write(newconn, hdr, strlen(hdr), NETCONN_COPY);
-
-                    // Início do HTML
-                    const char *html_start =
-                        "<html><head><meta name='viewport' content='width=device-width, initial-scale=1'>"
-                        "<meta charset='UTF-8'>"
-                        "<meta http-equiv='refresh' content='1'>"
-                        "<style>body{font-family:sans-serif;background:#f4f4f4;margin:0;padding:0;}"
-                        ".container{max-width:400px;margin:40px auto;background:#fff;padding:24px;"
-                        "border-radius:8px;box-shadow:0 2px 8px #ccc;}"
-                        "h1{color:#2196F3;} .data{font-size:1.2em;margin:12px 0;"
-                        "display:flex;justify-content:space-between;} .label{color:#888;}"
-                        "@media(max-width:500px){.container{margin:10px;padding:10px;}}</style></head><body>"
-                        "<div class='container'><h1>ESP8266 Datalogger</h1>";
-                    netconn_write(newconn, html_start, strlen(html_start), NETCONN_COPY);
-
-                    // Dados dinâmicos (temperatura, umidade, etc.)
-                    char line[192];
-                    struct tm timeinfo;
-                    localtime_r((time_t*)&last_measurement.timestamp, &timeinfo);
-                    char date_str[64];
-                    strftime(date_str, sizeof(date_str), "%d/%m/%Y %H:%M:%S", &timeinfo);
-
-                    char mac_str[20];
-                    snprintf(mac_str, sizeof(mac_str), "%02X:%02X:%02X:%02X:%02X:%02X",
-                        last_measurement.mac_address[0], last_measurement.mac_address[1],
-                        last_measurement.mac_address[2], last_measurement.mac_address[3],
-                        last_measurement.mac_address[4], last_measurement.mac_address[5]);
-
-                    snprintf(line, sizeof(line),
-                             "<div class='data'><span class='label'>Temperatura:</span><span>%.1f°C</span></div>",
-                             last_measurement.temperature);
-                    netconn_write(newconn, line, strlen(line), NETCONN_COPY);
-
-                    snprintf(line, sizeof(line),
-                             "<div class='data'><span class='label'>Umidade:</span><span>%.1f%%</span></div>",
-                             last_measurement.humidity);
-                    netconn_write(newconn, line, strlen(line), NETCONN_COPY);
-
-                    snprintf(line, sizeof(line),
-                             "<div class='data'><span class='label'>Data da Medição:</span><span>%s</span></div>",
-                             date_str);
-                    netconn_write(newconn, line, strlen(line), NETCONN_COPY);
-
-                    snprintf(line, sizeof(line),
-                             "<div class='data'><span class='label'>MAC:</span><span>%s</span></div>",
-                             mac_str);
-                    netconn_write(newconn, line, strlen(line), NETCONN_COPY);
-
-                    snprintf(line, sizeof(line),
-                             "<div class='data'><span class='label'>Firmware:</span><span>%s</span></div>",
-                             FIRMWARE_VERSION);
-                    netconn_write(newconn, line, strlen(line), NETCONN_COPY);
-
-                    snprintf(line, sizeof(line),
-                             "<div class='data'><span class='label'>Sensor ID:</span><span>%s</span></div>",
-                             last_measurement.sensor_id);
-                    netconn_write(newconn, line, strlen(line), NETCONN_COPY);
-
-                    // Finaliza HTML
-                    const char *html_end = "</div></body></html>";
-                    netconn_write(newconn, html_end, strlen(html_end), NETCONN_COPY);
-                }
-
-                netbuf_delete(inbuf);
+            // Sem slot livre a conexão espera na fila; a fila cheia segura o accept
+            if (accept_queue == NULL || xQueueSend(accept_queue, &newconn, portMAX_DELAY) != pdTRUE) {
+                netconn_close(newconn);
+                netconn_delete(newconn);
             }
-            netconn_close(newconn);
-            netconn_delete(newconn);
         }
     }
 }
+
+void http_worker_task(void *pvParameters) {
+    http_slot_t *slot = &http_slots[(uintptr_t)pvParameters];
+    const http_io_t io = {
+        .ctx = slot,
+        .recv = slot_recv,
+        .send = slot_send,
+        .send_static = slot_send_static,
+        .waiting = slot_waiting,
+    };
+
+    slot->stack_free = uxTaskGetStackHighWaterMark(NULL);
+    while (1) {
+        if (accept_queue == NULL || xQueueReceive(accept_queue, &slot->nc, portMAX_DELAY) != pdTRUE) {
+            vTaskDelay(pdMS_TO_TICKS(1000));
+            continue;
+        }
+        slot->busy = true;
+        slot->pending = NULL;
+#if LWIP_SO_SNDTIMEO
+        netconn_set_sendtimeout(slot->nc, HTTP_SEND_TIMEOUT_MS);
+#endif
+        // Respostas saem em blocos de HTTP_TX_BUF_LEN; com Nagle o último pedaço esperaria
+        // o ACK atrasado do cliente, o que em keep-alive vira latência de cada requisição
+        nagle_call_t nagle = { .nc = slot->nc };
+        tcpip_api_call(nagle_disable_fn, &nagle.call);
+        http_conn_serve(&slot->conn, &io, routes, sizeof(routes) / sizeof(routes[0]), HTTP_IDLE_MS);
+        if (slot->pending != NULL) {
+            netbuf_delete(slot->pending);
+            slot->pending = NULL;
+        }
+        netconn_close(slot->nc);
+        netconn_delete(slot->nc);
+        slot->nc = NULL;
+        slot->busy = false;
+        slot->stack_free = uxTaskGetStackHighWaterMark(NULL);
+    }
+}
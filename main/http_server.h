@@ -1,10 +1,33 @@
 #ifndef HTTP_SERVER_H
 #define HTTP_SERVER_H
 
+#include <stdint.h>
+
+// Eventos do stream GET /events (Server-Sent Events)
+#define HTTP_EVT_MEASUREMENT    (1 << 0)    // nova medição do sensor principal
+#define HTTP_EVT_STATUS         (1 << 1)    // WiFi, MQTT, NTP ou alarme mudou
+
+/**
+ * @brief Cria a fila de conexões aceitas; chamar antes de criar as tasks do servidor
+ */
+void http_server_init(void);
+
 /**
- * @brief Tarefa do servidor HTTP
+ * @brief Tarefa do servidor HTTP: aceita conexões e as entrega aos slots
  * @param pvParameters Parâmetros da task (não utilizado)
  */
 void http_server_task(void *pvParameters);
 
+/**
+ * @brief Tarefa de um slot de conexão (HTTP_MAX_CONNECTIONS tasks)
+ * @param pvParameters Índice do slot
+ */
+void http_worker_task(void *pvParameters);
+
+/**
+ * @brief Avisa os streams /events abertos; sem efeito se não houver nenhum
+ * @param events Máscara HTTP_EVT_*
+ */
+void http_events_notify(uint32_t events);
+
 #endif // HTTP_SERVER_H
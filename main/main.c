@@ -11,6 +11,7 @@
 #include "esp_log.h"
 #include "nvs_flash.h"
 #include "ssd1306.h"
+#include "intf/i2c/ssd1306_i2c.h"
 
 // Includes dos módulos refatorados
 #include "config.h"
@@ -20,6 +21,7 @@
 #include "dns_manager.h"
 #include "measurement.h"
 #include "ntp_manager.h"
+#include "timebase.h"
 #include "mqtt_manager.h"
 #include "wifi_manager.h"
 #include "http_server.h"
@@ -31,13 +33,14 @@
 #define TASK_STACK_MED   4096
 #define TASK_STACK_LARGE 8192
 
-#define PRIO_OLED        7
 #define PRIO_WIFI        6
 #define PRIO_NTP         5
 #define PRIO_MQTT_MON    4
 #define PRIO_MEASUREMENT 3
 #define PRIO_HTTP        2
 #define PRIO_SYS_STATUS  1
+#define PRIO_OLED        1
+#define PRIO_OLED_FLUSH  1
 
 
 // Inicialização do sistema: NVS, SPIFFS, Event Groups, Queues, Mutexes
@@ -46,6 +49,9 @@ static esp_err_t init_system(void) {
 
     // Inicializar display OLED
     ssd1306_128x64_i2c_initEx(I2C_MASTER_SCL_IO, I2C_MASTER_SDA_IO, I2C_OLED_ADDR);
+    if (OLED_STATIC_DRIVER_ENABLED) {
+        ssd1306_setStaticDriver(ssd1306_128x64_staticDriver());
+    }
 #ifdef CONFIG_ENABLE_OLED_DISPLAY
     ssd1306_clearScreen();
     ESP_LOGI(TAG, "OLED display initialized successfully");
@@ -67,6 +73,9 @@ static esp_err_t init_system(void) {
         return ret;
     }
 
+    // Novo boot_id e âncoras de boots anteriores (base de tempo dos registros)
+    timebase_init();
+
     // Inicializar SPIFFS
     ret = spiffs_init();
     if (ret != ESP_OK) {
@@ -81,11 +90,25 @@ static esp_err_t init_system(void) {
         return ESP_FAIL;
     }
 
-    // Criar queue para medições
-    measurement_queue = xQueueCreate(20, sizeof(measurement_data_t)); 
-    if (measurement_queue == NULL) {
-        ESP_LOGE(TAG, "Failed to create measurement queue");
-        return ESP_FAIL;
+    // Medições circulam por ponteiro entre measurement_task e mqtt_publish_task
+    // (pool estático + anel SPSC em measurement_pool.c, sem queue FreeRTOS)
+
+    // Criar queue para resumos de janela (estatísticas por janela)
+    if (WINDOW_STATS_ENABLED) {
+        summary_queue = xQueueCreate(SUMMARY_QUEUE_LEN, sizeof(window_summary_t));
+        if (summary_queue == NULL) {
+            ESP_LOGE(TAG, "Failed to create summary queue");
+            return ESP_FAIL;
+        }
+    }
+
+    // Criar queue para eventos de alarme (publicados antes de qualquer medição)
+    if (ALARM_ENABLED) {
+        alarm_queue = xQueueCreate(ALARM_QUEUE_LEN, sizeof(alarm_event_t));
+        if (alarm_queue == NULL) {
+            ESP_LOGE(TAG, "Failed to create alarm queue");
+            return ESP_FAIL;
+        }
     }
 
     // Criar mutex MQTT cedo para evitar tarefas tentarem usar antes de mqtt_init
@@ -128,12 +151,24 @@ void app_main(void) {
     create_task_checked(wifi_monitor_task, "wifi_monitor", TASK_STACK_SMALL, NULL, PRIO_WIFI);
     create_task_checked(ntp_sync_task, "ntp_sync", TASK_STACK_SMALL, NULL, PRIO_NTP);
 #ifdef CONFIG_ENABLE_OLED_DISPLAY
+    oled_display_init();
     create_task_checked(oled_display_task, "oled_display", TASK_STACK_SMALL, NULL, PRIO_OLED);
+    create_task_checked(oled_flush_task, "oled_flush", TASK_STACK_SMALL, NULL, PRIO_OLED_FLUSH);
 #endif
-    create_task_checked(measurement_task, "measurement", TASK_STACK_SMALL, NULL, PRIO_MEASUREMENT);
+    // Com o pool esgotado ou o anel cheio a amostra vai direto ao SPIFFS (fopen/fwrite do
+    // VFS) a partir desta task, em cima do fechamento de janela e do evento de alarme
+    create_task_checked(measurement_task, "measurement", TASK_STACK_MED, NULL, PRIO_MEASUREMENT);
     create_task_checked(mqtt_monitor_task, "mqtt_monitor", TASK_STACK_SMALL, NULL, PRIO_MQTT_MON);
     create_task_checked(mqtt_publish_task, "mqtt_publish", TASK_STACK_MED, NULL, PRIO_MQTT_MON);
+    http_server_init();
     create_task_checked(http_server_task, "http_server", TASK_STACK_SMALL, NULL, PRIO_HTTP);
+    // Cada slot roda todos os handlers: /status formata em json[512], /history guarda um lote de
+    // registros e a linha de saída, e o snprintf vem por cima; a folga aparece em http.stack_free
+    for (uintptr_t i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "http_w%u", (unsigned)i);
+        create_task_checked(http_worker_task, name, TASK_STACK_MED, (void *)i, PRIO_HTTP);
+    }
     create_task_checked(system_status_task, "system_status", TASK_STACK_SMALL, NULL, PRIO_SYS_STATUS);
     create_task_checked(wifi_reconnect_manager_task, "wifi_reconnect_mgr", TASK_STACK_SMALL, NULL, PRIO_WIFI);
 
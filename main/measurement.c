@@ -2,136 +2,345 @@
 #include "globals.h"
 #include "config.h"
 #include <time.h>
+#include <sys/time.h>
 #include <string.h>
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "spiffs_manager.h"
 #include "esp_wifi.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
 #include "dht.h"  // Nova biblioteca DHT
+#include "sensor_pipeline.h"
+#include "sensor_table.h"
+#include "fixed_point.h"
+#include "window_stats.h"
+#include "alarm_rules.h"
+#include "measurement_pool.h"
+#include "sampling_policy.h"
+#include "timebase.h"
+#include "oled_display.h"
+#include "http_server.h"
+#include "trend_history.h"
+
+// Estado de aquisição por sensor (filtro, última leitura válida, contadores)
+static sensor_pipeline_t pipelines[SENSOR_MAX_COUNT];
+// Última medição de cada sensor (last_measurement guarda a do sensor principal)
+static measurement_data_t sensor_last[SENSOR_MAX_COUNT];
+// Próximo slot de leitura de cada sensor (µs do esp_timer, monotônico)
+static int64_t next_due_us[SENSOR_MAX_COUNT];
+// Deslocamento de cada sensor dentro do seu intervalo (escalonamento)
+static uint32_t sensor_offset_ms[SENSOR_MAX_COUNT];
+static measurement_schedule_stats_t schedule_stats[SENSOR_MAX_COUNT];
+static uint32_t stack_free = 0;
+
+void measurement_get_pipeline_stats(size_t idx, sensor_pipeline_stats_t *out) {
+    // Cópia simples: contadores só são escritos pela measurement_task
+    *out = pipelines[idx].stats;
+}
+
+void measurement_get_sensor_last(size_t idx, measurement_data_t *out) {
+    *out = sensor_last[idx];
+}
+
+void measurement_get_schedule_stats(size_t idx, measurement_schedule_stats_t *out) {
+    *out = schedule_stats[idx];
+}
+
+uint32_t measurement_stack_free(void) {
+    return stack_free;
+}
+
+// Lê um sensor da tabela e entrega o registro à mqtt_publish_task pelo anel do pool
+static void sample_sensor(size_t idx, const uint8_t mac[6]) {
+    const sensor_config_t *cfg = &sensor_table[idx];
+
+    // Instante do início da amostra (boot + uptime); o epoch é resolvido na publicação
+    uint16_t boot_id;
+    uint32_t uptime_ms;
+    timebase_now(&boot_id, &uptime_ms);
+
+    // Ler sensor com retries limitados, validação e filtro (sem valores simulados)
+    int16_t temperature = MEAS_VALUE_INVALID;
+    int16_t humidity = MEAS_VALUE_INVALID;
+    uint8_t retries = 0;
+    uint8_t quality = sensor_pipeline_acquire(&pipelines[idx], &temperature, &humidity, &retries);
+    if (quality & MEAS_QUALITY_MISSING) {
+        ESP_LOGW(TAG, "%s read failed after %d retries; sample marked as missing", cfg->sensor_id, retries);
+    } else if (quality & MEAS_QUALITY_STALE) {
+        ESP_LOGW(TAG, "%s read failed after %d retries; repeating last value (stale)", cfg->sensor_id, retries);
+    } else {
+        ESP_LOGI(TAG, "%s read successful: T=" FIXED_X10_FMT "°C, H=" FIXED_X10_FMT "%% (retries=%d, quality=0x%02X)",
+                 cfg->sensor_id, FIXED_X10_ARGS(temperature), FIXED_X10_ARGS(humidity), retries, quality);
+    }
+
+    // Preparar medição direto no snapshot do sensor (lido por HTTP/status)
+    measurement_data_t *measurement = &sensor_last[idx];
+    memset(measurement, 0, sizeof(*measurement));
+    measurement->uptime_ms = uptime_ms;
+    measurement->boot_id = boot_id;
+    strncpy(measurement->sensor_id, cfg->sensor_id, sizeof(measurement->sensor_id) - 1);
+    memcpy(measurement->mac_address, mac, 6);
+    measurement->temperature_x10 = temperature;
+    measurement->humidity_x10 = humidity;
+    measurement->retry_count = retries;
+    measurement->quality = quality;
+    uint32_t interval_s = sampling_policy_current(idx) / 1000U;
+    measurement->interval_s = (uint16_t)(interval_s > UINT16_MAX ? UINT16_MAX : interval_s);
+    measurement->measurement_id = ++measurement_counter;
+
+    // Amostra "missing" aparece como "--", como em format_value() do http_server.c
+    char temp_str[12] = "--";
+    char hum_str[12] = "--";
+    if (!(quality & MEAS_QUALITY_MISSING)) {
+        fixed_x10_format(temp_str, sizeof(temp_str), temperature, "--");
+        fixed_x10_format(hum_str, sizeof(hum_str), humidity, "--");
+    }
+    ESP_LOGI(TAG, "New measurement %s: %s°C, %s%% (ID: %u, boot %u +%u ms)",
+             measurement->sensor_id, temp_str, hum_str,
+             measurement->measurement_id, measurement->boot_id, measurement->uptime_ms);
+
+    // Detector de estabilidade da amostragem adaptativa
+    sampling_policy_observe(idx, measurement);
+
+    // Regras de alarme avaliadas antes de qualquer enfileiramento
+    alarm_rules_evaluate(idx, measurement);
+
+    // Estatísticas por janela; o resumo é enfileirado quando a janela fecha
+    window_stats_add(idx, measurement);
+
+    // Entregar ao mqtt_publish_task (decide se publica ou grava em SPIFFS)
+    // No modo somente-resumo a amostra bruta não é publicada nem armazenada
+    if (!WINDOW_STATS_SUMMARY_ONLY) {
+        measurement_data_t *record = meas_pool_alloc();
+        if (record == NULL) {
+            ESP_LOGE(TAG, "Measurement pool exhausted; storing ID %u directly in SPIFFS",
+                     measurement->measurement_id);
+            spiffs_store_measurement(measurement);
+        } else {
+            *record = *measurement;
+            if (!meas_ring_push(record)) {
+                // Publicador atrasado: persistir em vez de bloquear a amostragem
+                ESP_LOGW(TAG, "Measurement ring full; storing ID %u directly in SPIFFS",
+                         record->measurement_id);
+                spiffs_store_measurement(record);
+                meas_pool_release(record);
+            } else {
+                ESP_LOGI(TAG, "Measurement queued successfully (ring: %u/%d used, pool free: %u)",
+                         meas_ring_count(), MEAS_RING_LEN, meas_pool_free_count());
+            }
+        }
+    }
+
+    if (idx != 0) {
+        return;
+    }
+
+    // Atualizar variáveis globais (display mantém o último valor válido)
+    if (!(quality & MEAS_QUALITY_MISSING)) {
+        g_last_temperature_x10 = temperature;
+        g_last_humidity_x10 = humidity;
+        bool new_column = trend_history_add(uptime_ms, temperature, humidity) > 0;
+        oled_display_notify(OLED_EVT_MEASUREMENT | (new_column ? OLED_EVT_HISTORY : 0));
+    }
+
+    // Atualizar última medição global (sensor principal)
+    last_measurement = *measurement;
+    http_events_notify(HTTP_EVT_MEASUREMENT);
+}
+
+// Sensor com o prazo de leitura mais próximo
+static size_t next_sensor(void) {
+    size_t best = 0;
+    for (size_t i = 1; i < sensor_count; i++) {
+        if (next_due_us[i] < next_due_us[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Relógio de parede em ms, ou -1 enquanto o NTP não sincronizou
+static int64_t wallclock_ms(void) {
+    if (!time_synced) {
+        return -1;
+    }
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    if (tv.tv_sec < 1704067200) { // 2024
+        return -1;
+    }
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+/*
+ * Agenda o próximo slot do sensor a partir do slot anterior (agendamento
+ * absoluto: atrasos de leitura/queue não acumulam). Com NTP sincronizado e
+ * MEASUREMENT_ALIGN_WALLCLOCK, o slot é o primeiro múltiplo do intervalo no
+ * relógio de parede (mais o deslocamento do sensor) depois do slot anterior, a
+ * pelo menos meio intervalo dele para que um ajuste do relógio não repita o
+ * mesmo slot. Só os slots que já passaram são pulados e contam como overrun.
+ */
+static void schedule_next(size_t idx, int64_t now_us) {
+    measurement_schedule_stats_t *st = &schedule_stats[idx];
+    int64_t interval_ms = sampling_policy_next_interval(idx);
+    int64_t interval_us = interval_ms * 1000;
+    int64_t prev_due_us = next_due_us[idx];
+    int64_t next_us;
+
+    int64_t wall_ms = MEASUREMENT_ALIGN_WALLCLOCK ? wallclock_ms() : -1;
+    if (wall_ms >= 0) {
+        // Slot anterior no relógio de parede: uma amostra lenta não desloca a base
+        int64_t prev_wall_ms = wall_ms - (now_us - prev_due_us) / 1000;
+        int64_t base = prev_wall_ms - sensor_offset_ms[idx] + interval_ms / 2;
+        int64_t boundary_ms = (base / interval_ms + 1) * interval_ms + sensor_offset_ms[idx];
+        next_us = now_us + (boundary_ms - wall_ms) * 1000;
+
+        // Slots que já passaram são pulados e contam como overrun
+        while (next_us <= now_us) {
+            next_us += interval_us;
+            if (st->aligned) {
+                st->overruns++;
+            }
+        }
+        if (!st->aligned) {
+            ESP_LOGI(TAG, "%s: sampling aligned to wall clock (every %u ms, offset %u ms)",
+                     sensor_table[idx].sensor_id, (unsigned)interval_ms, sensor_offset_ms[idx]);
+        }
+        st->aligned = true;
+    } else {
+        next_us = prev_due_us + interval_us;
+        while (next_us <= now_us) {
+            next_us += interval_us;
+            st->overruns++;
+        }
+        st->aligned = false;
+    }
+
+    next_due_us[idx] = next_us;
+}
+
+static void record_jitter(size_t idx, int64_t start_us) {
+    measurement_schedule_stats_t *st = &schedule_stats[idx];
+    int32_t jitter = (int32_t)(start_us - next_due_us[idx]);
+    st->slots++;
+    st->last_jitter_us = jitter;
+    if (jitter > st->max_jitter_us) {
+        st->max_jitter_us = jitter;
+    }
+    st->avg_jitter_us += (jitter - st->avg_jitter_us) / 16;
+}
+
+// Algum sensor está com intervalo estendido pela amostragem adaptativa
+static bool sampling_backed_off(void) {
+    for (size_t i = 0; i < sensor_count; i++) {
+        if (sampling_policy_current(i) > sensor_table[i].interval_ms) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool mqtt_link_up(void) {
+    return (xEventGroupGetBits(system_event_group) & MQTT_CONNECTED_BIT) != 0;
+}
+
+// MQTT voltou: sensores com intervalo estendido amostram já e voltam ao intervalo configurado
+static bool restore_full_rate(int64_t now_us) {
+    bool changed = false;
+    for (size_t i = 0; i < sensor_count; i++) {
+        if (sampling_policy_current(i) > sensor_table[i].interval_ms && next_due_us[i] > now_us) {
+            next_due_us[i] = now_us;
+            changed = true;
+        }
+    }
+    if (changed) {
+        ESP_LOGI(TAG, "MQTT link restored; resuming configured sampling intervals");
+    }
+    return changed;
+}
 
 void measurement_task(void *pvParameters) {
-    measurement_data_t measurement;
     uint8_t mac[6];
-    
+
+    // Escalonar os sensores ao longo do menor intervalo
+    uint32_t min_interval_ms = sensor_table[0].interval_ms;
+    window_stats_init();
+    sampling_policy_init();
+    alarm_rules_init();
+    for (size_t i = 0; i < sensor_count; i++) {
+        sensor_pipeline_init(&pipelines[i], sensor_table[i].type, sensor_table[i].pin);
+        if (sensor_table[i].interval_ms < min_interval_ms) {
+            min_interval_ms = sensor_table[i].interval_ms;
+        }
+    }
+    uint32_t stagger_ms = min_interval_ms / sensor_count;
+    if (stagger_ms < SENSOR_STAGGER_MIN_MS) {
+        stagger_ms = SENSOR_STAGGER_MIN_MS;
+    }
+    for (size_t i = 0; i < sensor_count; i++) {
+        sensor_offset_ms[i] = (i * stagger_ms) % sensor_table[i].interval_ms;
+    }
+
     // Obter MAC address
     esp_wifi_get_mac(WIFI_IF_STA, mac);
 
-    ESP_LOGI(TAG, "Measurement task started. Waiting for time sync (timeout %d s)...", 15);
+    ESP_LOGI(TAG, "Measurement task started (%u sensors, stagger %u ms). Waiting for time sync (timeout %d s)...",
+             (unsigned)sensor_count, stagger_ms, 15);
 
-    // Espera a sincronização do NTP por até 15s; se não ocorrer, continua com uptime timestamps
+    // Espera a sincronização do NTP por até 15s; se não ocorrer, as amostras são resolvidas depois pela âncora do boot
     EventBits_t bits = xEventGroupWaitBits(system_event_group, NTP_SYNCED_BIT, pdFALSE, pdFALSE, pdMS_TO_TICKS(15000));
     if (bits & NTP_SYNCED_BIT) {
         ESP_LOGI(TAG, "Time synced. Starting measurements with Client ID: %s", mqtt_client_id);
     } else {
-        ESP_LOGW(TAG, "Time sync timeout after 15s; starting measurements with uptime-based timestamps");
+        ESP_LOGW(TAG, "Time sync timeout after 15s; timestamps will be resolved once the clock is anchored");
     }
 
     // Measurements will start after NTP sync; mqtt_publish_task
     // will handle sending or storing in SPIFFS when MQTT is unavailable.
 
+    int64_t start_us = esp_timer_get_time();
+    for (size_t i = 0; i < sensor_count; i++) {
+        next_due_us[i] = start_us + (int64_t)sensor_offset_ms[i] * 1000;
+    }
+    int64_t bus_free_us = start_us;
+    const int64_t tick_us = portTICK_PERIOD_MS * 1000;
+
     while (1) {
-        // Sempre gerar medições: usar tempo real quando sincronizado, caso contrário usar uptime em segundos
-        uint32_t ts;
-        time_t current_time = time(NULL);
-        
-        // Validação de sanidade do timestamp
-        bool time_is_sane = (current_time > 1704067200 && current_time < 1893456000); // 2024-2030
-        
-        if (time_synced && time_is_sane) {
-#if USE_LOCAL_TIMESTAMP
-            // Aplicar timezone GMT-3 (subtrair 3 horas do UTC para enviar horário local)
-            struct tm local_tm;
-            localtime_r(&current_time, &local_tm);
-            ts = (uint32_t)mktime(&local_tm);
-            ESP_LOGD(TAG, "Using Local time (GMT-3): %u", ts);
-#else
-            // Usar UTC (padrão recomendado para IoT)
-            ts = (uint32_t)current_time;
-            ESP_LOGD(TAG, "Using UTC time: %u", ts);
-#endif
-            
-            // Log para mostrar diferença UTC vs Local
-            struct tm utc_tm, local_tm;
-            char utc_str[32], local_str[32];
-            gmtime_r(&current_time, &utc_tm);
-            localtime_r(&current_time, &local_tm);
-            strftime(utc_str, sizeof(utc_str), "%H:%M:%S", &utc_tm);
-            strftime(local_str, sizeof(local_str), "%H:%M:%S", &local_tm);
-            
-            ESP_LOGI(TAG, "Timestamp info - UTC: %s, Local: %s, Sent: %u (%s)", 
-                     utc_str, local_str, ts, USE_LOCAL_TIMESTAMP ? "Local" : "UTC");
-        } else {
-            /*
-             * xTaskGetTickCount() returns ticks; to convert to seconds:
-             * uptime_ms = ticks * portTICK_PERIOD_MS
-             * seconds = uptime_ms / 1000
-             */
-            uint32_t uptime_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
-            ts = uptime_ms / 1000U;
-            
-            if (time_synced && !time_is_sane) {
-                ESP_LOGW(TAG, "Time appears to be invalid (%u), using uptime: %u", (uint32_t)current_time, ts);
-            } else {
-                ESP_LOGW(TAG, "Time not synced, using uptime-based timestamp (s since boot): %u", ts);
-            }
+        int64_t now_us = esp_timer_get_time();
+        bool backed_off = sampling_backed_off();
+        if (backed_off && mqtt_link_up() && restore_full_rate(now_us)) {
+            continue;
         }
+        size_t idx = next_sensor();
 
-        // Ler DHT22 físico; se falhar, fazer fallback para simulação
-        float temperature = 0.0f;
-        float humidity = 0.0f;
-        esp_err_t dht_err = dht_read_float_data(DHT_TYPE_AM2301, DHT22_PIN, &humidity, &temperature);
-        if (dht_err != ESP_OK) {
-            // Fallback para simulação (mantém comportamento anterior)
-            ESP_LOGW(TAG, "DHT22 read failed (%s). Falling back to simulated values.", esp_err_to_name(dht_err));
-            temperature = 20.0f + (esp_random() % 100) / 10.0f; // 20-30°C
-            humidity = 40.0f + (esp_random() % 400) / 10.0f;    // 40-80%
-        } else {
-            ESP_LOGI(TAG, "DHT22 read successful: T=%.1f°C, H=%.1f%%", temperature, humidity);
+        // Aguardar o slot do sensor, mantendo o espaçamento mínimo desde a última leitura
+        int64_t due_us = next_due_us[idx];
+        if (bus_free_us > due_us) {
+            due_us = bus_free_us;
         }
-
-        // Preparar medição
-        measurement.timestamp = ts;
-        strcpy(measurement.sensor_id, SENSOR_ID);
-        memcpy(measurement.mac_address, mac, 6);
-        measurement.temperature = temperature;
-        measurement.humidity = humidity;
-        measurement.retry_count = 0;
-        measurement.measurement_id = ++measurement_counter;
-
-        ESP_LOGI(TAG, "New measurement: %.1f°C, %.1f%% (ID: %u, timestamp: %u)", 
-                 temperature, humidity, measurement.measurement_id, ts);
-                 
-        // Validar se timestamp é razoável 
-        time_t current_real_time = time(NULL);
-        if (current_real_time > 1704067200 && ts > 1893456000) { // 2030
-            ESP_LOGW(TAG, "WARNING: Timestamp appears to be in the future: %u (real time: %u)", 
-                     ts, (uint32_t)current_real_time);
+        if (due_us > now_us) {
+            // Arredondar para cima: nunca acordar antes do slot
+            TickType_t wait_ticks = (TickType_t)((due_us - now_us + tick_us - 1) / tick_us);
+            if (backed_off && !mqtt_link_up()) {
+                // Intervalo estendido: acordar antes se o MQTT reconectar e reavaliar
+                xEventGroupWaitBits(system_event_group, MQTT_CONNECTED_BIT, pdFALSE, pdFALSE, wait_ticks);
+                continue;
+            }
+            vTaskDelay(wait_ticks);
         }
 
-        // Enviar para queue (o mqtt_publish_task decide se publica ou grava em SPIFFS)
-        // Verificar se a queue está muito cheia antes de enviar
-    UBaseType_t queue_remaining = uxQueueSpacesAvailable(measurement_queue);
-        
-        if (queue_remaining < 2) {
-            ESP_LOGW(TAG, "Queue almost full (%d remaining)! MQTT publish may be slow", queue_remaining);
-        }
-        
-        if (xQueueSend(measurement_queue, &measurement, pdMS_TO_TICKS(1000)) != pdTRUE) {
-            ESP_LOGE(TAG, "Failed to send measurement to queue - queue may be full!");
-        } else {
-            ESP_LOGI(TAG, "Measurement queued successfully (queue: %d/20 used)", 
-                     uxQueueMessagesWaiting(measurement_queue));
-        }
+        record_jitter(idx, esp_timer_get_time());
+        sample_sensor(idx, mac);
+        // O caminho mais fundo (SPIFFS com o anel cheio, fechamento de janela, alarme)
+        // roda dentro de sample_sensor(): a marca de água já o inclui
+        stack_free = uxTaskGetStackHighWaterMark(NULL);
 
-        // Atualizar variáveis globais
-        g_last_temperature = temperature;
-        g_last_humidity = humidity;
+        now_us = esp_timer_get_time();
+        bus_free_us = now_us + SENSOR_STAGGER_MIN_MS * 1000;
+        schedule_next(idx, now_us);
 
-        // Atualizar última medição global
-        last_measurement = measurement;
-        
         // Monitorar uso de memória após cada medição
         uint32_t free_heap = esp_get_free_heap_size();
         static uint32_t min_heap = UINT32_MAX;
@@ -141,9 +350,11 @@ void measurement_task(void *pvParameters) {
             ESP_LOGD(TAG, "New minimum heap: %u bytes", min_heap);
         }
         if (measurement_counter % 10 == 0) { // Log a cada 10 medições
-            ESP_LOGD(TAG, "Memory status: current=%u, minimum=%u bytes", free_heap, min_heap);
+            ESP_LOGD(TAG, "Memory status: current=%u, minimum=%u bytes, stack free=%u words",
+                     free_heap, min_heap, stack_free);
+            ESP_LOGD(TAG, "%s pipeline: cpu=%u us (max %u us), bus=%u us",
+                     sensor_table[idx].sensor_id, pipelines[idx].stats.cpu_us_last,
+                     pipelines[idx].stats.cpu_us_max, pipelines[idx].stats.bus_us_last);
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(MEASUREMENT_INTERVAL_MS));
     }
 }
@@ -1,12 +1,52 @@
 #ifndef MEASUREMENT_H
 #define MEASUREMENT_H
 
+#include <stddef.h>
 #include "types.h"
+#include "sensor_pipeline.h"
+
+// Estatísticas do agendamento de amostras de um sensor
+typedef struct {
+    uint32_t slots;           // amostras agendadas executadas
+    uint32_t overruns;        // slots perdidos porque a amostra anterior passou do prazo
+    int32_t last_jitter_us;   // atraso do início da última amostra em relação ao slot
+    int32_t max_jitter_us;
+    int32_t avg_jitter_us;    // média móvel (1/16) do atraso
+    bool aligned;             // slots alinhados ao relógio de parede (NTP)
+} measurement_schedule_stats_t;
 
 /**
- * @brief Task de medição (simula sensores)
+ * @brief Task de medição (escalona as leituras dos sensores de sensor_table)
  * @param pvParameters Parâmetros da task (não utilizado)
  */
 void measurement_task(void *pvParameters);
 
+/**
+ * @brief Copia os contadores do pipeline de aquisição de um sensor
+ * @param idx Índice do sensor em sensor_table
+ * @param out Destino dos contadores
+ */
+void measurement_get_pipeline_stats(size_t idx, sensor_pipeline_stats_t *out);
+
+/**
+ * @brief Copia a última medição de um sensor
+ * @param idx Índice do sensor em sensor_table
+ * @param out Destino da medição
+ */
+void measurement_get_sensor_last(size_t idx, measurement_data_t *out);
+
+/**
+ * @brief Copia as estatísticas de agendamento de um sensor
+ * @param idx Índice do sensor em sensor_table
+ * @param out Destino das estatísticas
+ */
+void measurement_get_schedule_stats(size_t idx, measurement_schedule_stats_t *out);
+
+/**
+ * @brief Menor folga de pilha da measurement_task (uxTaskGetStackHighWaterMark) desde o boot
+ *
+ * Atualizada após cada amostra, inclusive as que caíram direto no SPIFFS. 0 antes da primeira.
+ */
+uint32_t measurement_stack_free(void);
+
 #endif // MEASUREMENT_H
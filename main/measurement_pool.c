@@ -0,0 +1,116 @@
+#include "measurement_pool.h"
+#include "globals.h"
+#include "config.h"
+#include <string.h>
+#include "esp_log.h"
+#include "freertos/task.h"
+
+_Static_assert((MEAS_RING_LEN & (MEAS_RING_LEN - 1)) == 0, "MEAS_RING_LEN must be a power of two");
+
+static measurement_data_t pool[MEAS_POOL_SIZE];
+static uint8_t refs[MEAS_POOL_SIZE];
+static uint32_t free_count = MEAS_POOL_SIZE;
+
+/*
+ * Anel SPSC sem lock: head só é escrito pelo produtor e tail só pelo
+ * consumidor (palavras de 32 bits, escrita atômica no lx106 single-core).
+ * A barreira garante que o ponteiro está no slot antes de head avançar.
+ */
+static measurement_data_t *ring[MEAS_RING_LEN];
+static volatile uint32_t ring_head = 0;
+static volatile uint32_t ring_tail = 0;
+static TaskHandle_t ring_consumer = NULL;
+
+#define MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+static int pool_index(const measurement_data_t *record) {
+    if (record < &pool[0] || record >= &pool[MEAS_POOL_SIZE]) {
+        ESP_LOGE(TAG, "Record %p does not belong to the measurement pool", record);
+        return -1;
+    }
+    return (int)(record - pool);
+}
+
+measurement_data_t *meas_pool_alloc(void) {
+    int found = -1;
+    // Sem atômicos no lx106: seção crítica curta (MQTT event task também solta referências)
+    portENTER_CRITICAL();
+    for (int i = 0; i < MEAS_POOL_SIZE; i++) {
+        if (refs[i] == 0) {
+            refs[i] = 1;
+            free_count--;
+            found = i;
+            break;
+        }
+    }
+    portEXIT_CRITICAL();
+
+    if (found < 0) {
+        return NULL;
+    }
+    memset(&pool[found], 0, sizeof(pool[found]));
+    return &pool[found];
+}
+
+void meas_pool_retain(measurement_data_t *record) {
+    int i = pool_index(record);
+    if (i < 0) {
+        return;
+    }
+    portENTER_CRITICAL();
+    refs[i]++;
+    portEXIT_CRITICAL();
+}
+
+void meas_pool_release(measurement_data_t *record) {
+    int i = pool_index(record);
+    if (i < 0) {
+        return;
+    }
+    portENTER_CRITICAL();
+    if (refs[i] > 0 && --refs[i] == 0) {
+        free_count++;
+    }
+    portEXIT_CRITICAL();
+}
+
+uint32_t meas_pool_free_count(void) {
+    return free_count;
+}
+
+bool meas_ring_push(measurement_data_t *record) {
+    uint32_t head = ring_head;
+    if (head - ring_tail >= MEAS_RING_LEN) {
+        return false;
+    }
+    ring[head & (MEAS_RING_LEN - 1)] = record;
+    MEMORY_BARRIER();
+    ring_head = head + 1;
+
+    if (ring_consumer != NULL) {
+        xTaskNotifyGive(ring_consumer);
+    }
+    return true;
+}
+
+bool meas_ring_pop(measurement_data_t **record, TickType_t wait) {
+    if (ring_consumer == NULL) {
+        ring_consumer = xTaskGetCurrentTaskHandle();
+    }
+
+    uint32_t tail = ring_tail;
+    if (ring_head == tail) {
+        if (wait == 0 || ulTaskNotifyTake(pdTRUE, wait) == 0 || ring_head == tail) {
+            return false;
+        }
+    }
+    MEMORY_BARRIER();
+    *record = ring[tail & (MEAS_RING_LEN - 1)];
+    MEMORY_BARRIER();
+    ring_tail = tail + 1;
+    return true;
+}
+
+uint32_t meas_ring_count(void) {
+    return ring_head - ring_tail;
+}
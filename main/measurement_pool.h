@@ -0,0 +1,59 @@
+#ifndef MEASUREMENT_POOL_H
+#define MEASUREMENT_POOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "types.h"
+
+/*
+ * Registros de medição vêm de um pool fixo e circulam por ponteiro:
+ * measurement_task preenche o registro no pool e o passa pelo anel SPSC para a
+ * mqtt_publish_task, que o publica (a fila de pendentes segura uma referência
+ * até o PUBACK) ou o grava no SPIFFS. Cada dono chama meas_pool_release().
+ */
+
+/**
+ * @brief Aloca um registro zerado com uma referência
+ * @return Registro do pool, ou NULL se o pool está esgotado
+ */
+measurement_data_t *meas_pool_alloc(void);
+
+/**
+ * @brief Adiciona uma referência a um registro do pool
+ * @param record Registro obtido de meas_pool_alloc
+ */
+void meas_pool_retain(measurement_data_t *record);
+
+/**
+ * @brief Solta uma referência; o registro volta ao pool na última
+ * @param record Registro obtido de meas_pool_alloc
+ */
+void meas_pool_release(measurement_data_t *record);
+
+/**
+ * @brief Registros livres no pool
+ */
+uint32_t meas_pool_free_count(void);
+
+/**
+ * @brief Enfileira um registro (somente measurement_task); a referência passa para o consumidor
+ * @param record Registro do pool
+ * @return false se o anel está cheio (a referência continua com o produtor)
+ */
+bool meas_ring_push(measurement_data_t *record);
+
+/**
+ * @brief Retira o próximo registro (somente mqtt_publish_task)
+ * @param[out] record Registro retirado; o chamador passa a ser dono da referência
+ * @param wait Tempo máximo de espera com o anel vazio
+ * @return true se um registro foi retirado
+ */
+bool meas_ring_pop(measurement_data_t **record, TickType_t wait);
+
+/**
+ * @brief Registros aguardando no anel
+ */
+uint32_t meas_ring_count(void);
+
+#endif // MEASUREMENT_POOL_H
@@ -3,11 +3,17 @@
 #include "config.h"
 #include "spiffs_manager.h"
 #include "dns_manager.h"
+#include "fixed_point.h"
+#include "window_stats.h"
+#include "measurement_pool.h"
+#include "timebase.h"
+#include "http_server.h"
 #include <time.h>
 #include <stdio.h>
 #include <string.h>
 #include "esp_log.h"
 #include "esp_wifi.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
@@ -37,6 +43,7 @@ static void safe_stop_mqtt_client(void) {
                 if (system_event_group) {
                     xEventGroupClearBits(system_event_group, MQTT_CONNECTED_BIT);
                 }
+                http_events_notify(HTTP_EVT_STATUS);
                 current_state = MQTT_CONNECTING;
                 esp_mqtt_client_stop(mqtt_client);
                 // Do not call esp_mqtt_client_destroy() on ESP8266 — keep handle until
@@ -107,6 +114,71 @@ bool mqtt_throttle_check(void) {
 }
 
 // Callback para eventos MQTT
+// Fila de pendentes: compartilhada entre o handler de eventos MQTT e a mqtt_publish_task
+static void pending_add(int msg_id, measurement_data_t *record, bool is_stored) {
+    // Referência da fila tomada antes de inserir: o PUBACK pode chegar a qualquer momento
+    meas_pool_retain(record);
+    bool added = false;
+    portENTER_CRITICAL();
+    if (mqtt_pending_count < MAX_PENDING_MSGS) {
+        mqtt_pending_t *p = &mqtt_pending_msgs[mqtt_pending_count++];
+        p->msg_id = msg_id;
+        p->measurement = record;
+        p->sent_tick = xTaskGetTickCount();
+        p->is_stored = is_stored;
+        added = true;
+    }
+    portEXIT_CRITICAL();
+    if (!added) {
+        meas_pool_release(record);
+    }
+}
+
+// Remove o pendente de msg_id; o chamador solta a referência de out->measurement
+static bool pending_take(int msg_id, mqtt_pending_t *out) {
+    bool found = false;
+    portENTER_CRITICAL();
+    for (int i = 0; i < mqtt_pending_count; i++) {
+        if (mqtt_pending_msgs[i].msg_id == msg_id) {
+            *out = mqtt_pending_msgs[i];
+            for (int j = i; j < mqtt_pending_count - 1; j++) {
+                mqtt_pending_msgs[j] = mqtt_pending_msgs[j + 1];
+            }
+            mqtt_pending_count--;
+            found = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL();
+    return found;
+}
+
+// Descarta pendentes cujo PUBACK não veio (outbox expirado); sem isso o pool vaza
+static void pending_expire(void) {
+    TickType_t now = xTaskGetTickCount();
+    while (1) {
+        mqtt_pending_t expired;
+        bool found = false;
+        portENTER_CRITICAL();
+        if (mqtt_pending_count > 0 &&
+            (now - mqtt_pending_msgs[0].sent_tick) > pdMS_TO_TICKS(MQTT_PENDING_TIMEOUT_MS)) {
+            expired = mqtt_pending_msgs[0];
+            for (int j = 0; j < mqtt_pending_count - 1; j++) {
+                mqtt_pending_msgs[j] = mqtt_pending_msgs[j + 1];
+            }
+            mqtt_pending_count--;
+            found = true;
+        }
+        portEXIT_CRITICAL();
+        if (!found) {
+            break;
+        }
+        ESP_LOGW(TAG, "No PUBACK for msg_id=%d (measurement ID %u), dropping from pending list",
+                 expired.msg_id, expired.measurement->measurement_id);
+        meas_pool_release(expired.measurement);
+    }
+}
+
 void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data) {
     esp_mqtt_event_handle_t event = event_data;
     esp_mqtt_client_handle_t client = event->client;
@@ -120,6 +192,7 @@ void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event
         ESP_LOGI(TAG, "MQTT Connected successfully with client ID: %s", mqtt_client_id);
         current_state = MQTT_CONNECTED;
         xEventGroupSetBits(system_event_group, MQTT_CONNECTED_BIT);
+        http_events_notify(HTTP_EVT_STATUS);
 
         // Solicitar processamento imediato do backlog armazenado
         xEventGroupSetBits(system_event_group, PROCESS_BACKLOG_BIT);
@@ -140,6 +213,7 @@ void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event
     case MQTT_EVENT_DISCONNECTED:
         ESP_LOGI(TAG, "MQTT Disconnected");
         xEventGroupClearBits(system_event_group, MQTT_CONNECTED_BIT);
+        http_events_notify(HTTP_EVT_STATUS);
         current_state = MQTT_CONNECTING;
         
         // Log possíveis causas da desconexão (informational)
@@ -165,30 +239,24 @@ void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event
         ESP_LOGD(TAG, "MQTT message published, msg_id=%d", event->msg_id);
 
         // Apenas contar mensagens que correspondem a uma medição pendente (assim não contamos status/LWT)
-        bool matched = false;
-        for (int i = 0; i < mqtt_pending_count; i++) {
-            if (mqtt_pending_msgs[i].msg_id == event->msg_id) {
-                matched = true;
-                // Incrementar apenas o total de mensagens confirmadas
-                mqtt_messages_sent++;
-                // Note: mqtt_batch_count já foi incrementado no envio
-
-                ESP_LOGI(TAG, "MQTT_EVENT_PUBLISHED: msg_id=%d confirmed, measurement_id=%u -> mqtt_messages_sent=%d",
-                         event->msg_id, mqtt_pending_msgs[i].measurement.measurement_id, mqtt_messages_sent);
-
-                if (mqtt_pending_msgs[i].is_stored) {
-                    // Nota: A medição já foi removida do SPIFFS antes do envio (nova lógica)
-                    ESP_LOGI(TAG, "Stored measurement confirmed (ID: %u) - already removed from SPIFFS", 
-                             mqtt_pending_msgs[i].measurement.measurement_id);
-                }
-
-                // Remover da fila pendente APENAS após confirmação
-                for (int j = i; j < mqtt_pending_count - 1; j++) {
-                    mqtt_pending_msgs[j] = mqtt_pending_msgs[j+1];
-                }
-                mqtt_pending_count--;
-                break;
+        mqtt_pending_t acked;
+        bool matched = pending_take(event->msg_id, &acked);
+        if (matched) {
+            // Incrementar apenas o total de mensagens confirmadas
+            mqtt_messages_sent++;
+            // Note: mqtt_batch_count já foi incrementado no envio
+
+            ESP_LOGI(TAG, "MQTT_EVENT_PUBLISHED: msg_id=%d confirmed, measurement_id=%u -> mqtt_messages_sent=%d",
+                     event->msg_id, acked.measurement->measurement_id, mqtt_messages_sent);
+
+            if (acked.is_stored) {
+                // Nota: A medição já foi removida do SPIFFS antes do envio (nova lógica)
+                ESP_LOGI(TAG, "Stored measurement confirmed (ID: %u) - already removed from SPIFFS",
+                         acked.measurement->measurement_id);
             }
+
+            // Registro volta ao pool APENAS após confirmação
+            meas_pool_release(acked.measurement);
         }
 
         if (!matched) {
@@ -332,8 +400,53 @@ void mqtt_init(void) {
     ESP_LOGI(TAG, "MQTT client started successfully");
 }
 
+// Boot atual ainda sem âncora: registros aguardam no SPIFFS até o NTP (no máximo TIMEBASE_ANCHOR_WAIT_MS)
+static bool holding_for_anchor(void) {
+    return !timebase_current_anchored() && esp_timer_get_time() / 1000 < TIMEBASE_ANCHOR_WAIT_MS;
+}
+
+// Serializa uma medição no JSON publicado (amostras "missing" publicam null)
+static int format_measurement_json(char *buf, size_t len, const measurement_data_t *m) {
+    char temp_str[12] = "null";
+    char hum_str[12] = "null";
+    if (!(m->quality & MEAS_QUALITY_MISSING)) {
+        fixed_x10_format(temp_str, sizeof(temp_str), m->temperature_x10, "null");
+        fixed_x10_format(hum_str, sizeof(hum_str), m->humidity_x10, "null");
+    }
+    // Epoch resolvido agora pela âncora do boot da amostra
+    char time_json[112];
+    timebase_format_json(time_json, sizeof(time_json), m->boot_id, m->uptime_ms);
+
+    return snprintf(buf, len,
+        "{"
+        "\"client_id\":\"%s\","
+        "\"sensor_id\":\"%s\","
+        "\"mac\":\"%02x:%02x:%02x:%02x:%02x:%02x\","
+        "%s,"
+        "\"temperature\":%s,"
+        "\"humidity\":%s,"
+        "\"quality\":%u,"
+        "\"retries\":%u,"
+        "\"interval_s\":%u,"
+        "\"measurement_id\":%u"
+        "}",
+        mqtt_client_id,
+        m->sensor_id,
+        m->mac_address[0], m->mac_address[1],
+        m->mac_address[2], m->mac_address[3],
+        m->mac_address[4], m->mac_address[5],
+        time_json,
+        temp_str,
+        hum_str,
+        m->quality,
+        m->retry_count,
+        m->interval_s,
+        m->measurement_id
+    );
+}
+
 //  Publicar uma medição via MQTT
-bool mqtt_publish_measurement(const measurement_data_t* measurement) {
+bool mqtt_publish_measurement(measurement_data_t* measurement) {
     if (!mqtt_client || !measurement) {
         return false;
     }
@@ -350,26 +463,7 @@ bool mqtt_publish_measurement(const measurement_data_t* measurement) {
 
     // Criar JSON da medição
     char json_data[512];
-    snprintf(json_data, sizeof(json_data),
-        "{"
-        "\"client_id\":\"%s\","
-        "\"sensor_id\":\"%s\","
-        "\"mac\":\"%02x:%02x:%02x:%02x:%02x:%02x\","
-        "\"timestamp\":%u,"
-        "\"temperature\":%.2f,"
-        "\"humidity\":%.2f,"
-        "\"measurement_id\":%u"
-        "}",
-        mqtt_client_id,
-        measurement->sensor_id,
-        measurement->mac_address[0], measurement->mac_address[1],
-        measurement->mac_address[2], measurement->mac_address[3],
-        measurement->mac_address[4], measurement->mac_address[5],
-        measurement->timestamp,
-        measurement->temperature,
-        measurement->humidity,
-        measurement->measurement_id
-    );
+    format_measurement_json(json_data, sizeof(json_data), measurement);
 
     // Usar QoS 1 para garantir confirmação do broker
     int msg_id = -1;
@@ -391,19 +485,19 @@ bool mqtt_publish_measurement(const measurement_data_t* measurement) {
         // Atualizar timestamp da última atividade MQTT
         last_mqtt_activity_time = xTaskGetTickCount();
         
-        ESP_LOGI(TAG, "Published: %.1f°C, %.1f%%, ID=%u (msg_id=%d, pending=%d)", 
-                 measurement->temperature, measurement->humidity, 
-                 measurement->measurement_id, msg_id, mqtt_pending_count);
+        char temp_str[12] = "--";
+        char hum_str[12] = "--";
+        if (!(measurement->quality & MEAS_QUALITY_MISSING)) {
+            fixed_x10_format(temp_str, sizeof(temp_str), measurement->temperature_x10, "--");
+            fixed_x10_format(hum_str, sizeof(hum_str), measurement->humidity_x10, "--");
+        }
+        ESP_LOGI(TAG, "Published: %s°C, %s%%, ID=%u (msg_id=%d, pending=%d)",
+                 temp_str, hum_str, measurement->measurement_id, msg_id, mqtt_pending_count);
                  
         success = true;
         
-        // Adicionar à fila de pendentes
-        if (mqtt_pending_count < MAX_PENDING_MSGS) {
-            mqtt_pending_msgs[mqtt_pending_count].msg_id = msg_id;
-            mqtt_pending_msgs[mqtt_pending_count].measurement = *measurement;
-            mqtt_pending_msgs[mqtt_pending_count].is_stored = false;
-            mqtt_pending_count++;
-        }
+        // Adicionar à fila de pendentes (segura uma referência até o PUBACK)
+        pending_add(msg_id, measurement, false);
         
         // Delay entre mensagens no batch
         if (mqtt_batch_count < MQTT_BATCH_SIZE) {
@@ -419,9 +513,147 @@ bool mqtt_publish_measurement(const measurement_data_t* measurement) {
     return success;
 }
 
+// Publicar um evento de alarme imediatamente (QoS 1, fora do batch/throttling)
+bool mqtt_publish_alarm(const alarm_event_t *event) {
+    if (!mqtt_client || !event) {
+        return false;
+    }
+
+    char value_str[12], threshold_str[12];
+    fixed_x10_format(value_str, sizeof(value_str), event->value_x10, "null");
+    fixed_x10_format(threshold_str, sizeof(threshold_str), event->threshold_x10, "null");
+
+    char time_json[112];
+    timebase_format_json(time_json, sizeof(time_json), event->boot_id, event->uptime_ms);
+
+    char json_data[384];
+    snprintf(json_data, sizeof(json_data),
+        "{"
+        "\"client_id\":\"%s\","
+        "\"sensor_id\":\"%s\","
+        "%s,"
+        "\"rule\":\"%s\","
+        "\"state\":\"%s\","
+        "\"value\":%s,"
+        "\"threshold\":%s,"
+        "\"event_id\":%u"
+        "}",
+        mqtt_client_id,
+        event->sensor_id,
+        time_json,
+        event->rule,
+        event->raised ? "raised" : "cleared",
+        value_str,
+        threshold_str,
+        event->event_id);
+
+    if (xSemaphoreTake(mqtt_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to take MQTT mutex");
+        return false;
+    }
+
+    int msg_id = -1;
+    if (mqtt_client != NULL) {
+        msg_id = esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_ALARM, json_data, 0, 1, 0);
+    }
+    xSemaphoreGive(mqtt_mutex);
+
+    if (msg_id < 0) {
+        ESP_LOGE(TAG, "Failed to publish alarm event %u, msg_id=%d", event->event_id, msg_id);
+        return false;
+    }
+
+    mqtt_publish_attempts++;
+    last_mqtt_activity_time = xTaskGetTickCount();
+    ESP_LOGI(TAG, "Published alarm %s %s (event %u, msg_id=%d)", event->rule,
+             event->raised ? "raised" : "cleared", event->event_id, msg_id);
+    return true;
+}
+
+// Serializa as estatísticas de uma grandeza ("null" quando a janela não teve valores)
+static int format_channel_json(char *buf, size_t len, const window_channel_summary_t *c) {
+    char min_str[12], max_str[12], mean_str[12], sd_str[12], last_str[12];
+    fixed_x10_format(min_str, sizeof(min_str), c->min, "null");
+    fixed_x10_format(max_str, sizeof(max_str), c->max, "null");
+    fixed_x10_format(mean_str, sizeof(mean_str), c->mean, "null");
+    fixed_x10_format(sd_str, sizeof(sd_str), c->stddev, "null");
+    fixed_x10_format(last_str, sizeof(last_str), c->last, "null");
+    return snprintf(buf, len, "{\"min\":%s,\"max\":%s,\"mean\":%s,\"stddev\":%s,\"last\":%s}",
+                    min_str, max_str, mean_str, sd_str, last_str);
+}
+
+// Publicar o resumo de uma janela (QoS 1, sem rastreamento em mqtt_pending_msgs)
+bool mqtt_publish_summary(const window_summary_t *summary) {
+    if (!mqtt_client || !summary) {
+        return false;
+    }
+
+    char temp_json[96];
+    char hum_json[96];
+    format_channel_json(temp_json, sizeof(temp_json), &summary->temperature);
+    format_channel_json(hum_json, sizeof(hum_json), &summary->humidity);
+
+    char start_str[12] = "null";
+    uint32_t start_ts;
+    if (timebase_to_timestamp(summary->boot_id, summary->start_uptime_ms, &start_ts)) {
+        snprintf(start_str, sizeof(start_str), "%u", start_ts);
+    }
+
+    char json_data[512];
+    snprintf(json_data, sizeof(json_data),
+        "{"
+        "\"client_id\":\"%s\","
+        "\"sensor_id\":\"%s\","
+        "\"window_start\":%s,"
+        "\"boot_id\":%u,"
+        "\"start_uptime_ms\":%u,"
+        "\"window_s\":%u,"
+        "\"samples\":%u,"
+        "\"count\":%u,"
+        "\"quality\":%u,"
+        "\"temperature\":%s,"
+        "\"humidity\":%s,"
+        "\"measurement_id\":%u"
+        "}",
+        mqtt_client_id,
+        summary->sensor_id,
+        start_str,
+        summary->boot_id,
+        summary->start_uptime_ms,
+        summary->length_s,
+        summary->samples,
+        summary->count,
+        summary->quality,
+        temp_json,
+        hum_json,
+        summary->measurement_id);
+
+    if (xSemaphoreTake(mqtt_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to take MQTT mutex");
+        return false;
+    }
+
+    int msg_id = -1;
+    if (mqtt_client != NULL) {
+        msg_id = esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_SUMMARY, json_data, 0, 1, 0);
+    }
+    xSemaphoreGive(mqtt_mutex);
+
+    if (msg_id < 0) {
+        ESP_LOGE(TAG, "Failed to publish window summary, msg_id=%d", msg_id);
+        return false;
+    }
+
+    mqtt_publish_attempts++;
+    last_mqtt_activity_time = xTaskGetTickCount();
+    ESP_LOGI(TAG, "Published %us summary of %s (ID=%u, msg_id=%d)",
+             summary->length_s, summary->sensor_id, summary->measurement_id, msg_id);
+    return true;
+}
+
 //  Tarefa principal de publicação MQTT
 void mqtt_publish_task(void *pvParameters) {
-    measurement_data_t measurement;
+    measurement_data_t *measurement;
     bool mqtt_connected = false;
     bool processing_spiffs = false;
     uint32_t failed_publishes = 0;
@@ -454,77 +686,97 @@ void mqtt_publish_task(void *pvParameters) {
             }
         }
 
-        // === PRIORIDADE 1: NOVAS MEDIÇÕES (sempre interrompem SPIFFS) ===
-        if (xQueuePeek(measurement_queue, &measurement, pdMS_TO_TICKS(10)) == pdTRUE) {
-            xQueueReceive(measurement_queue, &measurement, 0); // Remove da queue
-            
+        // Soltar registros cujo PUBACK nunca chegou
+        pending_expire();
 
+        // === PRIORIDADE 0: ALARMES (sem batch; offline vão para o backlog de alarmes) ===
+        alarm_event_t alarm;
+        if (alarm_queue != NULL && xQueueReceive(alarm_queue, &alarm, 0) == pdTRUE) {
+            // Eventos guardados saem antes, para manter a ordem disparo/normalização
+            if (spiffs_alarm_count() > 0 || !mqtt_connected || !mqtt_publish_alarm(&alarm)) {
+                spiffs_store_alarm(&alarm);
+            }
+            continue;
+        }
+        if (mqtt_connected && spiffs_alarm_count() > 0) {
+            if (spiffs_peek_alarm(&alarm) == ESP_OK && mqtt_publish_alarm(&alarm)) {
+                spiffs_remove_alarm();
+                continue;
+            }
+        }
+
+        // === PRIORIDADE 1: NOVAS MEDIÇÕES (sempre interrompem SPIFFS) ===
+        if (meas_ring_pop(&measurement, pdMS_TO_TICKS(10))) {
             // Interromper processamento SPIFFS se estiver ativo
             if (processing_spiffs) {
                 processing_spiffs = false;
                 ESP_LOGI(TAG, "SPIFFS processing interrupted by new measurement ID %u", 
-                         measurement.measurement_id);
+                         measurement->measurement_id);
             }
             
-            if (mqtt_connected) {
+            if (mqtt_connected && holding_for_anchor()) {
+                // Horário ainda não resolvível: o drain publica depois da âncora
+                ESP_LOGD(TAG, "Clock not anchored yet, storing measurement ID %u in SPIFFS",
+                         measurement->measurement_id);
+                spiffs_store_measurement(measurement);
+            } else if (mqtt_connected) {
                 // MQTT disponível - tentar envio direto
-                if (mqtt_publish_measurement(&measurement)) {
+                if (mqtt_publish_measurement(measurement)) {
                     ESP_LOGI(TAG, "New measurement sent directly (ID: %u, batch_count: %d)", 
-                             measurement.measurement_id, mqtt_batch_count);
+                             measurement->measurement_id, mqtt_batch_count);
                 } else {
                     // Falha no envio - armazenar em SPIFFS
                     ESP_LOGW(TAG, "Failed to send new measurement ID %u, storing in SPIFFS", 
-                             measurement.measurement_id);
-                    spiffs_store_measurement(&measurement);
+                             measurement->measurement_id);
+                    spiffs_store_measurement(measurement);
                     failed_publishes++;
                 }
             } else {
                 // MQTT indisponível - armazenar em SPIFFS
                 ESP_LOGD(TAG, "MQTT not available, storing measurement ID %u in SPIFFS", 
-                         measurement.measurement_id);
-                spiffs_store_measurement(&measurement);
+                         measurement->measurement_id);
+                spiffs_store_measurement(measurement);
             }
+            // Referência do anel: publicado (pendentes seguram a sua) ou persistido
+            meas_pool_release(measurement);
             continue; // Verificar imediatamente se há mais medições novas
         }
 
+        // === PRIORIDADE 1b: RESUMOS DE JANELA ===
+        window_summary_t summary;
+        if (summary_queue != NULL && xQueueReceive(summary_queue, &summary, 0) == pdTRUE) {
+            bool published = mqtt_connected && mqtt_publish_summary(&summary);
+            if (!published && summary.store_offline) {
+                // Modo somente-resumo: a média da janela substitui as amostras no backlog
+                measurement_data_t record;
+                window_stats_to_record(&summary, &record);
+                ESP_LOGD(TAG, "MQTT not available, storing %us aggregate of %s in SPIFFS (ID %u)",
+                         summary.length_s, summary.sensor_id, summary.measurement_id);
+                spiffs_store_measurement(&record);
+            } else if (!published) {
+                ESP_LOGD(TAG, "MQTT not available, %us summary of %s discarded",
+                         summary.length_s, summary.sensor_id);
+            }
+            continue;
+        }
+
         // === PRIORIDADE 2: PROCESSAR SPIFFS (apenas quando MQTT disponível e sem novas medições) ===
-        if (mqtt_connected && ring_idx.count > 0 && !processing_spiffs) {
+        if (mqtt_connected && ring_idx.count > 0 && !processing_spiffs && !holding_for_anchor()) {
             processing_spiffs = true;
             ESP_LOGI(TAG, "Starting SPIFFS processing (%d messages pending)", ring_idx.count);
         }
 
         if (processing_spiffs && mqtt_connected && ring_idx.count > 0) {
-            // Verificar throttling apenas para SPIFFS
-            if (mqtt_throttle_check()) {
-                measurement_data_t stored_measurement;
-                
+            // Throttling apenas para SPIFFS; com o pool esgotado, aguardar PUBACKs
+            measurement_data_t *stored_measurement = mqtt_throttle_check() ? meas_pool_alloc() : NULL;
+            if (stored_measurement != NULL) {
                 // Obter e remover medição do SPIFFS
-                if (spiffs_get_and_remove_next_measurement(&stored_measurement) == ESP_OK) {
-                    ESP_LOGI(TAG, "Sending stored measurement (ID: %u)", stored_measurement.measurement_id);
+                if (spiffs_get_and_remove_next_measurement(stored_measurement) == ESP_OK) {
+                    ESP_LOGI(TAG, "Sending stored measurement (ID: %u)", stored_measurement->measurement_id);
                     
                     // Criar JSON para medição armazenada
                     char json_data[512];
-                    
-                    snprintf(json_data, sizeof(json_data),
-                        "{"
-                        "\"client_id\":\"%s\","
-                        "\"sensor_id\":\"%s\","
-                        "\"mac\":\"%02x:%02x:%02x:%02x:%02x:%02x\","
-                        "\"timestamp\":%u,"
-                        "\"temperature\":%.2f,"
-                        "\"humidity\":%.2f,"
-                        "\"measurement_id\":%u"
-                        "}",
-                        mqtt_client_id,
-                        stored_measurement.sensor_id,
-                        stored_measurement.mac_address[0], stored_measurement.mac_address[1],
-                        stored_measurement.mac_address[2], stored_measurement.mac_address[3],
-                        stored_measurement.mac_address[4], stored_measurement.mac_address[5],
-                        stored_measurement.timestamp,
-                        stored_measurement.temperature,
-                        stored_measurement.humidity,
-                        stored_measurement.measurement_id
-                    );
+                    format_measurement_json(json_data, sizeof(json_data), stored_measurement);
                     
                     // Enviar via MQTT
                     int msg_id = -1;
@@ -548,21 +800,16 @@ void mqtt_publish_task(void *pvParameters) {
                         }
                         
                         // Adicionar à fila de pendentes para confirmação
-                        if (mqtt_pending_count < MAX_PENDING_MSGS) {
-                            mqtt_pending_msgs[mqtt_pending_count].msg_id = msg_id;
-                            mqtt_pending_msgs[mqtt_pending_count].measurement = stored_measurement;
-                            mqtt_pending_msgs[mqtt_pending_count].is_stored = true;
-                            mqtt_pending_count++;
-                            stored_sent++;
-                        }
+                        pending_add(msg_id, stored_measurement, true);
+                        stored_sent++;
                         
                         ESP_LOGI(TAG, "Stored measurement sent, awaiting confirmation (ID: %u)", 
-                                stored_measurement.measurement_id);
+                                stored_measurement->measurement_id);
                     } else {
                         // Falha no envio - fazer rollback para SPIFFS
                         ESP_LOGW(TAG, "Failed to send stored measurement, rolling back to SPIFFS");
-                        if (spiffs_rollback_measurement(&stored_measurement) != ESP_OK) {
-                            ESP_LOGE(TAG, "Failed to rollback measurement ID %u", stored_measurement.measurement_id);
+                        if (spiffs_rollback_measurement(stored_measurement) != ESP_OK) {
+                            ESP_LOGE(TAG, "Failed to rollback measurement ID %u", stored_measurement->measurement_id);
                         }
                     }
                 } else {
@@ -570,6 +817,7 @@ void mqtt_publish_task(void *pvParameters) {
                     processing_spiffs = false;
                     ESP_LOGI(TAG, "SPIFFS processing completed - no more stored messages");
                 }
+                meas_pool_release(stored_measurement);
             }
         }
 
@@ -742,6 +990,7 @@ void mqtt_monitor_task(void *pvParameters) {
                     // Força o gatilho de recriação e limpa o bit de conexão
                     force_recreate = true;
                     xEventGroupClearBits(system_event_group, MQTT_CONNECTED_BIT);
+                    http_events_notify(HTTP_EVT_STATUS);
 
                     // Reseta o contador de falhas para iniciar um ciclo de recriação limpo
                     consecutive_failures = 0; 
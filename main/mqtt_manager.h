@@ -39,10 +39,27 @@ void mqtt_init(void);
 
 /**
  * @brief Publica uma medição MQTT
- * @param measurement Ponteiro para a medição a ser publicada
+ *
+ * A fila de pendentes toma uma referência própria até o PUBACK; a referência
+ * do chamador não é consumida.
+ * @param measurement Registro de measurement_pool a ser publicado
  * @return true se sucesso, false caso contrário
  */
-bool mqtt_publish_measurement(const measurement_data_t* measurement);
+bool mqtt_publish_measurement(measurement_data_t* measurement);
+
+/**
+ * @brief Publica um evento de alarme em MQTT_TOPIC_ALARM, sem batch/throttling
+ * @param event Evento gerado por alarm_rules
+ * @return true se sucesso, false caso contrário
+ */
+bool mqtt_publish_alarm(const alarm_event_t *event);
+
+/**
+ * @brief Publica o resumo estatístico de uma janela em MQTT_TOPIC_SUMMARY
+ * @param summary Resumo gerado por window_stats
+ * @return true se sucesso, false caso contrário
+ */
+bool mqtt_publish_summary(const window_summary_t *summary);
 
 /**
  * @brief Task de publicação MQTT com throttling
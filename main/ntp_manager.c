@@ -15,6 +15,9 @@
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
 #include "time_cache.h"
+#include "timebase.h"
+#include "oled_display.h"
+#include "http_server.h"
 
 void time_sync_notification_cb(struct timeval *tv) {
     static int sync_count = 0;
@@ -31,7 +34,13 @@ void time_sync_notification_cb(struct timeval *tv) {
     
     time_synced = true;
     current_state = NTP_SYNCED;
-    xEventGroupSetBits(system_event_group, NTP_SYNCED_BIT);
+    // Âncora do boot: amostras anteriores ao sync passam a ter horário resolvível. Este
+    // callback roda na thread tcpip: a gravação no NVS fica para a task NTP
+    timebase_anchor();
+    xEventGroupSetBits(system_event_group, NTP_SYNCED_BIT | NTP_PERSIST_BIT);
+    // Relógio saltou: display redesenha a hora e realinha o tick ao novo segundo
+    oled_display_notify(OLED_EVT_TICK | OLED_EVT_CONNECTIVITY);
+    http_events_notify(HTTP_EVT_STATUS);
     
     // Primeira sincronização: sinalizar para processar backlog armazenado (SPIFFS)
     if (sync_count == 1) {
@@ -41,8 +50,17 @@ void time_sync_notification_cb(struct timeval *tv) {
         // O client ID já foi gerado na inicialização e deve permanecer o mesmo
         ESP_LOGI(TAG, "NTP synchronized, keeping existing client ID: %s", mqtt_client_id);
     }
-    
+}
+
+// Grava no NVS o que o callback do SNTP deixou pendente (fora da thread tcpip)
+static void persist_sync(void) {
+    if (!(xEventGroupClearBits(system_event_group, NTP_PERSIST_BIT) & NTP_PERSIST_BIT)) {
+        return;
+    }
+    timebase_save();
+
     // Save synchronized time to NVS for next boot fallback
+    time_t now = time(NULL);
     if (now > 100000) {
         esp_err_t e = time_cache_save(now);
         if (e != ESP_OK) {
@@ -53,6 +71,17 @@ void time_sync_notification_cb(struct timeval *tv) {
     }
 }
 
+// vTaskDelay que acorda para gravar cada sincronização NTP assim que ela acontece
+static void wait_persisting(TickType_t ticks) {
+    TickType_t start = xTaskGetTickCount();
+    TickType_t waited = 0;
+    while (waited < ticks) {
+        xEventGroupWaitBits(system_event_group, NTP_PERSIST_BIT, pdFALSE, pdFALSE, ticks - waited);
+        persist_sync();
+        waited = xTaskGetTickCount() - start;
+    }
+}
+
 void ntp_init(void) {
     ESP_LOGI(TAG, "Initializing NTP with Brazilian servers...");
 
@@ -242,6 +271,7 @@ void ntp_sync_task(void *pvParameters) {
                 localtime_r(&now, &timeinfo);
                 strftime(strftime_buf, sizeof(strftime_buf), "%c", &timeinfo);
                 ESP_LOGI(TAG, "Time synchronized: %s", strftime_buf);
+                persist_sync();
 
                 // Mark global flag so we don't re-enter the wait/log loop repeatedly.
                 // The SNTP callback also sets this, but the event bit may be set
@@ -270,7 +300,7 @@ void ntp_sync_task(void *pvParameters) {
             
             while (time_synced) {
                 // Aguardar intervalo de monitoramento
-                vTaskDelay(monitor_interval);
+                wait_persisting(monitor_interval);
                 
                 // Verificar se WiFi ainda está conectado
                 EventBits_t wifi_bits = xEventGroupGetBits(wifi_event_group);
@@ -298,6 +328,6 @@ void ntp_sync_task(void *pvParameters) {
         }
 
         // Small delay to allow other tasks; actual waits above control pacing
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        wait_persisting(pdMS_TO_TICKS(1000));
     }
 }
@@ -2,305 +2,501 @@
 #include "globals.h"
 #include "config.h"
 #include "ntp_manager.h"
+#include "fixed_point.h"
+#include "oled_ui.h"
+#include "oled_screen.h"
+#include "oled_trend.h"
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
 #include <stdatomic.h>
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/soc.h"
 #include "ssd1306.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <sys/time.h>
 
-static void draw_wifi_icon(void) {
-    int x = SCREEN_WIDTH - 14;
-    int y = 2;
+static oled_display_stats_t display_stats;
+static TaskHandle_t render_task = NULL;
+static TaskHandle_t flush_task = NULL;
+// Protege o framebuffer sombra e o barramento entre renderização e envio
+static SemaphoreHandle_t display_mutex = NULL;
+static esp_timer_handle_t tick_timer = NULL;
+static esp_timer_handle_t blink_timer = NULL;
+static esp_timer_handle_t screen_timer = NULL;
+static esp_timer_handle_t scroll_timer = NULL;
+static esp_timer_handle_t shift_timer = NULL;
+static esp_timer_handle_t idle_timer = NULL;
+// Scroll de hardware em andamento: GDRAM não pode ser escrita (protegido por display_mutex)
+static bool scrolling = false;
+static int64_t scroll_start_us = 0;
+// Painel desligado por inatividade: nada é renderizado nem enviado (protegido por display_mutex)
+static bool panel_off = false;
+// Início do período ligado/desligado ainda não somado em on_us/off_us (0 antes da task)
+static int64_t power_since_us = 0;
 
-    ssd1306_drawLine(x+6, y+8, x+8, y+8);
-    ssd1306_drawLine(x+4, y+6, x+10, y+6);
-    ssd1306_drawLine(x+2, y+4, x+12, y+4);
-    ssd1306_putPixel(x+7, y+10);
+void oled_display_get_stats(oled_display_stats_t *out) {
+    *out = display_stats;
+    if (power_since_us != 0) {
+        uint64_t open_us = esp_timer_get_time() - power_since_us;
+        if (out->panel_on) {
+            out->on_us += open_us;
+        } else {
+            out->off_us += open_us;
+        }
+    }
+    uint64_t on_ms = out->on_us / 1000;
+    out->bytes_skipped_est = on_ms ? (uint32_t)((uint64_t)out->bytes_total * (out->off_us / 1000) / on_ms) : 0;
+}
+
+void oled_display_notify(uint32_t events) {
+    if (render_task != NULL) {
+        xTaskNotify(render_task, events, eSetBits);
+    }
+}
+
+static void tick_timer_cb(void *arg) {
+    oled_display_notify(OLED_EVT_TICK);
+}
+
+static void blink_timer_cb(void *arg) {
+    oled_display_notify(OLED_EVT_BLINK_END);
+}
+
+static void screen_timer_cb(void *arg) {
+    oled_display_notify(OLED_EVT_SCREEN);
+}
+
+static void scroll_timer_cb(void *arg) {
+    oled_display_notify(OLED_EVT_SCROLL_END);
+}
+
+static void shift_timer_cb(void *arg) {
+    oled_display_notify(OLED_EVT_SHIFT);
+}
+
+static void idle_timer_cb(void *arg) {
+    oled_display_notify(OLED_EVT_IDLE);
+}
+
+// Próximo tick na virada do segundo do relógio, para o display não pular segundos
+static void schedule_tick(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    esp_timer_stop(tick_timer);
+    esp_timer_start_once(tick_timer, 1000000 - tv.tv_usec);
+}
+
+static void update_us_stats(uint32_t us, uint32_t *last, uint32_t *max, uint64_t *total) {
+    *last = us;
+    *total += us;
+    if (us > *max) {
+        *max = us;
+    }
+}
+
+// Envia as alterações do framebuffer sombra e contabiliza o tráfego I2C do quadro
+static void display_flush(void) {
+    int64_t t0 = esp_timer_get_time();
+    ssd1306_flush();
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+
+    SSD1306BusStats bus;
+    ssd1306_getBusStats(&bus, 1);
+    display_stats.frames++;
+    update_us_stats(us, &display_stats.flush_us_last, &display_stats.flush_us_max, &display_stats.flush_us_total);
+    display_stats.bytes_last = bus.bytes;
+    display_stats.bytes_total += bus.bytes;
+    display_stats.transactions_last = bus.transactions;
+    display_stats.transactions_total += bus.transactions;
+    if (bus.bytes > display_stats.bytes_max) {
+        display_stats.bytes_max = bus.bytes;
+    }
+    if (bus.transactions > display_stats.transactions_max) {
+        display_stats.transactions_max = bus.transactions;
+    }
+    if (bus.bytes > 0) {
+        ESP_LOGD(TAG, "OLED frame %u: %u I2C bytes, %u transactions, %u us", display_stats.frames,
+                 bus.bytes, bus.transactions, us);
+    }
+}
+
+// Vazão do barramento: tempo de uma escrita completa de 128x64 (antes do framebuffer sombra)
+static void display_benchmark(void) {
+    SSD1306BusStats bus;
+    const ssd1306_static_driver_t *driver = ssd1306_getStaticDriver();
+    if (driver != NULL) {
+        ssd1306_setStaticDriver(NULL);
+        uint32_t start = soc_get_ccount();
+        ssd1306_clearScreen();
+        display_stats.refresh_cycles_runtime = soc_get_ccount() - start;
+        ssd1306_setStaticDriver(driver);
+    }
+    ssd1306_getBusStats(&bus, 1);
+    int64_t t0 = esp_timer_get_time();
+    uint32_t start = soc_get_ccount();
+    ssd1306_clearScreen();
+    uint32_t cycles = soc_get_ccount() - start;
+    display_stats.refresh_us = (uint32_t)(esp_timer_get_time() - t0);
+    if (driver != NULL) {
+        display_stats.refresh_cycles_static = cycles;
+        ESP_LOGI(TAG, "OLED full refresh cycles: %u with per-byte dispatch, %u with static driver",
+                 display_stats.refresh_cycles_runtime, display_stats.refresh_cycles_static);
+    }
+    ssd1306_getBusStats(&bus, 1);
+    display_stats.refresh_bytes = bus.bytes;
+    display_stats.refresh_transactions = bus.transactions;
+
+    // Bits no fio: endereço + bytes, 9 clocks cada (8 bits + ACK)
+    uint32_t us = display_stats.refresh_us ? display_stats.refresh_us : 1;
+    ESP_LOGI(TAG, "OLED full refresh: %u us, %u bytes in %u transactions, %u bytes/s (~%u kHz SCL)",
+             us, bus.bytes, bus.transactions,
+             (uint32_t)((uint64_t)bus.bytes * 1000000U / us),
+             (uint32_t)((uint64_t)(bus.bytes + bus.transactions) * 9U * 1000U / us));
+}
+
+// Custo de CPU por dígito grande (8x16 em FONT_SIZE_2X), escrevendo só no framebuffer sombra:
+// escala bit a bit em tempo de execução vs. glifos pré-escalados do cache
+static uint32_t digit_cycles(uint8_t cache) {
+    static const char digits[] = "0123456789";
+    ssd1306_setGlyphCache(cache);
+    ssd1306_setFixedFont(ssd1306xled_font8x16);
+    ssd1306_printFixedN(0, 16, digits, STYLE_NORMAL, FONT_SIZE_2X);   // monta o cache fora da medição
+    uint32_t start = soc_get_ccount();
+    for (int r = 0; r < OLED_GLYPH_BENCH_REPS; r++) {
+        ssd1306_printFixedN(0, 16, digits, STYLE_NORMAL, FONT_SIZE_2X);
+    }
+    return (soc_get_ccount() - start) / (OLED_GLYPH_BENCH_REPS * (sizeof(digits) - 1));
+}
+
+static void display_glyph_benchmark(void) {
+    display_stats.digit_cycles_scaled = digit_cycles(0);
+    display_stats.digit_cycles_cached = digit_cycles(1);
+    ESP_LOGI(TAG, "OLED 2x digit: %u cycles scaled at runtime, %u cycles from glyph cache",
+             display_stats.digit_cycles_scaled, display_stats.digit_cycles_cached);
+}
+
+// Contraste do horário local; sem relógio sincronizado vale o contraste normal
+static uint8_t scheduled_contrast(const struct tm *now, bool synced) {
+    if (!synced || OLED_DIM_START_HOUR == OLED_DIM_END_HOUR) {
+        return OLED_CONTRAST_DAY;
+    }
+    bool dim = OLED_DIM_START_HOUR < OLED_DIM_END_HOUR
+                   ? now->tm_hour >= OLED_DIM_START_HOUR && now->tm_hour < OLED_DIM_END_HOUR
+                   : now->tm_hour >= OLED_DIM_START_HOUR || now->tm_hour < OLED_DIM_END_HOUR;
+    return dim ? OLED_CONTRAST_NIGHT : OLED_CONTRAST_DAY;
+}
+
+static void set_contrast(uint8_t contrast) {
+    if (contrast != display_stats.contrast) {
+        ssd1306_setContrast(contrast);
+        display_stats.contrast = contrast;
+        ESP_LOGI(TAG, "OLED contrast %u", contrast);
+    }
+}
+
+// Soma o período ligado/desligado que termina agora
+static void power_account(void) {
+    int64_t now = esp_timer_get_time();
+    if (panel_off) {
+        display_stats.off_us += now - power_since_us;
+    } else {
+        display_stats.on_us += now - power_since_us;
+    }
+    power_since_us = now;
+}
+
+// Valor que andou pelo menos delta desde a referência (referência inválida: qualquer valor válido)
+static bool value_moved(int16_t ref, int16_t cur, int16_t delta) {
+    if (cur == MEAS_VALUE_INVALID) {
+        return false;
+    }
+    return ref == MEAS_VALUE_INVALID || cur - ref >= delta || ref - cur >= delta;
 }
 
-static void clear_wifi_icon(void) {
-    int x = SCREEN_WIDTH - 14;
-    int y = 2;
-    // Limpar área do ícone: ocupa cerca de 14x12 pixels
-    ssd1306_setColor(0);
-    ssd1306_fillRect(x - 1, y - 1, x + 14, y + 12);
-    ssd1306_setColor(1);
+static void restart_idle_timer(void) {
+    if (OLED_IDLE_OFF_S > 0) {
+        esp_timer_stop(idle_timer);
+        esp_timer_start_once(idle_timer, OLED_IDLE_OFF_S * 1000000ULL);
+    }
 }
 
-void draw_degree_symbol(int x, int y) {
-    // Desenhar um círculo pequeno de raio 2 pixels para o símbolo °
-    ssd1306_putPixel(x+1, y);     // topo
-    ssd1306_putPixel(x, y+1);     // esquerda
-    ssd1306_putPixel(x+2, y+1);   // direita
-    ssd1306_putPixel(x+1, y+2);   // baixo
+// Desliga o painel e para os timers que gerariam renderizações
+static void panel_power_off(void) {
+    ssd1306_displayOff();
+    esp_timer_stop(tick_timer);
+    esp_timer_stop(blink_timer);
+    esp_timer_stop(screen_timer);
+    esp_timer_stop(shift_timer);
+    oled_screen_set_notify(false);
+    power_account();
+    panel_off = true;
+    display_stats.panel_on = false;
+    display_stats.power_offs++;
+    ESP_LOGI(TAG, "OLED off after %u s without activity", (unsigned)OLED_IDLE_OFF_S);
 }
 
-void draw_notify_icon(void) {
-    int x = SCREEN_WIDTH  - 12; // Canto inferior direito
-    int y = SCREEN_HEIGHT - 25; // Próximo da borda inferior
-    
-    // Desenhar um sino simples (8x8 pixels)
-    // Linha superior do sino
-    ssd1306_putPixel(x+3, y);
-    ssd1306_putPixel(x+4, y);
-    
-    // Corpo do sino (formato de sino)
-    ssd1306_putPixel(x+2, y+1);
-    ssd1306_putPixel(x+5, y+1);
-    
-    ssd1306_putPixel(x+1, y+2);
-    ssd1306_putPixel(x+6, y+2);
-    
-    ssd1306_putPixel(x+1, y+3);
-    ssd1306_putPixel(x+6, y+3);
-    
-    ssd1306_putPixel(x+1, y+4);
-    ssd1306_putPixel(x+6, y+4);
-    
-    // Base do sino
-    ssd1306_putPixel(x, y+5);
-    ssd1306_putPixel(x+1, y+5);
-    ssd1306_putPixel(x+2, y+5);
-    ssd1306_putPixel(x+3, y+5);
-    ssd1306_putPixel(x+4, y+5);
-    ssd1306_putPixel(x+5, y+5);
-    ssd1306_putPixel(x+6, y+5);
-    ssd1306_putPixel(x+7, y+5);
-    
-    // Badalo do sino
-    ssd1306_putPixel(x+3, y+6);
-    ssd1306_putPixel(x+4, y+6);
+// localtime_r só quando o minuto vira (ou o relógio salta); entre viradas basta avançar os segundos
+static void clock_now(struct tm *out) {
+    static time_t last = 0;
+    static struct tm cached;
+    time_t now = time(NULL);
+    if (last != 0 && now >= last && cached.tm_sec + (now - last) < 60) {
+        cached.tm_sec += now - last;
+    } else {
+        localtime_r(&now, &cached);
+    }
+    last = now;
+    *out = cached;
 }
 
-void clear_notify_icon(void) {
-    int x = SCREEN_WIDTH  - 12; // Mesma posição do desenho
-    int y = SCREEN_HEIGHT - 25;
-    
-    // Usar fillRect para desenhar retângulo preto (apagar)
-    ssd1306_setColor(0); // Cor preta/apagado
-    ssd1306_fillRect(x, y, x + 8, y + 8); // Área do sino (8x8 pixels)
-    ssd1306_setColor(1); // Voltar cor branca para outros desenhos
+void oled_display_init(void) {
+    display_mutex = xSemaphoreCreateMutex();
+    const esp_timer_create_args_t tick_args = { .callback = tick_timer_cb, .name = "oled_tick" };
+    const esp_timer_create_args_t blink_args = { .callback = blink_timer_cb, .name = "oled_blink" };
+    const esp_timer_create_args_t screen_args = { .callback = screen_timer_cb, .name = "oled_screen" };
+    const esp_timer_create_args_t scroll_args = { .callback = scroll_timer_cb, .name = "oled_scroll" };
+    const esp_timer_create_args_t shift_args = { .callback = shift_timer_cb, .name = "oled_shift" };
+    const esp_timer_create_args_t idle_args = { .callback = idle_timer_cb, .name = "oled_idle" };
+    if (display_mutex == NULL || esp_timer_create(&tick_args, &tick_timer) != ESP_OK ||
+        esp_timer_create(&blink_args, &blink_timer) != ESP_OK ||
+        esp_timer_create(&screen_args, &screen_timer) != ESP_OK ||
+        esp_timer_create(&scroll_args, &scroll_timer) != ESP_OK ||
+        esp_timer_create(&shift_args, &shift_timer) != ESP_OK ||
+        esp_timer_create(&idle_args, &idle_timer) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create OLED display mutex/timers");
+    }
 }
 
 void oled_display_task(void *pvParameter) {
-    static float prev_temp = -99.0f;
-    static float prev_umid = -99.0f;
-    static char prev_time_str[64] = "";
+    int16_t prev_temp = MEAS_VALUE_INVALID;
+    int16_t prev_umid = MEAS_VALUE_INVALID;
+    // Valores da última atividade: mudança além de OLED_WAKE_*_DELTA_X10 conta como atividade
+    int16_t wake_temp = MEAS_VALUE_INVALID;
+    int16_t wake_umid = MEAS_VALUE_INVALID;
+    bool trend_screen = false;
+    uint32_t deferred = 0;
 
-    TickType_t last_wake = xTaskGetTickCount();
-    
+    xSemaphoreTake(display_mutex, portMAX_DELAY);
+    // Contadores antes do framebuffer sombra: contam o tráfego real do barramento
+    ssd1306_enableBusStats();
+    display_benchmark();
+    display_stats.shadow = OLED_SHADOW_BUFFER_ENABLED && ssd1306_enableShadowBuffer() == 0;
+    ESP_LOGI(TAG, "OLED drawing %s", display_stats.shadow ? "through shadow framebuffer" : "directly to display");
+    if (display_stats.shadow) {
+        // Sem framebuffer sombra a medida seria dominada pelo barramento
+        display_glyph_benchmark();
+    }
     ssd1306_clearScreen();
-    // Estado local do ícone WiFi: -1=unknown,0=off,1=on
-    int wifi_icon_state = -1;
-    
+    oled_screen_init();
+    // Sai da sequência de inicialização com 0x7F; o horário só é conhecido após o NTP
+    display_stats.contrast = 0x7F;
+    set_contrast(OLED_CONTRAST_DAY);
+    display_stats.panel_on = true;
+    power_since_us = esp_timer_get_time();
+    xSemaphoreGive(display_mutex);
+
+    render_task = xTaskGetCurrentTaskHandle();
+    schedule_tick();
+    if (OLED_TREND_SCREEN_S > 0) {
+        esp_timer_start_once(screen_timer, OLED_MAIN_SCREEN_S * 1000000ULL);
+    }
+    if (OLED_BURNIN_SHIFT_PX > 0) {
+        esp_timer_start_periodic(shift_timer, OLED_BURNIN_PERIOD_S * 1000000ULL);
+    }
+    restart_idle_timer();
+    uint8_t shift_step = 0;
+    uint32_t events = OLED_EVT_TICK | OLED_EVT_MEASUREMENT | OLED_EVT_CONNECTIVITY;
+
     while (1) {
-        static int last_sync_state = -1;
-        int sync_state = is_time_synced() ? 1 : 0;
-
-        if (sync_state != last_sync_state) {
-            if (sync_state == 0) {
-                ssd1306_setFixedFont(ssd1306xled_font6x8);
-                ssd1306_setColor(1);
-                ssd1306_printFixed(10, 25, "Inicializando...", STYLE_NORMAL);
+        int64_t t0 = esp_timer_get_time();
+        xSemaphoreTake(display_mutex, portMAX_DELAY);
+
+        if (events & OLED_EVT_SCROLL_END) {
+            oled_trend_scroll_end();
+            scrolling = false;
+            display_stats.trend_scrolls++;
+            // O timer só avisa a task; o comando de parada sai depois do mutex, e um
+            // atraso aqui pode ter deixado o painel dar um segundo passo
+            if (esp_timer_get_time() - scroll_start_us >= OLED_TREND_SCROLL_LATE_MS * 1000) {
+                oled_trend_resend();
+                display_stats.trend_scroll_resends++;
+            }
+            events |= deferred;
+            deferred = 0;
+        }
+        if (scrolling) {
+            // Troca de tela, colunas novas e desligamento esperam o fim do passo de scroll
+            deferred |= events & (OLED_EVT_SCREEN | OLED_EVT_HISTORY | OLED_EVT_SHIFT | OLED_EVT_IDLE);
+            events &= ~(OLED_EVT_SCREEN | OLED_EVT_HISTORY | OLED_EVT_SHIFT | OLED_EVT_IDLE);
+        }
+
+        // Atividade: alarme, cliente do painel web ou valor que mudou de verdade. A troca
+        // automática de tela e o tick não contam, senão o painel nunca desligaria
+        bool activity = (events & (OLED_EVT_ALARM | OLED_EVT_ACTIVITY)) != 0;
+        const char *reason = (events & OLED_EVT_ALARM) ? "alarm raised" : "web client";
+        if (events & OLED_EVT_MEASUREMENT) {
+            int16_t current_temp = g_last_temperature_x10;
+            int16_t current_umid = g_last_humidity_x10;
+            if (value_moved(wake_temp, current_temp, OLED_WAKE_TEMP_DELTA_X10) ||
+                value_moved(wake_umid, current_umid, OLED_WAKE_HUM_DELTA_X10)) {
+                if (!activity) {
+                    reason = "value changed";
+                }
+                activity = true;
             }
-            if (sync_state == 1) {
-                ssd1306_setColor(0);
-                ssd1306_fillRect(10, 25, 10 + 96, 25 + 8);
-                ssd1306_setColor(1);
-                vTaskDelay(pdMS_TO_TICKS(500)); 
+        }
+
+        bool waking = false;
+        if (activity) {
+            wake_temp = g_last_temperature_x10;
+            wake_umid = g_last_humidity_x10;
+            restart_idle_timer();
+            if (panel_off) {
+                // Religa na tela principal, com tudo o que mudou enquanto desligado
+                power_account();
+                panel_off = false;
+                display_stats.panel_on = true;
+                display_stats.wakes++;
+                waking = true;
+                events |= OLED_EVT_TICK | OLED_EVT_MEASUREMENT | OLED_EVT_CONNECTIVITY;
+                if (trend_screen) {
+                    trend_screen = false;
+                    ssd1306_clearScreen();
+                    oled_ui_invalidate();
+                }
+                if (OLED_TREND_SCREEN_S > 0) {
+                    esp_timer_start_once(screen_timer, OLED_MAIN_SCREEN_S * 1000000ULL);
+                }
+                if (OLED_BURNIN_SHIFT_PX > 0) {
+                    esp_timer_start_periodic(shift_timer, OLED_BURNIN_PERIOD_S * 1000000ULL);
+                }
+                ESP_LOGI(TAG, "OLED on: %s", reason);
             }
-            last_sync_state = sync_state;
+        } else if ((events & OLED_EVT_IDLE) && !panel_off) {
+            panel_power_off();
         }
-        if (sync_state == 0) {
-            // Se não sincronizado, apenas mostra mensagem
-            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(1000));
+        if (panel_off) {
+            // Eventos de medição, WiFi etc. são descartados: a tela é refeita ao religar
+            xSemaphoreGive(display_mutex);
+            xTaskNotifyWait(0, UINT32_MAX, &events, portMAX_DELAY);
             continue;
         }
-        // Verifica estado do WiFi e atualiza ícone somente daqui
+
+        bool synced = is_time_synced();
+        oled_screen_set_synced(synced);
+
         if (wifi_event_group != NULL) {
             EventBits_t wbits = xEventGroupGetBits(wifi_event_group);
-            int is_connected = (wbits & WIFI_CONNECTED_BIT) ? 1 : 0;
-            if (is_connected != wifi_icon_state) {
-                if (is_connected) {
-                    draw_wifi_icon();
-                } else {
-                    clear_wifi_icon();
+            oled_screen_set_wifi(synced && (wbits & WIFI_CONNECTED_BIT) != 0);
+        }
+
+        if (events & OLED_EVT_TICK) {
+            schedule_tick();
+            struct tm timeinfo;
+            clock_now(&timeinfo);
+            oled_screen_set_clock(&timeinfo);
+            set_contrast(scheduled_contrast(&timeinfo, synced));
+            // xx = mensagens confirmadas pelo broker (MQTT_EVENT_PUBLISHED), yy = backlog no SPIFFS
+            oled_screen_set_counts(mqtt_messages_sent, ring_idx.count);
+        }
+
+        if (events & OLED_EVT_MEASUREMENT) {
+            int16_t current_temp = g_last_temperature_x10;
+            int16_t current_umid = g_last_humidity_x10;
+            if (prev_temp != current_temp || prev_umid != current_umid) {
+                // Sino aparece por 250 ms a cada nova medição (exceto a primeira), sem bloquear a task
+                if (synced && (prev_temp != MEAS_VALUE_INVALID) && (prev_umid != MEAS_VALUE_INVALID)) {
+                    oled_screen_set_notify(true);
+                    esp_timer_stop(blink_timer);
+                    esp_timer_start_once(blink_timer, 250 * 1000);
                 }
-                wifi_icon_state = is_connected;
+                prev_temp = current_temp;
+                prev_umid = current_umid;
             }
         }
+        if (events & OLED_EVT_BLINK_END) {
+            oled_screen_set_notify(false);
+        }
+        bool show_values = synced && atomic_load(&system_ready) && prev_temp != MEAS_VALUE_INVALID;
+        oled_screen_set_values(prev_temp, prev_umid, show_values);
 
-        // Linha 0: data/hora (sempre limpa e imprime toda a linha, sem flicker)
-        time_t now = time(NULL);
-        struct tm timeinfo;
-        localtime_r(&now, &timeinfo);
-        char current_time_str[32];
-        snprintf(current_time_str, sizeof(current_time_str), "%02d/%02d/%02d %02d:%02d:%02d",
-                 timeinfo.tm_mday, timeinfo.tm_mon + 1, (timeinfo.tm_year + 1900) % 100,
-                 timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-        
-        // Atualiza hora se mudou (sem flicker: redesenha por cima, sem limpar)
-        if (strcmp(prev_time_str, current_time_str) != 0) {
-            // Separar data e hora para atualização independente
-            char current_date_part[16] = "";
-            char current_time_part[16] = "";
-            // Extrair partes da string "DD/MM/YY HH:MM:SS"
-            if (strlen(current_time_str) >= 17) {
-                strncpy(current_date_part, current_time_str, 8);
-                current_date_part[8] = '\0';
-                strcpy(current_time_part, current_time_str + 9);
+        if (events & OLED_EVT_SHIFT) {
+            // Vai e volta entre 0 e OLED_BURNIN_SHIFT_PX linhas; só a linha inicial muda, a GDRAM não.
+            // Com framebuffer sombra a imagem anda também o mesmo número de colunas para a direita
+            // (reenvia a área desenhada, uma vez por período)
+            shift_step = shift_step + 1 >= 2 * OLED_BURNIN_SHIFT_PX ? 0 : shift_step + 1;
+            uint8_t rows = shift_step <= OLED_BURNIN_SHIFT_PX ? shift_step : 2 * OLED_BURNIN_SHIFT_PX - shift_step;
+            ssd1306_setStartLine((SCREEN_HEIGHT - rows) % SCREEN_HEIGHT);
+            display_stats.shift_rows = rows;
+            if (display_stats.shadow) {
+                ssd1306_setShadowOffset(rows);
+                display_stats.shift_cols = rows;
+            }
+        }
+        if (events & OLED_EVT_SCREEN) {
+            trend_screen = !trend_screen;
+            esp_timer_start_once(screen_timer,
+                                 (trend_screen ? OLED_TREND_SCREEN_S : OLED_MAIN_SCREEN_S) * 1000000ULL);
+            ssd1306_clearScreen();
+            if (trend_screen) {
+                oled_trend_draw();
+                display_stats.trend_redraws++;
+            } else {
+                oled_ui_invalidate();
             }
-            ssd1306_setFixedFont(ssd1306xled_font6x8);
-            // Calcular posições (deslocadas 5 pixels para a esquerda)
-            int total_width = strlen(current_time_str) * 6;
-            int start_x = (SCREEN_WIDTH - total_width) / 2 - 5;
-            int date_width = 8 * 6;
-            // Atualiza apenas a data se mudou
-            static char prev_date_part[16] = "";
-            static char prev_time_part[16] = "";
-            if (strcmp(prev_date_part, current_date_part) != 0) {
-                ssd1306_printFixed(start_x, 0, current_date_part, STYLE_NORMAL);
-                strcpy(prev_date_part, current_date_part);
+        } else if (trend_screen && (events & OLED_EVT_HISTORY)) {
+            // O scroll desloca o conteúdo da GDRAM: nada pode estar pendente no framebuffer sombra
+            bool hw_scroll = display_stats.shadow && OLED_TREND_HW_SCROLL_ENABLED;
+            if (hw_scroll) {
+                display_flush();
             }
-            // Atualiza apenas a hora se mudou
-            if (strcmp(prev_time_part, current_time_part) != 0) {
-                int time_x = start_x + date_width + 6;
-                ssd1306_printFixed(time_x, 0, current_time_part, STYLE_NORMAL);
-                strcpy(prev_time_part, current_time_part);
+            oled_trend_update_t update = oled_trend_advance(hw_scroll);
+            if (update == OLED_TREND_SCROLL) {
+                scrolling = true;
+                scroll_start_us = esp_timer_get_time();
+                esp_timer_start_once(scroll_timer, OLED_TREND_SCROLL_STOP_MS * 1000);
+            } else if (update == OLED_TREND_REDRAWN) {
+                display_stats.trend_redraws++;
             }
-            strcpy(prev_time_str, current_time_str);
         }
-
-        // Linha 63: xx/yy
-        char count_str[40];
-    uint32_t xx = mqtt_messages_sent; // Mensagens confirmadas pelo broker (MQTT_EVENT_PUBLISHED)
-        uint32_t yy = ring_idx.count;     // Mensagens presentes no backlog
-        
-        // Formato compacto para números grandes: usa sufixos K, M
-        char compact_xx[16], compact_yy[16];
-        if (xx >= 1000000) {
-            snprintf(compact_xx, sizeof(compact_xx), "%luM", (unsigned long)(xx / 1000000));
-        } else if (xx >= 1000) {
-            snprintf(compact_xx, sizeof(compact_xx), "%luK", (unsigned long)(xx / 1000));
-        } else {
-            snprintf(compact_xx, sizeof(compact_xx), "%lu", (unsigned long)xx);
+        if (!trend_screen) {
+            oled_ui_render();
         }
-        
-        if (yy >= 1000000) {
-            snprintf(compact_yy, sizeof(compact_yy), "%luM", (unsigned long)(yy / 1000000));
-        } else if (yy >= 1000) {
-            snprintf(compact_yy, sizeof(compact_yy), "%luK", (unsigned long)(yy / 1000));
-        } else {
-            snprintf(compact_yy, sizeof(compact_yy), "%lu", (unsigned long)yy);
+        if (waking) {
+            // Imagem nova já na GDRAM antes de ligar: o painel não mostra a tela antiga
+            display_flush();
+            ssd1306_displayOn();
         }
-        snprintf(count_str, sizeof(count_str), "%s/%s", compact_xx, compact_yy);
-        
-        // Atualiza o contador se mudou (evita flicker)
-        static char prev_count_str[40] = "";
-        if (strcmp(prev_count_str, count_str) != 0) {
-            int count_width = strlen(count_str) * 6;
-            int prev_count_width = strlen(prev_count_str) * 6;
-            int max_counter_width = 78;
-            int clear_width = (count_width > prev_count_width) ? count_width : prev_count_width;
-            if (clear_width > max_counter_width) {
-                clear_width = max_counter_width;
-            }
-            ssd1306_setColor(0);
-            ssd1306_fillRect(0, SCREEN_HEIGHT - 8, clear_width + 6, SCREEN_HEIGHT);
-            ssd1306_setColor(1);
-            ssd1306_setFixedFont(ssd1306xled_font6x8);
-            ssd1306_printFixed(0, SCREEN_HEIGHT - 8, count_str, STYLE_NORMAL);
-            strcpy(prev_count_str, count_str);
-        }
-
-        ssd1306_setFixedFont(ssd1306xled_font6x8);
+        display_stats.renders++;
+        xSemaphoreGive(display_mutex);
+        update_us_stats((uint32_t)(esp_timer_get_time() - t0), &display_stats.render_us_last,
+                        &display_stats.render_us_max, &display_stats.render_us_total);
 
-        // Imprimir versão do firmware no canto inferior direito
-        int fw_len = strlen(FIRMWARE_VERSION);
-        int fw_x = SCREEN_WIDTH - fw_len * 6;
-        ssd1306_printFixed(fw_x, SCREEN_HEIGHT - 8, FIRMWARE_VERSION, STYLE_NORMAL);
-
-        // Imprimir identificação do sensor centralizada na última linha
-        int sensor_len = strlen(SENSOR_ID);
-        int sensor_x = (SCREEN_WIDTH - sensor_len * 6) / 2;
-        ssd1306_printFixed(sensor_x, SCREEN_HEIGHT - 8, SENSOR_ID, STYLE_NORMAL);
-
-        // Obter temperatura e umidade mais recentes
-        float current_temp = g_last_temperature;
-        float current_umid = g_last_humidity;
+        if (flush_task != NULL) {
+            xTaskNotifyGive(flush_task);
+        }
+        xTaskNotifyWait(0, UINT32_MAX, &events, portMAX_DELAY);
+    }
+}
 
-        // Atualiza temperatura e umidade se mudaram (sem piscar)
-        if (prev_temp != current_temp || prev_umid != current_umid) {
+void oled_flush_task(void *pvParameter) {
+    flush_task = xTaskGetCurrentTaskHandle();
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // Espera curta agrupa renderizações próximas (tick + medição, sino) num só envio
+        vTaskDelay(pdMS_TO_TICKS(OLED_FLUSH_DEFER_MS));
+        ulTaskNotifyTake(pdTRUE, 0);
 
-            if ((prev_temp != -99.0f) && (prev_umid != -99.0f)) {
-                draw_notify_icon();
-                vTaskDelay(250 / portTICK_PERIOD_MS);
-                clear_notify_icon();
-            }
- 
-            // Base Y para os dígitos grandes (centralizado verticalmente)
-            int y_base = ((SCREEN_HEIGHT - 32) / 2) + 6;                
-
-            // Verifica se sistema está pronto para exibir valores reais
-            if (atomic_load(&system_ready)) {
-                // Separar partes inteiras e decimais com arredondamento correto (compatível com log)
-                int temp_int = (int)current_temp;
-                int temp_dec = (int)((current_temp - temp_int) * 10 + 0.5); // Arredondar igual ao log
-                int umid_int = (int)current_umid;
-                int umid_dec = (int)((current_umid - (float)umid_int) * 10 + 0.5); // Arredondar igual ao log
-                
-                // Layout centralizado: Temperatura à esquerda, Umidade à direita
-                char temp_int_str[4], umid_int_str[4];
-                snprintf(temp_int_str, sizeof(temp_int_str), "%d", temp_int);
-                snprintf(umid_int_str, sizeof(umid_int_str), "%d", umid_int);              
-                
-                // Calcular larguras totais para centralização
-                int temp_total_width = strlen(temp_int_str) * 16 + 12; // dígitos + coluna vertical (°C/decimal)
-                int umid_total_width = strlen(umid_int_str) * 16 + 6;  // dígitos + coluna vertical (%/ponto.decimal)
-                int gap = 15; // espaço entre temperatura e umidade
-                int combined_width = temp_total_width + gap + umid_total_width;
-                int start_x = (SCREEN_WIDTH - combined_width) / 2 - 5;
-                
-
-                // TEMPERATURA: dígitos grandes + coluna vertical [°C/ponto.decimal]
-                int temp_start_x = start_x;
-                ssd1306_setFixedFont(ssd1306xled_font8x16);
-                ssd1306_printFixedN(temp_start_x, y_base, temp_int_str, STYLE_NORMAL, FONT_SIZE_2X);              
-                // Coluna vertical da temperatura [1,1]=oC [2,1]=ponto.decimal
-                ssd1306_setFixedFont(ssd1306xled_font6x8);
-                char temp_dec_str[2];
-                snprintf(temp_dec_str, sizeof(temp_dec_str), "%d", temp_dec);
-                int temp_width = strlen(temp_int_str) * 16; // largura dos dígitos grandes
-                int temp_col_x = temp_start_x + temp_width + 2; // coluna à direita dos dígitos
-                // [1,1] = "°C" (em cima) - símbolo de graus desenhado + C
-                draw_degree_symbol(temp_col_x, y_base + 4);
-                ssd1306_printFixed(temp_col_x + 4, y_base + 4, "C", STYLE_NORMAL);
-                // [2,1] = ponto + decimal (embaixo, 5 pixels mais próximo do número grande)
-                ssd1306_printFixed(temp_col_x - 5, y_base + 24, ".", STYLE_NORMAL);
-                ssd1306_printFixed(temp_col_x - 5 + 6, y_base + 24, temp_dec_str, STYLE_NORMAL);
-
-                // UMIDADE: dígitos grandes + coluna vertical [%/ponto.decimal]
-                int umid_start_x = temp_start_x + temp_total_width + gap;
-                ssd1306_setFixedFont(ssd1306xled_font8x16);
-                ssd1306_printFixedN(umid_start_x, y_base, umid_int_str, STYLE_NORMAL, FONT_SIZE_2X);
-                // Coluna vertical da umidade [1,1]=% [2,1]=ponto.decimal
-                ssd1306_setFixedFont(ssd1306xled_font6x8);
-                char umid_dec_str[2];
-                snprintf(umid_dec_str, sizeof(umid_dec_str), "%d", umid_dec);
-                int umid_width = strlen(umid_int_str) * 16; // largura dos dígitos grandes
-                int umid_col_x = umid_start_x + umid_width + 2; // coluna à direita dos dígitos
-                // [1,1] = "%" (em cima)
-                ssd1306_printFixed(umid_col_x, y_base + 4, "%", STYLE_NORMAL);
-                // [2,1] = ponto + decimal (embaixo, 5 pixels mais próximo do número grande)
-                ssd1306_printFixed(umid_col_x - 5, y_base + 24, ".", STYLE_NORMAL);
-                ssd1306_printFixed(umid_col_x - 5 + 6, y_base + 24, umid_dec_str, STYLE_NORMAL);
-            }
-            prev_temp = current_temp;
-            prev_umid = current_umid;
+        xSemaphoreTake(display_mutex, portMAX_DELAY);
+        // Durante o scroll a GDRAM fica bloqueada; o fim do scroll gera nova renderização e envio.
+        // Com o painel desligado nada é enviado
+        if (!scrolling && !panel_off) {
+            display_flush();
         }
-        vTaskDelayUntil(&last_wake, 1000 / portTICK_PERIOD_MS);
+        xSemaphoreGive(display_mutex);
     }
 }
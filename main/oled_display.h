@@ -1,29 +1,105 @@
 #ifndef OLED_DISPLAY_H
 #define OLED_DISPLAY_H
 
+#include <stdbool.h>
+#include <stdint.h>
 
+// Eventos que acordam a oled_display_task (ver oled_display_notify)
+#define OLED_EVT_TICK           (1 << 0)    // virada do segundo do relógio
+#define OLED_EVT_MEASUREMENT    (1 << 1)    // nova medição do sensor principal
+#define OLED_EVT_CONNECTIVITY   (1 << 2)    // WiFi conectou/caiu, relógio sincronizado
+#define OLED_EVT_BLINK_END      (1 << 3)    // fim do pisca do sino
+#define OLED_EVT_SCREEN         (1 << 4)    // alternar tela principal / tendência
+#define OLED_EVT_HISTORY        (1 << 5)    // coluna nova no histórico de tendência
+#define OLED_EVT_SCROLL_END     (1 << 6)    // fim do passo de scroll do gráfico
+#define OLED_EVT_SHIFT          (1 << 7)    // próximo passo do deslocamento anti burn-in
+#define OLED_EVT_ALARM          (1 << 8)    // alarme disparado: liga o painel
+#define OLED_EVT_IDLE           (1 << 9)    // fim do tempo sem atividade: desliga o painel
+#define OLED_EVT_ACTIVITY       (1 << 10)   // cliente do painel web conectou: liga o painel
 
-/**
- * @brief Função para desenhar o símbolo de grau
- * @param x Coordenada X
- * @param y Coordenada Y
- */
-void draw_degree_symbol(int x, int y);
+// Custo do display: tráfego I2C por quadro (um quadro = um envio da oled_flush_task)
+// e tempo de CPU da renderização e do envio
+typedef struct {
+    bool shadow;              // framebuffer sombra ativo
+    uint32_t renders;
+    uint32_t render_us_last;
+    uint32_t render_us_max;
+    uint64_t render_us_total;
+    uint32_t frames;
+    uint32_t flush_us_last;   // com framebuffer sombra, é o tempo de barramento do quadro
+    uint32_t flush_us_max;
+    uint64_t flush_us_total;
+    uint32_t bytes_last;      // bytes enviados após o endereço I2C
+    uint32_t bytes_max;
+    uint32_t bytes_total;
+    uint32_t transactions_last;
+    uint32_t transactions_max;
+    uint32_t transactions_total;
+    // Escrita completa de 128x64 direto no display, medida no início da task
+    uint32_t refresh_us;
+    uint32_t refresh_bytes;
+    uint32_t refresh_transactions;
+    // Ciclos de CPU da mesma escrita, incluindo o I2C por software: despacho por ponteiro
+    // a cada byte vs. driver especializado (0 se o driver especializado não estiver ativo)
+    uint32_t refresh_cycles_runtime;
+    uint32_t refresh_cycles_static;
+    // Ciclos de CPU por dígito 2x desenhado no framebuffer sombra (0 sem framebuffer sombra)
+    uint32_t digit_cycles_scaled;
+    uint32_t digit_cycles_cached;
+    // Tela de tendência: colunas novas por scroll de hardware e redesenhos completos
+    uint32_t trend_scrolls;
+    uint32_t trend_scroll_resends;  // scrolls parados tarde: páginas do gráfico reenviadas
+    uint32_t trend_redraws;
+    // Deslocamento anti burn-in atual (linhas para baixo, colunas para a direita)
+    uint8_t shift_rows;
+    uint8_t shift_cols;
+    // Energia: painel ligado, contraste atual, tempo ligado/desligado e desligamentos por inatividade
+    bool panel_on;
+    uint8_t contrast;
+    uint64_t on_us;
+    uint64_t off_us;
+    uint32_t power_offs;
+    uint32_t wakes;
+    // Estimativa (não contagem) dos bytes I2C não enviados com o painel desligado: tempo
+    // desligado vezes a taxa média (bytes por segundo) medida com o painel ligado
+    uint32_t bytes_skipped_est;
+} oled_display_stats_t;
 
 /**
- * @brief Função para desenhar o ícone de notificação
+ * @brief Cria o mutex e os timers do display
+ * @note Chamar antes de criar oled_display_task e oled_flush_task
  */
-void draw_notify_icon(void);
+void oled_display_init(void);
 
 /**
- * @brief Função para apagar o ícone de notificação
+ * @brief Acorda a task do display para redesenhar o que os eventos afetam
+ * @param events Máscara OLED_EVT_*; sem efeito se o display não estiver rodando
  */
-void clear_notify_icon(void);
+void oled_display_notify(uint32_t events);
 
 /**
  * @brief Tarefa para atualizar o display OLED com temperatura e umidade
+ *
+ * Dorme até receber eventos (OLED_EVT_*), atualiza os widgets e desenha no
+ * framebuffer sombra; o envio pelo I2C fica com a oled_flush_task.
+ *
  * @param pvParameter Parâmetros da task (não utilizado)
  */
 void oled_display_task(void *pvParameter);
 
+/**
+ * @brief Tarefa que envia ao display as alterações renderizadas
+ *
+ * Agrupa as renderizações feitas em OLED_FLUSH_DEFER_MS num único envio.
+ *
+ * @param pvParameter Parâmetros da task (não utilizado)
+ */
+void oled_flush_task(void *pvParameter);
+
+/**
+ * @brief Copia os contadores de tráfego I2C do display
+ * @param out Destino dos contadores
+ */
+void oled_display_get_stats(oled_display_stats_t *out);
+
 #endif // OLED_DISPLAY_H
@@ -0,0 +1,165 @@
+#include "oled_screen.h"
+#include "config.h"
+#include "oled_ui.h"
+#include <stdio.h>
+#include "ssd1306.h"
+
+static void draw_wifi_icon(int x, int y) {
+    ssd1306_drawLine(x+6, y+8, x+8, y+8);
+    ssd1306_drawLine(x+4, y+6, x+10, y+6);
+    ssd1306_drawLine(x+2, y+4, x+12, y+4);
+    ssd1306_putPixel(x+7, y+10);
+}
+
+void draw_degree_symbol(int x, int y) {
+    // Desenhar um círculo pequeno de raio 2 pixels para o símbolo °
+    ssd1306_putPixel(x+1, y);     // topo
+    ssd1306_putPixel(x, y+1);     // esquerda
+    ssd1306_putPixel(x+2, y+1);   // direita
+    ssd1306_putPixel(x+1, y+2);   // baixo
+}
+
+void draw_notify_icon(int x, int y) {
+    // Desenhar um sino simples (8x8 pixels)
+    // Linha superior do sino
+    ssd1306_putPixel(x+3, y);
+    ssd1306_putPixel(x+4, y);
+    
+    // Corpo do sino (formato de sino)
+    ssd1306_putPixel(x+2, y+1);
+    ssd1306_putPixel(x+5, y+1);
+    
+    ssd1306_putPixel(x+1, y+2);
+    ssd1306_putPixel(x+6, y+2);
+    
+    ssd1306_putPixel(x+1, y+3);
+    ssd1306_putPixel(x+6, y+3);
+    
+    ssd1306_putPixel(x+1, y+4);
+    ssd1306_putPixel(x+6, y+4);
+    
+    // Base do sino
+    ssd1306_putPixel(x, y+5);
+    ssd1306_putPixel(x+1, y+5);
+    ssd1306_putPixel(x+2, y+5);
+    ssd1306_putPixel(x+3, y+5);
+    ssd1306_putPixel(x+4, y+5);
+    ssd1306_putPixel(x+5, y+5);
+    ssd1306_putPixel(x+6, y+5);
+    ssd1306_putPixel(x+7, y+5);
+    
+    // Badalo do sino
+    ssd1306_putPixel(x+3, y+6);
+    ssd1306_putPixel(x+4, y+6);
+}
+
+// Formato compacto para números grandes: usa sufixos K, M
+static void format_compact(char *buf, size_t len, uint32_t v) {
+    if (v >= 1000000) {
+        snprintf(buf, len, "%luM", (unsigned long)(v / 1000000));
+    } else if (v >= 1000) {
+        snprintf(buf, len, "%luK", (unsigned long)(v / 1000));
+    } else {
+        snprintf(buf, len, "%lu", (unsigned long)v);
+    }
+}
+
+// Widgets da tela, na ordem de desenho (onde se sobrepõem, o último prevalece)
+static oled_ui_widget_t ui_init_msg;
+static oled_ui_widget_t ui_date;
+static oled_ui_widget_t ui_time;
+static oled_ui_widget_t ui_wifi;
+static oled_ui_widget_t ui_temp;
+static oled_ui_widget_t ui_umid;
+static oled_ui_widget_t ui_notify;
+static oled_ui_widget_t ui_count;
+static oled_ui_widget_t ui_sensor;
+static oled_ui_widget_t ui_version;
+
+void oled_screen_init(void) {
+    // Linha 0: "DD/MM/YY HH:MM:SS" centralizado e deslocado 5 px para a esquerda
+    int date_x = (OLED_LAYOUT_WIDTH - 17 * 6) / 2 - 5;
+    int time_x = date_x + 8 * 6 + 6;
+    // Dígitos grandes centralizados verticalmente
+    int y_base = ((SCREEN_HEIGHT - 32) / 2) + 6;
+    // O deslocamento anti burn-in traz as últimas OLED_BURNIN_SHIFT_PX linhas da GDRAM para o
+    // topo: o rodapé sobe uma página se a tinta da fonte 6x8 (linhas 0-6 da página) as ocupar.
+    // Na horizontal, tudo fica dentro de OLED_LAYOUT_WIDTH
+    int footer_y = ((SCREEN_HEIGHT - 7 - OLED_BURNIN_SHIFT_PX) / 8) * 8;
+
+    oled_ui_text_init(&ui_init_msg, 10, 25, 10 + 96, ssd1306xled_font6x8, 6, 8, OLED_UI_ALIGN_LEFT);
+    oled_ui_text_set(&ui_init_msg, "Inicializando...");
+    oled_ui_text_init(&ui_date, date_x, 0, date_x + 8 * 6 - 1, ssd1306xled_font6x8, 6, 8, OLED_UI_ALIGN_LEFT);
+    oled_ui_text_init(&ui_time, time_x, 0, time_x + 8 * 6 - 1, ssd1306xled_font6x8, 6, 8, OLED_UI_ALIGN_LEFT);
+    oled_ui_icon_init(&ui_wifi, OLED_LAYOUT_WIDTH - 14, 2, OLED_LAYOUT_WIDTH - 1, 13, draw_wifi_icon);
+    // Temperatura à esquerda, umidade à direita, sem invadir a coluna do sino
+    oled_ui_number_init(&ui_temp, 0, y_base, 61, "C", draw_degree_symbol);
+    oled_ui_number_init(&ui_umid, 62, y_base, OLED_LAYOUT_WIDTH - 13, "%", NULL);
+    oled_ui_icon_init(&ui_notify, OLED_LAYOUT_WIDTH - 12, SCREEN_HEIGHT - 25,
+                      OLED_LAYOUT_WIDTH - 4, SCREEN_HEIGHT - 17, draw_notify_icon);
+    // Rodapé: contador xx/yy à esquerda, sensor ao centro, versão à direita
+    oled_ui_text_init(&ui_count, 0, footer_y, 77, ssd1306xled_font6x8, 6, 8, OLED_UI_ALIGN_LEFT);
+    oled_ui_text_init(&ui_sensor, 0, footer_y, OLED_LAYOUT_WIDTH - 1, ssd1306xled_font6x8, 6, 8,
+                      OLED_UI_ALIGN_CENTER);
+    oled_ui_text_set(&ui_sensor, SENSOR_ID);
+    oled_ui_text_init(&ui_version, 0, footer_y, OLED_LAYOUT_WIDTH - 1, ssd1306xled_font6x8, 6, 8,
+                      OLED_UI_ALIGN_RIGHT);
+    oled_ui_text_set(&ui_version, FIRMWARE_VERSION);
+
+    oled_ui_add(&ui_init_msg);
+    oled_ui_add(&ui_date);
+    oled_ui_add(&ui_time);
+    oled_ui_add(&ui_wifi);
+    oled_ui_add(&ui_temp);
+    oled_ui_add(&ui_umid);
+    oled_ui_add(&ui_notify);
+    oled_ui_add(&ui_count);
+    oled_ui_add(&ui_sensor);
+    oled_ui_add(&ui_version);
+}
+
+void oled_screen_set_synced(bool synced) {
+    oled_ui_set_visible(&ui_init_msg, !synced);
+    oled_ui_set_visible(&ui_date, synced);
+    oled_ui_set_visible(&ui_time, synced);
+    oled_ui_set_visible(&ui_count, synced);
+    oled_ui_set_visible(&ui_sensor, synced);
+    oled_ui_set_visible(&ui_version, synced);
+    if (!synced) {
+        oled_ui_set_visible(&ui_wifi, false);
+        oled_ui_set_visible(&ui_temp, false);
+        oled_ui_set_visible(&ui_umid, false);
+    }
+}
+
+void oled_screen_set_clock(const struct tm *now) {
+    char buf[OLED_UI_TEXT_MAX];
+    snprintf(buf, sizeof(buf), "%02d/%02d/%02d", now->tm_mday, now->tm_mon + 1, (now->tm_year + 1900) % 100);
+    oled_ui_text_set(&ui_date, buf);
+    snprintf(buf, sizeof(buf), "%02d:%02d:%02d", now->tm_hour, now->tm_min, now->tm_sec);
+    oled_ui_text_set(&ui_time, buf);
+}
+
+void oled_screen_set_counts(uint32_t sent, uint32_t backlog) {
+    char buf[OLED_UI_TEXT_MAX];
+    char compact_xx[12], compact_yy[12];
+    format_compact(compact_xx, sizeof(compact_xx), sent);
+    format_compact(compact_yy, sizeof(compact_yy), backlog);
+    snprintf(buf, sizeof(buf), "%s/%s", compact_xx, compact_yy);
+    oled_ui_text_set(&ui_count, buf);
+}
+
+void oled_screen_set_values(int16_t temp_x10, int16_t hum_x10, bool visible) {
+    oled_ui_number_set(&ui_temp, temp_x10);
+    oled_ui_number_set(&ui_umid, hum_x10);
+    oled_ui_set_visible(&ui_temp, visible);
+    oled_ui_set_visible(&ui_umid, visible);
+}
+
+void oled_screen_set_wifi(bool connected) {
+    oled_ui_set_visible(&ui_wifi, connected);
+}
+
+void oled_screen_set_notify(bool visible) {
+    oled_ui_set_visible(&ui_notify, visible);
+}
@@ -0,0 +1,65 @@
+#ifndef OLED_SCREEN_H
+#define OLED_SCREEN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Tela principal: layout dos widgets (data/hora, WiFi, temperatura, umidade,
+ * sino, rodapé) e atribuição de valores. Só depende de oled_ui e ssd1306, sem
+ * FreeRTOS: a oled_display_task e o emulador de host (tools/oled_emu) chamam
+ * as mesmas funções e depois oled_ui_render().
+ */
+
+/**
+ * @brief Função para desenhar o símbolo de grau
+ * @param x Coordenada X
+ * @param y Coordenada Y
+ */
+void draw_degree_symbol(int x, int y);
+
+/**
+ * @brief Função para desenhar o ícone de notificação (sino 8x8)
+ * @param x Coordenada X do canto superior esquerdo
+ * @param y Coordenada Y do canto superior esquerdo
+ */
+void draw_notify_icon(int x, int y);
+
+/**
+ * @brief Cria e registra os widgets da tela principal
+ */
+void oled_screen_init(void);
+
+/**
+ * @brief Relógio sincronizado mostra a tela principal; antes, só a mensagem de inicialização
+ */
+void oled_screen_set_synced(bool synced);
+
+/**
+ * @brief Data e hora da linha 0
+ */
+void oled_screen_set_clock(const struct tm *now);
+
+/**
+ * @brief Contador do rodapé: mensagens confirmadas pelo broker / backlog no SPIFFS
+ */
+void oled_screen_set_counts(uint32_t sent, uint32_t backlog);
+
+/**
+ * @brief Temperatura e umidade em décimos
+ * @param visible Falso oculta os dois valores (relógio não sincronizado, sem medição)
+ */
+void oled_screen_set_values(int16_t temp_x10, int16_t hum_x10, bool visible);
+
+/**
+ * @brief Ícone de WiFi conectado
+ */
+void oled_screen_set_wifi(bool connected);
+
+/**
+ * @brief Sino de nova medição
+ */
+void oled_screen_set_notify(bool visible);
+
+#endif // OLED_SCREEN_H
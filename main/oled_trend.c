@@ -0,0 +1,187 @@
+#include "oled_trend.h"
+#include "trend_history.h"
+#include "config.h"
+#include "fixed_point.h"
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306.h"
+#include "lcd/ssd1306_commands.h"
+
+#define TREND_PAGES     (OLED_TREND_LAST_PAGE - OLED_TREND_FIRST_PAGE + 1)
+// Faixas de linhas dos dois gráficos (inclusivas), separadas por 3 linhas vazias; as últimas
+// OLED_BURNIN_SHIFT_PX linhas ficam apagadas, pois o deslocamento anti burn-in as leva ao topo
+#define PLOT_ROWS       (SCREEN_HEIGHT - OLED_BURNIN_SHIFT_PX - 9 - 3)
+#define TEMP_TOP        9
+#define TEMP_BOTTOM     (TEMP_TOP + PLOT_ROWS / 2 - 1)
+#define HUM_TOP         (TEMP_BOTTOM + 4)
+#define HUM_BOTTOM      (SCREEN_HEIGHT - 1 - OLED_BURNIN_SHIFT_PX)
+// Colunas do gráfico: o histórico mais recente que cabe em OLED_LAYOUT_WIDTH
+#define PLOT_COLUMNS    (OLED_LAYOUT_WIDTH < TREND_HISTORY_LEN ? OLED_LAYOUT_WIDTH : TREND_HISTORY_LEN)
+// Amplitude mínima das escalas (décimos): evita ampliar ruído de décimos
+#define TEMP_MIN_SPAN   20
+#define HUM_MIN_SPAN    50
+
+// Escala de um gráfico em décimos, limites em unidades inteiras
+typedef struct {
+    int16_t lo;
+    int16_t hi;
+} trend_scale_t;
+
+// Cópia do histórico desenhada na tela
+static trend_point_t points[TREND_HISTORY_LEN];
+static size_t count = 0;
+static uint32_t columns = 0;
+static trend_scale_t temp_scale;
+static trend_scale_t hum_scale;
+
+static int16_t point_value(const trend_point_t *p, bool hum) {
+    return hum ? p->hum_x10 : p->temp_x10;
+}
+
+static int16_t floor_unit(int16_t v) {
+    return (int16_t)(v >= 0 ? v / 10 * 10 : -((-v + 9) / 10 * 10));
+}
+
+static int16_t ceil_unit(int16_t v) {
+    return (int16_t)-floor_unit((int16_t)-v);
+}
+
+static void scale_fit(trend_scale_t *s, bool hum, int16_t min_span) {
+    int16_t lo = INT16_MAX;
+    int16_t hi = INT16_MIN + 1;
+    for (size_t i = 0; i < count; i++) {
+        int16_t v = point_value(&points[i], hum);
+        if (v == MEAS_VALUE_INVALID) {
+            continue;
+        }
+        if (v < lo) {
+            lo = v;
+        }
+        if (v > hi) {
+            hi = v;
+        }
+    }
+    if (lo > hi) {
+        lo = 0;
+        hi = 0;
+    }
+    if (hi - lo < min_span) {
+        int16_t pad = (int16_t)((min_span - (hi - lo) + 1) / 2);
+        lo -= pad;
+        hi += pad;
+    }
+    s->lo = floor_unit(lo);
+    s->hi = ceil_unit(hi);
+}
+
+static bool scale_equal(const trend_scale_t *a, const trend_scale_t *b) {
+    return a->lo == b->lo && a->hi == b->hi;
+}
+
+// Traço de uma coluna: segmento vertical do valor anterior ao atual
+static void trace(uint8_t *col, int16_t prev, int16_t cur, const trend_scale_t *s, int top, int bottom) {
+    if (cur == MEAS_VALUE_INVALID) {
+        return;
+    }
+    int span = s->hi - s->lo;
+    int y1 = bottom - (int32_t)(cur - s->lo) * (bottom - top) / span;
+    int y0 = prev == MEAS_VALUE_INVALID ? y1 : bottom - (int32_t)(prev - s->lo) * (bottom - top) / span;
+    if (y0 > y1) {
+        int t = y0;
+        y0 = y1;
+        y1 = t;
+    }
+    for (int y = y0; y <= y1; y++) {
+        col[(y >> 3) - OLED_TREND_FIRST_PAGE] |= (uint8_t)(1 << (y & 7));
+    }
+}
+
+// Mantém só os pontos que cabem no gráfico; as escalas seguem o que está visível
+static void keep_visible(void) {
+    if (count > PLOT_COLUMNS) {
+        memmove(points, &points[count - PLOT_COLUMNS], PLOT_COLUMNS * sizeof(points[0]));
+        count = PLOT_COLUMNS;
+    }
+}
+
+// Ponto i do histórico vai na coluna OLED_LAYOUT_WIDTH - count + i
+static void draw_column(size_t i) {
+    uint8_t col[TREND_PAGES];
+    memset(col, 0, sizeof(col));
+    const trend_point_t *prev = i > 0 ? &points[i - 1] : NULL;
+    trace(col, prev ? prev->temp_x10 : MEAS_VALUE_INVALID, points[i].temp_x10, &temp_scale, TEMP_TOP, TEMP_BOTTOM);
+    trace(col, prev ? prev->hum_x10 : MEAS_VALUE_INVALID, points[i].hum_x10, &hum_scale, HUM_TOP, HUM_BOTTOM);
+    ssd1306_drawBuffer(OLED_LAYOUT_WIDTH - count + i, OLED_TREND_FIRST_PAGE, 1, TREND_PAGES * 8, col);
+}
+
+static void draw_all(void) {
+    char buf[32];
+
+    // Cabeçalho com as escalas; preenchido até a largura toda para sobrescrever o anterior
+    if (count > 0) {
+        snprintf(buf, sizeof(buf), "T%d-%dC H%d-%d%% %uh", temp_scale.lo / 10, temp_scale.hi / 10,
+                 hum_scale.lo / 10, hum_scale.hi / 10, (unsigned)OLED_TREND_HOURS);
+    } else {
+        snprintf(buf, sizeof(buf), "Tendencia %uh", (unsigned)OLED_TREND_HOURS);
+    }
+    size_t len = strlen(buf);
+    memset(&buf[len], ' ', sizeof(buf) - 1 - len);
+    buf[OLED_LAYOUT_WIDTH / 6] = '\0';
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    ssd1306_printFixed(0, 0, buf, STYLE_NORMAL);
+
+    ssd1306_clearBlock(0, OLED_TREND_FIRST_PAGE, SCREEN_WIDTH, TREND_PAGES * 8);
+    for (size_t i = 0; i < count; i++) {
+        draw_column(i);
+    }
+}
+
+void oled_trend_draw(void) {
+    count = trend_history_copy(points, &columns);
+    keep_visible();
+    scale_fit(&temp_scale, false, TEMP_MIN_SPAN);
+    scale_fit(&hum_scale, true, HUM_MIN_SPAN);
+    draw_all();
+}
+
+oled_trend_update_t oled_trend_advance(bool hw_scroll) {
+    uint32_t total;
+    size_t n = trend_history_copy(points, &total);
+    if (total == columns) {
+        return OLED_TREND_UNCHANGED;
+    }
+    bool one_column = total - columns == 1;
+    count = n;
+    columns = total;
+    keep_visible();
+    // Escalas reajustadas: pontos que saíram da janela também podem estreitá-las
+    trend_scale_t temp_new;
+    trend_scale_t hum_new;
+    scale_fit(&temp_new, false, TEMP_MIN_SPAN);
+    scale_fit(&hum_new, true, HUM_MIN_SPAN);
+    bool same_scale = scale_equal(&temp_new, &temp_scale) && scale_equal(&hum_new, &hum_scale);
+    temp_scale = temp_new;
+    hum_scale = hum_new;
+    if (hw_scroll && one_column && same_scale) {
+        // Passo de 25 quadros; oled_display para o scroll após OLED_TREND_SCROLL_STOP_MS
+        ssd1306_startHorizontalScroll(1, OLED_TREND_FIRST_PAGE, OLED_TREND_LAST_PAGE, SSD1306_SCROLL_25_FRAMES);
+        return OLED_TREND_SCROLL;
+    }
+    draw_all();
+    return OLED_TREND_REDRAWN;
+}
+
+void oled_trend_scroll_end(void) {
+    ssd1306_stopScroll();
+    // Coluna 0 deu a volta para a 127: sobrescrita pela coluna nova ou, com a margem
+    // anti burn-in, apagada
+    ssd1306_scrollShadow(OLED_TREND_FIRST_PAGE, OLED_TREND_LAST_PAGE, -1);
+    if (OLED_LAYOUT_WIDTH < SCREEN_WIDTH) {
+        ssd1306_clearBlock(SCREEN_WIDTH - 1, OLED_TREND_FIRST_PAGE, 1, TREND_PAGES * 8);
+    }
+    draw_column(count - 1);
+}
+
+void oled_trend_resend(void) {
+    ssd1306_invalidateShadow(OLED_TREND_FIRST_PAGE, OLED_TREND_LAST_PAGE);
+}
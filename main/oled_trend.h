@@ -0,0 +1,54 @@
+#ifndef OLED_TREND_H
+#define OLED_TREND_H
+
+#include <stdbool.h>
+
+/*
+ * Tela de tendência: cabeçalho com as escalas na página 0 e, nas páginas 1..7,
+ * os gráficos de temperatura (em cima) e umidade (embaixo) do trend_history,
+ * coluna mais recente à direita.
+ *
+ * Coluna nova com as escalas atuais: as páginas do gráfico são deslocadas uma
+ * coluna para a esquerda pelo scroll horizontal do próprio SSD1306 e só a
+ * coluna nova é desenhada. Fora disso (escala mudou, várias colunas novas,
+ * sem framebuffer sombra) o gráfico é redesenhado.
+ */
+
+// Primeira e última página do gráfico (deslocadas pelo scroll de hardware)
+#define OLED_TREND_FIRST_PAGE   1
+#define OLED_TREND_LAST_PAGE    7
+
+typedef enum {
+    OLED_TREND_UNCHANGED,   // nenhuma coluna nova
+    OLED_TREND_SCROLL,      // scroll de hardware iniciado: chamar oled_trend_scroll_end()
+    OLED_TREND_REDRAWN,     // gráfico redesenhado
+} oled_trend_update_t;
+
+/**
+ * @brief Desenha a tela de tendência inteira a partir do histórico atual
+ */
+void oled_trend_draw(void);
+
+/**
+ * @brief Acrescenta ao gráfico as colunas fechadas desde o último desenho
+ * @param hw_scroll Permite o scroll de hardware; exige framebuffer sombra sem alterações
+ *                  pendentes (chamar após ssd1306_flush())
+ * @note Com OLED_TREND_SCROLL a GDRAM não pode ser escrita até oled_trend_scroll_end()
+ */
+oled_trend_update_t oled_trend_advance(bool hw_scroll);
+
+/**
+ * @brief Para o scroll (depois de um passo), acompanha o deslocamento no framebuffer
+ *        sombra e desenha a coluna nova
+ */
+void oled_trend_scroll_end(void);
+
+/**
+ * @brief Reenvia as páginas do gráfico no próximo ssd1306_flush()
+ *
+ * Para chamar após oled_trend_scroll_end() quando o scroll foi parado tarde: o painel pode
+ * ter deslocado mais de uma coluna, e o framebuffer sombra só reenviaria o que mudou nele.
+ */
+void oled_trend_resend(void);
+
+#endif // OLED_TREND_H
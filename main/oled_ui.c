@@ -0,0 +1,318 @@
+#include "oled_ui.h"
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306.h"
+
+#define BIG_DIGIT_W     16
+#define BIG_DIGIT_H     32
+
+static const oled_ui_rect_t EMPTY_RECT = { 0, 0, -1, -1 };
+
+static oled_ui_widget_t *widgets[OLED_UI_MAX_WIDGETS];
+static uint8_t widget_count = 0;
+
+static bool rect_empty(const oled_ui_rect_t *r) {
+    return r->x1 < r->x0;
+}
+
+static bool rect_equal(const oled_ui_rect_t *a, const oled_ui_rect_t *b) {
+    return a->x0 == b->x0 && a->y0 == b->y0 && a->x1 == b->x1 && a->y1 == b->y1;
+}
+
+// Sobreposição em páginas: o SSD1306 escreve colunas de 8 linhas inteiras
+static bool rect_overlap(const oled_ui_rect_t *a, const oled_ui_rect_t *b) {
+    if (rect_empty(a) || rect_empty(b)) {
+        return false;
+    }
+    return a->x0 <= b->x1 && b->x0 <= a->x1 && (a->y0 >> 3) <= (b->y1 >> 3) && (b->y0 >> 3) <= (a->y1 >> 3);
+}
+
+static int16_t align_x(const oled_ui_widget_t *w, int width, oled_ui_align_t align) {
+    int box_w = w->box.x1 - w->box.x0 + 1;
+    if (align == OLED_UI_ALIGN_CENTER) {
+        return w->box.x0 + (box_w - width) / 2;
+    }
+    if (align == OLED_UI_ALIGN_RIGHT) {
+        return w->box.x1 + 1 - width;
+    }
+    return w->box.x0;
+}
+
+// Parte inteira com sinal e decimal separados (-0.5 => "-0" e 5)
+static void split_x10(int16_t value_x10, char *int_str, size_t len, int *dec) {
+    int abs_x10 = value_x10 < 0 ? -value_x10 : value_x10;
+    snprintf(int_str, len, "%s%d", value_x10 < 0 ? "-" : "", abs_x10 / 10);
+    *dec = abs_x10 % 10;
+}
+
+// Largura da coluna à direita dos dígitos: unidade em cima, ".d" embaixo (ponto recua 5 px)
+static int number_column_w(const oled_ui_widget_t *w) {
+    int unit_w = (w->number.unit_icon ? 4 : 0) + (int)strlen(w->number.unit) * 6;
+    return 2 + (unit_w > 7 ? unit_w : 7);
+}
+
+static oled_ui_rect_t widget_extent(const oled_ui_widget_t *w) {
+    oled_ui_rect_t r = EMPTY_RECT;
+    if (!w->visible) {
+        return r;
+    }
+    switch (w->type) {
+    case OLED_UI_TEXT: {
+        int max_chars = (w->box.x1 - w->box.x0 + 1) / w->text.char_w;
+        int n = strlen(w->text.value);
+        if (n > max_chars) {
+            n = max_chars;
+        }
+        if (n == 0) {
+            return r;
+        }
+        r.x0 = align_x(w, n * w->text.char_w, w->text.align);
+        r.x1 = r.x0 + n * w->text.char_w - 1;
+        r.y0 = w->box.y0;
+        r.y1 = w->box.y0 + w->text.char_h - 1;
+        break;
+    }
+    case OLED_UI_BIG_NUMBER: {
+        char int_str[8];
+        int dec;
+        split_x10(w->number.value_x10, int_str, sizeof(int_str), &dec);
+        int width = strlen(int_str) * BIG_DIGIT_W + number_column_w(w);
+        r.x0 = align_x(w, width, OLED_UI_ALIGN_CENTER);
+        r.x1 = r.x0 + width - 1;
+        r.y0 = w->box.y0;
+        // Dígitos são desenhados a partir da página de y0: a área termina 32 linhas depois dela
+        r.y1 = (w->box.y0 & ~7) + BIG_DIGIT_H - 1;
+        break;
+    }
+    case OLED_UI_ICON:
+        r = w->box;
+        break;
+    }
+    return r;
+}
+
+static void draw_text(oled_ui_widget_t *w, const oled_ui_rect_t *at, bool full) {
+    int n = (at->x1 - at->x0 + 1) / w->text.char_w;
+    int first = 0;
+    int last = n - 1;
+    if (!full) {
+        // Mesma posição e comprimento: só o trecho entre o primeiro e o último caractere alterado
+        while (first < n && w->text.value[first] == w->text.shown[first]) {
+            first++;
+        }
+        while (last > first && w->text.value[last] == w->text.shown[last]) {
+            last--;
+        }
+        if (first == n) {
+            return;
+        }
+    }
+    char part[OLED_UI_TEXT_MAX];
+    memcpy(part, &w->text.value[first], last - first + 1);
+    part[last - first + 1] = '\0';
+    ssd1306_setFixedFont(w->text.font);
+    ssd1306_printFixed(at->x0 + first * w->text.char_w, at->y0, part, STYLE_NORMAL);
+}
+
+static void draw_number(oled_ui_widget_t *w, const oled_ui_rect_t *at, bool full) {
+    char int_str[8], shown_int[8], dec_str[2];
+    int dec, shown_dec;
+    split_x10(w->number.value_x10, int_str, sizeof(int_str), &dec);
+    split_x10(w->number.shown_x10, shown_int, sizeof(shown_int), &shown_dec);
+    snprintf(dec_str, sizeof(dec_str), "%d", dec);
+
+    int col_x = at->x0 + strlen(int_str) * BIG_DIGIT_W + 2;
+    int y = at->y0;
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    if (!full && strcmp(int_str, shown_int) == 0) {
+        // Só a decimal mudou
+        ssd1306_printFixed(col_x + 1, y + 24, dec_str, STYLE_NORMAL);
+        return;
+    }
+    ssd1306_setFixedFont(ssd1306xled_font8x16);
+    ssd1306_printFixedN(at->x0, y, int_str, STYLE_NORMAL, FONT_SIZE_2X);
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    int unit_x = col_x;
+    if (w->number.unit_icon) {
+        w->number.unit_icon(col_x, y + 4);
+        unit_x += 4;
+    }
+    ssd1306_printFixed(unit_x, y + 4, w->number.unit, STYLE_NORMAL);
+    // Ponto recuado 5 px, sobre a borda dos dígitos grandes
+    ssd1306_printFixed(col_x - 5, y + 24, ".", STYLE_NORMAL);
+    ssd1306_printFixed(col_x + 1, y + 24, dec_str, STYLE_NORMAL);
+}
+
+static void clear_rect(const oled_ui_rect_t *r) {
+    if (rect_empty(r)) {
+        return;
+    }
+    ssd1306_setColor(0);
+    ssd1306_fillRect(r->x0, r->y0, r->x1, r->y1);
+    ssd1306_setColor(1);
+}
+
+void oled_ui_text_init(oled_ui_widget_t *w, int x0, int y, int x1, const uint8_t *font,
+                       uint8_t char_w, uint8_t char_h, oled_ui_align_t align) {
+    memset(w, 0, sizeof(*w));
+    w->type = OLED_UI_TEXT;
+    w->box = (oled_ui_rect_t){ x0, y, x1, y + char_h - 1 };
+    w->drawn = EMPTY_RECT;
+    w->visible = true;
+    w->text.font = font;
+    w->text.char_w = char_w;
+    w->text.char_h = char_h;
+    w->text.align = align;
+}
+
+void oled_ui_number_init(oled_ui_widget_t *w, int x0, int y, int x1, const char *unit,
+                         void (*unit_icon)(int x, int y)) {
+    memset(w, 0, sizeof(*w));
+    w->type = OLED_UI_BIG_NUMBER;
+    w->box = (oled_ui_rect_t){ x0, y, x1, (y & ~7) + BIG_DIGIT_H - 1 };
+    w->drawn = EMPTY_RECT;
+    w->visible = false;
+    w->number.unit = unit;
+    w->number.unit_icon = unit_icon;
+}
+
+void oled_ui_icon_init(oled_ui_widget_t *w, int x0, int y0, int x1, int y1,
+                       void (*draw)(int x, int y)) {
+    memset(w, 0, sizeof(*w));
+    w->type = OLED_UI_ICON;
+    w->box = (oled_ui_rect_t){ x0, y0, x1, y1 };
+    w->drawn = EMPTY_RECT;
+    w->visible = false;
+    w->icon.draw = draw;
+}
+
+void oled_ui_add(oled_ui_widget_t *w) {
+    if (widget_count < OLED_UI_MAX_WIDGETS) {
+        widgets[widget_count++] = w;
+        w->dirty = true;
+    }
+}
+
+void oled_ui_text_set(oled_ui_widget_t *w, const char *text) {
+    if (strncmp(w->text.value, text, OLED_UI_TEXT_MAX - 1) != 0) {
+        strncpy(w->text.value, text, OLED_UI_TEXT_MAX - 1);
+        w->text.value[OLED_UI_TEXT_MAX - 1] = '\0';
+        w->dirty = true;
+    }
+}
+
+void oled_ui_number_set(oled_ui_widget_t *w, int16_t value_x10) {
+    if (w->number.value_x10 != value_x10) {
+        w->number.value_x10 = value_x10;
+        w->dirty = true;
+    }
+}
+
+void oled_ui_set_visible(oled_ui_widget_t *w, bool visible) {
+    if (w->visible != visible) {
+        w->visible = visible;
+        w->dirty = true;
+    }
+}
+
+void oled_ui_invalidate(void) {
+    for (uint8_t i = 0; i < widget_count; i++) {
+        widgets[i]->drawn = EMPTY_RECT;
+        widgets[i]->dirty = true;
+    }
+}
+
+void oled_ui_render(void) {
+    oled_ui_rect_t next[OLED_UI_MAX_WIDGETS];
+    oled_ui_rect_t clear[OLED_UI_MAX_WIDGETS][2];
+    bool redraw[OLED_UI_MAX_WIDGETS];
+    bool full[OLED_UI_MAX_WIDGETS];
+    bool any = false;
+
+    // Área nova de cada widget alterado e sobras da área antiga a apagar
+    for (uint8_t i = 0; i < widget_count; i++) {
+        oled_ui_widget_t *w = widgets[i];
+        const oled_ui_rect_t *old = &w->drawn;
+        clear[i][0] = EMPTY_RECT;
+        clear[i][1] = EMPTY_RECT;
+        redraw[i] = w->dirty;
+        full[i] = false;
+        if (!w->dirty) {
+            next[i] = w->drawn;
+            continue;
+        }
+        any = true;
+        next[i] = widget_extent(w);
+        full[i] = !rect_equal(&next[i], old);
+        if (rect_empty(old)) {
+            continue;
+        }
+        if (rect_empty(&next[i]) || next[i].y0 != old->y0 || next[i].y1 != old->y1) {
+            clear[i][0] = *old;
+        } else {
+            // Mesma linha: apaga só as faixas laterais que o novo desenho não cobre
+            if (old->x0 < next[i].x0) {
+                clear[i][0] = (oled_ui_rect_t){ old->x0, old->y0,
+                                                old->x1 < next[i].x0 - 1 ? old->x1 : next[i].x0 - 1, old->y1 };
+            }
+            if (old->x1 > next[i].x1) {
+                clear[i][1] = (oled_ui_rect_t){ old->x0 > next[i].x1 + 1 ? old->x0 : next[i].x1 + 1,
+                                                old->y0, old->x1, old->y1 };
+            }
+        }
+    }
+    if (!any) {
+        return;
+    }
+
+    // Widgets atingidos pela área apagada ou redesenhada de outro são redesenhados por inteiro
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint8_t i = 0; i < widget_count; i++) {
+            if (!redraw[i]) {
+                continue;
+            }
+            for (uint8_t j = 0; j < widget_count; j++) {
+                if (j == i || (redraw[j] && full[j]) || rect_empty(&next[j])) {
+                    continue;
+                }
+                if (rect_overlap(&next[j], &next[i]) || rect_overlap(&next[j], &clear[i][0]) ||
+                    rect_overlap(&next[j], &clear[i][1])) {
+                    redraw[j] = true;
+                    full[j] = true;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // Apagar tudo antes de desenhar, para não apagar o que outro widget desenhou por cima
+    for (uint8_t i = 0; i < widget_count; i++) {
+        clear_rect(&clear[i][0]);
+        clear_rect(&clear[i][1]);
+    }
+    for (uint8_t i = 0; i < widget_count; i++) {
+        oled_ui_widget_t *w = widgets[i];
+        if (!redraw[i]) {
+            continue;
+        }
+        if (!rect_empty(&next[i])) {
+            switch (w->type) {
+            case OLED_UI_TEXT:
+                draw_text(w, &next[i], full[i]);
+                strcpy(w->text.shown, w->text.value);
+                break;
+            case OLED_UI_BIG_NUMBER:
+                draw_number(w, &next[i], full[i]);
+                w->number.shown_x10 = w->number.value_x10;
+                break;
+            case OLED_UI_ICON:
+                w->icon.draw(w->box.x0, w->box.y0);
+                break;
+            }
+        }
+        w->drawn = next[i];
+        w->dirty = false;
+    }
+}
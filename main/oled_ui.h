@@ -0,0 +1,115 @@
+#ifndef OLED_UI_H
+#define OLED_UI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Camada de UI retida do display: cada widget guarda seu valor, a área que
+ * ocupa na tela e um flag de alteração. A task só atribui valores; a cada
+ * oled_ui_render() são desenhados apenas os widgets alterados (texto: só os
+ * caracteres que mudaram) e apagadas só as sobras da área antiga.
+ *
+ * Widgets são desenhados na ordem de registro; quando a área apagada ou
+ * redesenhada de um widget cruza outro (em páginas de 8 linhas, unidade de
+ * escrita do SSD1306), esse outro também é redesenhado por inteiro.
+ */
+
+#define OLED_UI_MAX_WIDGETS     12
+#define OLED_UI_TEXT_MAX        24
+
+typedef enum {
+    OLED_UI_TEXT,
+    OLED_UI_BIG_NUMBER,     // valor x10 em dígitos 16x32 + coluna [unidade / .decimal]
+    OLED_UI_ICON,
+} oled_ui_type_t;
+
+typedef enum {
+    OLED_UI_ALIGN_LEFT,
+    OLED_UI_ALIGN_CENTER,
+    OLED_UI_ALIGN_RIGHT,
+} oled_ui_align_t;
+
+// Retângulo em pixels, limites inclusivos; vazio quando x1 < x0
+typedef struct {
+    int16_t x0, y0, x1, y1;
+} oled_ui_rect_t;
+
+typedef struct {
+    oled_ui_type_t type;
+    oled_ui_rect_t box;         // área reservada: referência de alinhamento e limite
+    oled_ui_rect_t drawn;       // área ocupada na tela pelo último desenho
+    bool visible;
+    bool dirty;
+    union {
+        struct {
+            const uint8_t *font;
+            uint8_t char_w;
+            uint8_t char_h;
+            oled_ui_align_t align;
+            char value[OLED_UI_TEXT_MAX];
+            char shown[OLED_UI_TEXT_MAX];
+        } text;
+        struct {
+            int16_t value_x10;
+            int16_t shown_x10;
+            const char *unit;
+            void (*unit_icon)(int x, int y);   // desenhado antes da unidade (ex.: °)
+        } number;
+        struct {
+            void (*draw)(int x, int y);        // recebe o canto superior esquerdo de box
+        } icon;
+    };
+} oled_ui_widget_t;
+
+/**
+ * @brief Widget de texto em fonte fixa, alinhado dentro de [x0, x1] na linha y
+ */
+void oled_ui_text_init(oled_ui_widget_t *w, int x0, int y, int x1, const uint8_t *font,
+                       uint8_t char_w, uint8_t char_h, oled_ui_align_t align);
+
+/**
+ * @brief Número grande centralizado em [x0, x1], ocupando 32 linhas a partir de y
+ * @param unit Texto da unidade no topo da coluna à direita dos dígitos
+ * @param unit_icon Desenho opcional antes da unidade (4 px de largura), ou NULL
+ */
+void oled_ui_number_init(oled_ui_widget_t *w, int x0, int y, int x1, const char *unit,
+                         void (*unit_icon)(int x, int y));
+
+/**
+ * @brief Ícone desenhado por função própria; a área box é apagada ao ocultar
+ */
+void oled_ui_icon_init(oled_ui_widget_t *w, int x0, int y0, int x1, int y1,
+                       void (*draw)(int x, int y));
+
+/**
+ * @brief Registra o widget para oled_ui_render() (ordem de registro = ordem de desenho)
+ */
+void oled_ui_add(oled_ui_widget_t *w);
+
+/**
+ * @brief Atribui texto; marca alteração só se diferente do atual
+ */
+void oled_ui_text_set(oled_ui_widget_t *w, const char *text);
+
+/**
+ * @brief Atribui valor x10; marca alteração só se diferente do atual
+ */
+void oled_ui_number_set(oled_ui_widget_t *w, int16_t value_x10);
+
+/**
+ * @brief Mostra ou oculta o widget (oculto: área apagada no próximo render)
+ */
+void oled_ui_set_visible(oled_ui_widget_t *w, bool visible);
+
+/**
+ * @brief Desenha os widgets alterados desde o último render
+ */
+void oled_ui_render(void);
+
+/**
+ * @brief Considera a tela apagada: todos os widgets visíveis são redesenhados no próximo render
+ */
+void oled_ui_invalidate(void);
+
+#endif // OLED_UI_H
@@ -0,0 +1,101 @@
+#include "sampling_policy.h"
+#include "globals.h"
+#include "config.h"
+#include "sensor_table.h"
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+
+// Patamares de ocupação do backlog, do mais alto para o mais baixo
+static const struct {
+    uint8_t fill_pct;
+    uint32_t interval_ms;
+} storage_levels[] = {
+    { ADAPTIVE_FILL_PCT_3, ADAPTIVE_INTERVAL_MS_3 },
+    { ADAPTIVE_FILL_PCT_2, ADAPTIVE_INTERVAL_MS_2 },
+    { ADAPTIVE_FILL_PCT_1, ADAPTIVE_INTERVAL_MS_1 },
+};
+
+static sampling_decision_t decisions[SENSOR_MAX_COUNT];
+
+// Referência do detector de estabilidade (última amostra fora da faixa)
+static int16_t ref_temp[SENSOR_MAX_COUNT];
+static int16_t ref_hum[SENSOR_MAX_COUNT];
+static bool has_ref[SENSOR_MAX_COUNT];
+
+void sampling_policy_init(void) {
+    memset(decisions, 0, sizeof(decisions));
+    memset(has_ref, 0, sizeof(has_ref));
+    for (size_t i = 0; i < sensor_count; i++) {
+        decisions[i].base_ms = sensor_table[i].interval_ms;
+        decisions[i].interval_ms = sensor_table[i].interval_ms;
+    }
+}
+
+void sampling_policy_observe(size_t idx, const measurement_data_t *m) {
+    if (m->quality & (MEAS_QUALITY_MISSING | MEAS_QUALITY_STALE)) {
+        return;
+    }
+    sampling_decision_t *d = &decisions[idx];
+    if (has_ref[idx] &&
+        abs(m->temperature_x10 - ref_temp[idx]) <= ADAPTIVE_STABLE_TEMP_X10 &&
+        abs(m->humidity_x10 - ref_hum[idx]) <= ADAPTIVE_STABLE_HUM_X10) {
+        if (d->stable_count < UINT16_MAX) {
+            d->stable_count++;
+        }
+        return;
+    }
+    // Valor saiu da faixa: nova referência, estabilidade recomeça
+    ref_temp[idx] = m->temperature_x10;
+    ref_hum[idx] = m->humidity_x10;
+    has_ref[idx] = true;
+    d->stable_count = 0;
+}
+
+uint32_t sampling_policy_next_interval(size_t idx) {
+    sampling_decision_t *d = &decisions[idx];
+    uint32_t interval = d->base_ms;
+    uint8_t reasons = 0;
+
+    d->link_up = (xEventGroupGetBits(system_event_group) & MQTT_CONNECTED_BIT) != 0;
+    d->fill_pct = (uint8_t)((ring_idx.count * 100U) / MAX_MEASUREMENTS_BUFFER);
+
+    if (ADAPTIVE_SAMPLING_ENABLED && !d->link_up) {
+        for (size_t l = 0; l < sizeof(storage_levels) / sizeof(storage_levels[0]); l++) {
+            if (d->fill_pct >= storage_levels[l].fill_pct) {
+                if (storage_levels[l].interval_ms > interval) {
+                    interval = storage_levels[l].interval_ms;
+                    reasons |= SAMPLING_REASON_STORAGE;
+                }
+                break;
+            }
+        }
+        if (d->stable_count >= ADAPTIVE_STABLE_SAMPLES) {
+            interval *= ADAPTIVE_STABLE_FACTOR;
+            reasons |= SAMPLING_REASON_STABLE;
+        }
+        if (interval > ADAPTIVE_MAX_INTERVAL_MS) {
+            interval = (d->base_ms > ADAPTIVE_MAX_INTERVAL_MS) ? d->base_ms : ADAPTIVE_MAX_INTERVAL_MS;
+        }
+    }
+
+    if (interval != d->interval_ms) {
+        d->changes++;
+        ESP_LOGI(TAG, "%s: sampling interval %u -> %u ms (link %s, backlog %u%%, stable %u%s%s)",
+                 sensor_table[idx].sensor_id, d->interval_ms, interval,
+                 d->link_up ? "up" : "down", d->fill_pct, d->stable_count,
+                 (reasons & SAMPLING_REASON_STORAGE) ? ", storage" : "",
+                 (reasons & SAMPLING_REASON_STABLE) ? ", stable" : "");
+    }
+    d->interval_ms = interval;
+    d->reasons = reasons;
+    return interval;
+}
+
+uint32_t sampling_policy_current(size_t idx) {
+    return decisions[idx].interval_ms;
+}
+
+void sampling_policy_get(size_t idx, sampling_decision_t *out) {
+    *out = decisions[idx];
+}
@@ -0,0 +1,60 @@
+#ifndef SAMPLING_POLICY_H
+#define SAMPLING_POLICY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "types.h"
+
+// Motivos do intervalo efetivo (bitmask)
+#define SAMPLING_REASON_STORAGE     0x01    // backlog do SPIFFS acima de um patamar
+#define SAMPLING_REASON_STABLE      0x02    // valores estáveis há ADAPTIVE_STABLE_SAMPLES amostras
+
+// Última decisão do controlador para um sensor
+typedef struct {
+    uint32_t base_ms;         // intervalo configurado em sensor_table
+    uint32_t interval_ms;     // intervalo efetivo em uso
+    uint8_t reasons;          // SAMPLING_REASON_* (0 = intervalo configurado)
+    uint8_t fill_pct;         // ocupação do backlog na decisão
+    bool link_up;             // MQTT conectado na decisão
+    uint16_t stable_count;    // amostras seguidas dentro da faixa de estabilidade
+    uint32_t changes;         // decisões que mudaram o intervalo
+} sampling_decision_t;
+
+/**
+ * @brief Inicializa o controlador com os intervalos de sensor_table
+ */
+void sampling_policy_init(void);
+
+/**
+ * @brief Atualiza o detector de estabilidade com uma amostra do sensor
+ * @param idx Índice do sensor em sensor_table
+ * @param m Amostra (MISSING/STALE são ignoradas)
+ */
+void sampling_policy_observe(size_t idx, const measurement_data_t *m);
+
+/**
+ * @brief Decide o intervalo até a próxima amostra do sensor
+ *
+ * Com MQTT conectado o intervalo é sempre o configurado. Sem conexão, o
+ * intervalo sobe com a ocupação do backlog e com valores estáveis.
+ *
+ * @param idx Índice do sensor em sensor_table
+ * @return Intervalo efetivo em ms
+ */
+uint32_t sampling_policy_next_interval(size_t idx);
+
+/**
+ * @brief Intervalo efetivo atual do sensor (o usado para agendar a amostra corrente)
+ * @param idx Índice do sensor em sensor_table
+ */
+uint32_t sampling_policy_current(size_t idx);
+
+/**
+ * @brief Copia a última decisão do controlador para um sensor
+ * @param idx Índice do sensor em sensor_table
+ * @param out Destino da decisão
+ */
+void sampling_policy_get(size_t idx, sampling_decision_t *out);
+
+#endif // SAMPLING_POLICY_H
@@ -0,0 +1,214 @@
+#include "sensor_pipeline.h"
+#include "globals.h"
+#include "types.h"
+#include "fixed_point.h"
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+
+// Histórico de leituras válidas (mediana) e estado do EMA
+static void filter_push(sensor_pipeline_t *p, int16_t t, int16_t h) {
+    p->temp_hist[p->hist_pos] = t;
+    p->hum_hist[p->hist_pos] = h;
+    p->hist_pos = (p->hist_pos + 1) % SENSOR_FILTER_WINDOW;
+    if (p->hist_len < SENSOR_FILTER_WINDOW) {
+        p->hist_len++;
+    }
+
+    if (p->hist_len == 1) {
+        p->ema_temp_q8 = (int32_t)t << 8;
+        p->ema_hum_q8 = (int32_t)h << 8;
+    } else {
+        p->ema_temp_q8 += (SENSOR_EMA_ALPHA_PCT * (((int32_t)t << 8) - p->ema_temp_q8)) / 100;
+        p->ema_hum_q8 += (SENSOR_EMA_ALPHA_PCT * (((int32_t)h << 8) - p->ema_hum_q8)) / 100;
+    }
+}
+
+static void filter_reset(sensor_pipeline_t *p) {
+    p->hist_len = 0;
+    p->hist_pos = 0;
+}
+
+static int16_t median_of(const int16_t *values, uint8_t len) {
+    int16_t sorted[SENSOR_FILTER_WINDOW];
+    memcpy(sorted, values, len * sizeof(int16_t));
+    // Insertion sort: janela de no máximo 9 elementos
+    for (uint8_t i = 1; i < len; i++) {
+        int16_t v = sorted[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+    if (len % 2) {
+        return sorted[len / 2];
+    }
+    return (int16_t)((sorted[len / 2 - 1] + sorted[len / 2]) / 2);
+}
+
+// Saída do filtro configurado; retorna true se combinou mais de uma leitura
+static bool filter_output(const sensor_pipeline_t *p, int16_t *t, int16_t *h) {
+#if SENSOR_FILTER_MODE == SENSOR_FILTER_MEDIAN
+    *t = median_of(p->temp_hist, p->hist_len);
+    *h = median_of(p->hum_hist, p->hist_len);
+    return p->hist_len > 1;
+#elif SENSOR_FILTER_MODE == SENSOR_FILTER_EMA
+    *t = fixed_q8_round(p->ema_temp_q8);
+    *h = fixed_q8_round(p->ema_hum_q8);
+    return p->hist_len > 1;
+#else
+    *t = p->last_temp;
+    *h = p->last_hum;
+    return false;
+#endif
+}
+
+// Respeitar o intervalo mínimo entre leituras do mesmo sensor
+static void wait_min_interval(const sensor_pipeline_t *p) {
+    if (!p->has_read) {
+        return;
+    }
+    TickType_t min_ticks = pdMS_TO_TICKS(p->min_interval_ms);
+    TickType_t elapsed = xTaskGetTickCount() - p->last_read_tick;
+    if (elapsed < min_ticks) {
+        vTaskDelay(min_ticks - elapsed);
+    }
+}
+
+// Verificações de plausibilidade e taxa de variação
+static bool validate_reading(sensor_pipeline_t *p, int16_t t, int16_t h) {
+    if (t < SENSOR_TEMP_MIN_X10 || t > SENSOR_TEMP_MAX_X10 ||
+        h < SENSOR_HUM_MIN_X10 || h > SENSOR_HUM_MAX_X10) {
+        p->stats.rejected_range++;
+        ESP_LOGW(TAG, "Sensor GPIO%d: implausible reading rejected (T=" FIXED_X10_FMT ", H=" FIXED_X10_FMT ")",
+                 p->pin, FIXED_X10_ARGS(t), FIXED_X10_ARGS(h));
+        return false;
+    }
+
+    if (!p->has_last) {
+        return true;
+    }
+
+    uint32_t elapsed_ms = (xTaskGetTickCount() - p->last_ok_tick) * portTICK_PERIOD_MS;
+    int32_t max_dt = (int32_t)(((uint64_t)SENSOR_MAX_TEMP_RATE_X10 * elapsed_ms) / 60000U);
+    int32_t max_dh = (int32_t)(((uint64_t)SENSOR_MAX_HUM_RATE_X10 * elapsed_ms) / 60000U);
+    if (max_dt < SENSOR_MIN_TEMP_STEP_X10) {
+        max_dt = SENSOR_MIN_TEMP_STEP_X10;
+    }
+    if (max_dh < SENSOR_MIN_HUM_STEP_X10) {
+        max_dh = SENSOR_MIN_HUM_STEP_X10;
+    }
+
+    if (abs(t - p->last_temp) <= max_dt && abs(h - p->last_hum) <= max_dh) {
+        p->rate_rejects = 0;
+        return true;
+    }
+
+    // Variações persistentes são degraus reais, não ruído: aceitar e reiniciar o filtro
+    if (++p->rate_rejects >= SENSOR_RATE_REJECT_LIMIT) {
+        ESP_LOGW(TAG, "Sensor GPIO%d: step change persisted for %d reads, accepting (T=" FIXED_X10_FMT ", H=" FIXED_X10_FMT ")",
+                 p->pin, p->rate_rejects, FIXED_X10_ARGS(t), FIXED_X10_ARGS(h));
+        p->rate_rejects = 0;
+        filter_reset(p);
+        return true;
+    }
+
+    p->stats.rejected_rate++;
+    ESP_LOGW(TAG, "Sensor GPIO%d: rate-of-change check failed (T=" FIXED_X10_FMT "->" FIXED_X10_FMT
+             ", H=" FIXED_X10_FMT "->" FIXED_X10_FMT ")",
+             p->pin, FIXED_X10_ARGS(p->last_temp), FIXED_X10_ARGS(t),
+             FIXED_X10_ARGS(p->last_hum), FIXED_X10_ARGS(h));
+    return false;
+}
+
+void sensor_pipeline_init(sensor_pipeline_t *p, dht_sensor_type_t type, gpio_num_t pin) {
+    memset(p, 0, sizeof(*p));
+    p->type = type;
+    p->pin = pin;
+    // Si7021 não tem restrição de intervalo documentada; usar o limite conservador do DHT11
+    p->min_interval_ms = (type == DHT_TYPE_AM2301) ? DHT22_MIN_INTERVAL_MS : DHT11_MIN_INTERVAL_MS;
+}
+
+uint8_t sensor_pipeline_acquire(sensor_pipeline_t *p, int16_t *temperature_x10, int16_t *humidity_x10, uint8_t *retries) {
+    uint8_t quality = MEAS_QUALITY_OK;
+    uint8_t retries_done = 0;
+    uint8_t good_reads = 0;
+    int64_t cpu_us = 0;
+
+    while (good_reads < SENSOR_OVERSAMPLE) {
+        wait_min_interval(p);
+
+        // O driver entrega décimos diretamente; nenhuma conversão para float
+        int16_t t = 0;
+        int16_t h = 0;
+        int64_t bus_start = esp_timer_get_time();
+        esp_err_t err = dht_read_data(p->type, p->pin, &h, &t);
+        int64_t bus_end = esp_timer_get_time();
+        p->stats.bus_us_last = (uint32_t)(bus_end - bus_start);
+        p->last_read_tick = xTaskGetTickCount();
+        p->has_read = true;
+        p->stats.reads++;
+
+        bool accepted = (err == ESP_OK) && validate_reading(p, t, h);
+        if (accepted) {
+            p->last_temp = t;
+            p->last_hum = h;
+            p->last_ok_tick = p->last_read_tick;
+            p->has_last = true;
+            filter_push(p, t, h);
+            good_reads++;
+        }
+        cpu_us += esp_timer_get_time() - bus_end;
+        if (accepted) {
+            continue;
+        }
+
+        if (err != ESP_OK) {
+            p->stats.read_failures++;
+            ESP_LOGW(TAG, "Sensor GPIO%d read failed (%s), retry %d/%d",
+                     p->pin, esp_err_to_name(err), retries_done, SENSOR_READ_RETRIES);
+        }
+        if (retries_done >= SENSOR_READ_RETRIES) {
+            break;
+        }
+        retries_done++;
+    }
+
+    int64_t out_start = esp_timer_get_time();
+    p->stats.samples++;
+    *retries = retries_done;
+    if (retries_done > 0) {
+        quality |= MEAS_QUALITY_RETRIED;
+        p->stats.retried++;
+    }
+
+    if (good_reads > 0) {
+        if (filter_output(p, temperature_x10, humidity_x10)) {
+            quality |= MEAS_QUALITY_FILTERED;
+        }
+    } else {
+        TickType_t age = xTaskGetTickCount() - p->last_ok_tick;
+        if (p->has_last && age <= pdMS_TO_TICKS(SENSOR_STALE_MAX_MS)) {
+            // Repetir a última saída do filtro, sinalizada como "stale"
+            filter_output(p, temperature_x10, humidity_x10);
+            p->stats.stale++;
+            quality |= MEAS_QUALITY_STALE;
+        } else {
+            *temperature_x10 = MEAS_VALUE_INVALID;
+            *humidity_x10 = MEAS_VALUE_INVALID;
+            p->stats.missing++;
+            quality |= MEAS_QUALITY_MISSING;
+        }
+    }
+
+    cpu_us += esp_timer_get_time() - out_start;
+    p->stats.cpu_us_last = (uint32_t)cpu_us;
+    if (p->stats.cpu_us_last > p->stats.cpu_us_max) {
+        p->stats.cpu_us_max = p->stats.cpu_us_last;
+    }
+    return quality;
+}
@@ -0,0 +1,76 @@
+#ifndef SENSOR_PIPELINE_H
+#define SENSOR_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "dht.h"
+#include "config.h"
+
+// Contadores do pipeline (leituras por amostra = reads / samples)
+typedef struct {
+    uint32_t samples;         // amostras reportadas
+    uint32_t reads;           // leituras físicas no barramento do sensor
+    uint32_t read_failures;   // leituras com erro do driver (timeout/CRC)
+    uint32_t rejected_range;  // leituras fora da faixa plausível
+    uint32_t rejected_rate;   // leituras com variação acima da taxa máxima
+    uint32_t retried;         // amostras que precisaram de novas tentativas
+    uint32_t stale;           // amostras reportadas com o último valor válido
+    uint32_t missing;         // amostras sem valor válido
+    uint32_t bus_us_last;     // duração da última leitura no barramento (interrupções desabilitadas)
+    uint32_t cpu_us_last;     // processamento da última amostra (validação + filtro), sem barramento/esperas
+    uint32_t cpu_us_max;
+} sensor_pipeline_stats_t;
+
+// Estado de aquisição de um sensor DHT
+typedef struct {
+    dht_sensor_type_t type;
+    gpio_num_t pin;
+    uint32_t min_interval_ms;
+
+    // Histórico de leituras válidas para o filtro de mediana (décimos)
+    int16_t temp_hist[SENSOR_FILTER_WINDOW];
+    int16_t hum_hist[SENSOR_FILTER_WINDOW];
+    uint8_t hist_len;
+    uint8_t hist_pos;
+
+    // Estado do filtro exponencial (décimos em Q8)
+    int32_t ema_temp_q8;
+    int32_t ema_hum_q8;
+
+    // Última leitura aceita (base para taxa de variação e valores "stale")
+    int16_t last_temp;
+    int16_t last_hum;
+    bool has_last;
+    TickType_t last_ok_tick;
+    TickType_t last_read_tick;
+    bool has_read;
+    uint8_t rate_rejects;
+
+    sensor_pipeline_stats_t stats;
+} sensor_pipeline_t;
+
+/**
+ * @brief Inicializa o estado de aquisição de um sensor
+ * @param p Estado do pipeline
+ * @param type Tipo do sensor (DHT11, AM2301/DHT22, SI7021)
+ * @param pin GPIO conectado ao sensor
+ */
+void sensor_pipeline_init(sensor_pipeline_t *p, dht_sensor_type_t type, gpio_num_t pin);
+
+/**
+ * @brief Obtém uma amostra: leituras com retry limitado, validação e filtro
+ *
+ * Bloqueia entre tentativas para respeitar o intervalo mínimo do sensor.
+ * Nunca fabrica valores: sem leitura válida, devolve o último valor (STALE)
+ * ou marca a amostra como MISSING.
+ *
+ * @param p Estado do pipeline
+ * @param[out] temperature_x10 Temperatura em décimos de °C (MEAS_VALUE_INVALID se ausente)
+ * @param[out] humidity_x10 Umidade relativa em décimos de % (MEAS_VALUE_INVALID se ausente)
+ * @param[out] retries Novas tentativas realizadas nesta amostra
+ * @return Flags measurement_quality_t da amostra
+ */
+uint8_t sensor_pipeline_acquire(sensor_pipeline_t *p, int16_t *temperature_x10, int16_t *humidity_x10, uint8_t *retries);
+
+#endif // SENSOR_PIPELINE_H
@@ -0,0 +1,16 @@
+#include "sensor_table.h"
+#include "config.h"
+
+// Sensores do nó. A entrada 0 é o sensor principal exibido no OLED e em /data.
+// Cada sensor deve usar um GPIO próprio; as leituras são escalonadas pela measurement_task.
+const sensor_config_t sensor_table[] = {
+    { SENSOR_ID, DHT_TYPE_AM2301, DHT22_PIN, MEASUREMENT_INTERVAL_MS },
+    // Exemplos de sensores adicionais:
+    // { "TEMP_HUM_002", DHT_TYPE_AM2301, 5,  MEASUREMENT_INTERVAL_MS },
+    // { "TEMP_HUM_003", DHT_TYPE_DHT11,  13, 30000 },
+};
+
+const size_t sensor_count = sizeof(sensor_table) / sizeof(sensor_table[0]);
+
+_Static_assert(sizeof(sensor_table) / sizeof(sensor_table[0]) <= SENSOR_MAX_COUNT,
+               "sensor_table exceeds SENSOR_MAX_COUNT");
@@ -0,0 +1,23 @@
+#ifndef SENSOR_TABLE_H
+#define SENSOR_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dht.h"
+
+// Número máximo de sensores por nó
+#define SENSOR_MAX_COUNT            8
+
+// Configuração estática de um sensor do nó
+typedef struct {
+    const char *sensor_id;      // identificador publicado em cada registro (máx. 15 caracteres)
+    dht_sensor_type_t type;     // DHT_TYPE_DHT11, DHT_TYPE_AM2301 ou DHT_TYPE_SI7021
+    gpio_num_t pin;             // GPIO do sinal de dados
+    uint32_t interval_ms;       // intervalo entre amostras deste sensor
+} sensor_config_t;
+
+// Tabela de sensores (definida em sensor_table.c); a entrada 0 é o sensor principal
+extern const sensor_config_t sensor_table[];
+extern const size_t sensor_count;
+
+#endif // SENSOR_TABLE_H
@@ -8,6 +8,48 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 
+// Backlog de alarmes: arquivo pequeno, regravado inteiro a cada alteração
+#define ALARM_BACKLOG_VERSION       3
+
+typedef struct {
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    alarm_event_t events[ALARM_BACKLOG_LEN];   // events[0] é o mais antigo
+} alarm_backlog_t;
+
+static alarm_backlog_t alarm_backlog;
+
+static void load_alarm_backlog(void) {
+    FILE* f = fopen(ALARMS_FILE, "rb");
+    size_t read = 0;
+    if (f != NULL) {
+        read = fread(&alarm_backlog, sizeof(alarm_backlog), 1, f);
+        fclose(f);
+    }
+    if (read != 1 || alarm_backlog.version != ALARM_BACKLOG_VERSION ||
+        alarm_backlog.record_size != sizeof(alarm_event_t) ||
+        alarm_backlog.count > ALARM_BACKLOG_LEN) {
+        memset(&alarm_backlog, 0, sizeof(alarm_backlog));
+        alarm_backlog.version = ALARM_BACKLOG_VERSION;
+        alarm_backlog.record_size = sizeof(alarm_event_t);
+    }
+    if (alarm_backlog.count > 0) {
+        ESP_LOGI(TAG, "Stored alarm events: %u", alarm_backlog.count);
+    }
+}
+
+static esp_err_t save_alarm_backlog(void) {
+    FILE* f = fopen(ALARMS_FILE, "wb");
+    if (f == NULL) {
+        ESP_LOGE(TAG, "Failed to open alarms file for writing");
+        return ESP_FAIL;
+    }
+    size_t written = fwrite(&alarm_backlog, sizeof(alarm_backlog), 1, f);
+    fclose(f);
+    return (written == 1) ? ESP_OK : ESP_FAIL;
+}
+
 esp_err_t spiffs_init(void) {
     if (spiffs_initialized) {
         return ESP_OK;
@@ -40,8 +82,9 @@ esp_err_t spiffs_init(void) {
         return ESP_FAIL;
     }
 
-    // Carregar índice
+    // Carregar índice e backlog de alarmes
     load_spiffs_index();
+    load_alarm_backlog();
     spiffs_initialized = true;
     
     ESP_LOGI(TAG, "SPIFFS initialized. Stored measurements: %d", ring_idx.count);
@@ -53,15 +96,22 @@ esp_err_t load_spiffs_index(void) {
     if (f == NULL) {
         ESP_LOGI(TAG, "No index file found, creating new");
         memset(&ring_idx, 0, sizeof(spiffs_ring_index_t));
+        ring_idx.version = SPIFFS_RECORD_VERSION;
+        ring_idx.record_size = sizeof(measurement_data_t);
         return save_spiffs_index();
     }
 
     size_t read = fread(&ring_idx, sizeof(spiffs_ring_index_t), 1, f);
     fclose(f);
 
-    if (read != 1 || ring_idx.count > MAX_MEASUREMENTS_BUFFER) {
-        ESP_LOGW(TAG, "Invalid index, resetting");
+    // Índices de versões anteriores têm outro tamanho/versão: registros antigos são ilegíveis
+    if (read != 1 || ring_idx.count > MAX_MEASUREMENTS_BUFFER ||
+        ring_idx.version != SPIFFS_RECORD_VERSION ||
+        ring_idx.record_size != sizeof(measurement_data_t)) {
+        ESP_LOGW(TAG, "Invalid or outdated index (record format v%d expected), resetting", SPIFFS_RECORD_VERSION);
         memset(&ring_idx, 0, sizeof(spiffs_ring_index_t));
+        ring_idx.version = SPIFFS_RECORD_VERSION;
+        ring_idx.record_size = sizeof(measurement_data_t);
         return save_spiffs_index();
     }
 
@@ -109,35 +159,8 @@ esp_err_t spiffs_store_measurement(const measurement_data_t* measurement) {
         goto cleanup;
     }
 
-    /*
-     * Before writing, normalize timestamp if it appears to be uptime-based
-     * and system time is synced: convert uptime seconds/ms to epoch seconds.
-     */
-    measurement_data_t local = *measurement; // local copy we can modify
-    uint32_t raw_ts = measurement->timestamp;
-    uint32_t ts = raw_ts;
-    uint32_t uptime_s = (xTaskGetTickCount() * portTICK_PERIOD_MS) / 1000U;
-    time_t now = time(NULL);
-
-    if (ts != 0 && time_synced) {
-        if (ts <= uptime_s + 60U) {
-            // timestamp looks like uptime in seconds
-            uint32_t delta = uptime_s - ts;
-            uint32_t new_ts = (uint32_t)now - delta;
-            ESP_LOGI(TAG, "Normalizing stored timestamp from uptime_s=%u to epoch=%u", ts, new_ts);
-            local.timestamp = new_ts;
-        } else if (ts > uptime_s * 1000U && (ts / 1000U) <= uptime_s) {
-            // timestamp looks like uptime in milliseconds
-            uint32_t stored_uptime_s = ts / 1000U;
-            uint32_t delta = uptime_s - stored_uptime_s;
-            uint32_t new_ts = (uint32_t)now - delta;
-            ESP_LOGI(TAG, "Normalizing stored timestamp from uptime_ms=%u to epoch=%u", ts, new_ts);
-            local.timestamp = new_ts;
-        }
-    }
-
-    // Escrever medição (usando cópia local possivelmente normalizada)
-    if (fwrite(&local, sizeof(measurement_data_t), 1, f) != 1) {
+    // Escrever medição (horário fica em boot_id + uptime_ms, resolvido no drain)
+    if (fwrite(measurement, sizeof(measurement_data_t), 1, f) != 1) {
         ESP_LOGE(TAG, "Failed to write measurement");
         ret = ESP_FAIL;
         goto cleanup;
@@ -357,11 +380,146 @@ cleanup:
     return ret;
 }
 
+void spiffs_measurement_range(uint32_t *first, uint32_t *end) {
+    *first = 0;
+    *end = 0;
+    if (!spiffs_initialized || xSemaphoreTake(spiffs_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        return;
+    }
+    *end = ring_idx.total_written;
+    *first = ring_idx.total_written - ring_idx.count;
+    xSemaphoreGive(spiffs_mutex);
+}
+
+size_t spiffs_read_measurements(uint32_t *pos, uint32_t end, measurement_data_t *buf, size_t max) {
+    if (!spiffs_initialized || buf == NULL) {
+        return 0;
+    }
+
+    if (xSemaphoreTake(spiffs_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        return 0;
+    }
+
+    // Posições contam registros escritos; o mais antigo ainda guardado está no tail
+    uint32_t first = ring_idx.total_written - ring_idx.count;
+    if ((int32_t)(*pos - first) < 0) {
+        *pos = first;
+    }
+    if ((int32_t)(end - ring_idx.total_written) > 0) {
+        end = ring_idx.total_written;
+    }
+
+    size_t n = 0;
+    FILE* f = NULL;
+    while (n < max && (int32_t)(end - *pos) > 0) {
+        uint32_t slot = (ring_idx.tail + (*pos - first)) % MAX_MEASUREMENTS_BUFFER;
+        // Trecho contíguo no arquivo: até o fim do lote, do intervalo ou do ring
+        size_t run = max - n;
+        if (run > end - *pos) {
+            run = end - *pos;
+        }
+        if (run > MAX_MEASUREMENTS_BUFFER - slot) {
+            run = MAX_MEASUREMENTS_BUFFER - slot;
+        }
+        if (f == NULL && (f = fopen(MEASUREMENTS_FILE, "rb")) == NULL) {
+            ESP_LOGE(TAG, "Failed to open measurements file");
+            break;
+        }
+        if (fseek(f, slot * sizeof(measurement_data_t), SEEK_SET) != 0) {
+            ESP_LOGE(TAG, "Failed to seek file position");
+            break;
+        }
+        size_t got = fread(&buf[n], sizeof(measurement_data_t), run, f);
+        n += got;
+        *pos += got;
+        if (got < run) {
+            ESP_LOGE(TAG, "Failed to read measurements");
+            break;
+        }
+    }
+
+    if (f != NULL) {
+        fclose(f);
+    }
+    xSemaphoreGive(spiffs_mutex);
+    return n;
+}
+
+esp_err_t spiffs_store_alarm(const alarm_event_t *event) {
+    if (!spiffs_initialized || event == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (xSemaphoreTake(spiffs_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    if (alarm_backlog.count >= ALARM_BACKLOG_LEN) {
+        ESP_LOGW(TAG, "Alarm backlog full, dropping oldest event %u", alarm_backlog.events[0].event_id);
+        memmove(&alarm_backlog.events[0], &alarm_backlog.events[1],
+                (ALARM_BACKLOG_LEN - 1) * sizeof(alarm_event_t));
+        alarm_backlog.count--;
+    }
+    alarm_backlog.events[alarm_backlog.count++] = *event;
+    esp_err_t ret = save_alarm_backlog();
+
+    ESP_LOGI(TAG, "Stored alarm event %u in SPIFFS. Alarms: %u/%d",
+             event->event_id, alarm_backlog.count, ALARM_BACKLOG_LEN);
+
+    xSemaphoreGive(spiffs_mutex);
+    return ret;
+}
+
+esp_err_t spiffs_peek_alarm(alarm_event_t *event) {
+    if (!spiffs_initialized || event == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (xSemaphoreTake(spiffs_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    if (alarm_backlog.count > 0) {
+        *event = alarm_backlog.events[0];
+        ret = ESP_OK;
+    }
+
+    xSemaphoreGive(spiffs_mutex);
+    return ret;
+}
+
+esp_err_t spiffs_remove_alarm(void) {
+    if (!spiffs_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (xSemaphoreTake(spiffs_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    if (alarm_backlog.count > 0) {
+        alarm_backlog.count--;
+        memmove(&alarm_backlog.events[0], &alarm_backlog.events[1],
+                alarm_backlog.count * sizeof(alarm_event_t));
+        ret = save_alarm_backlog();
+    }
+
+    xSemaphoreGive(spiffs_mutex);
+    return ret;
+}
+
+uint32_t spiffs_alarm_count(void) {
+    return alarm_backlog.count;
+}
+
 void spiffs_print_status(void) {
     ESP_LOGI(TAG, "=== SPIFFS Status ===");
     ESP_LOGI(TAG, "Stored measurements: %d/%d", ring_idx.count, MAX_MEASUREMENTS_BUFFER);
     ESP_LOGI(TAG, "Total written: %d", ring_idx.total_written);
     ESP_LOGI(TAG, "Head: %d, Tail: %d", ring_idx.head, ring_idx.tail);
+    ESP_LOGI(TAG, "Stored alarm events: %u/%d", alarm_backlog.count, ALARM_BACKLOG_LEN);
     
     if (ring_idx.count >= MAX_MEASUREMENTS_BUFFER * 0.8) {
         ESP_LOGW(TAG, "SPIFFS buffer is %d%% full!", 
@@ -56,6 +56,52 @@ esp_err_t spiffs_rollback_measurement(const measurement_data_t* measurement);
  */
 esp_err_t spiffs_remove_sent_measurement(void);
 
+/**
+ * @brief Posições dos registros guardados, em ordem de escrita: [*first, *end)
+ *
+ * A posição de um registro não muda enquanto ele estiver no buffer; os removidos
+ * (publicados ou sobrescritos) ficam antes de first.
+ */
+void spiffs_measurement_range(uint32_t *first, uint32_t *end);
+
+/**
+ * @brief Lê registros sem removê-los, a partir da posição *pos e antes de end
+ *
+ * O mutex só é segurado durante a leitura do lote, então quem grava e quem publica
+ * não esperam o consumidor. Registros removidos desde a última chamada são pulados.
+ * @param pos Posição do próximo registro; avança pelos registros lidos
+ * @param buf Destino de até max registros
+ * @return Registros lidos; 0 no fim do intervalo ou em erro
+ */
+size_t spiffs_read_measurements(uint32_t *pos, uint32_t end, measurement_data_t *buf, size_t max);
+
+/**
+ * @brief Guarda um evento de alarme no backlog de alarmes (prioritário)
+ *
+ * Backlog pequeno e separado das medições; cheio, descarta o evento mais antigo.
+ * @param event Evento a guardar
+ * @return ESP_OK se sucesso, código de erro caso contrário
+ */
+esp_err_t spiffs_store_alarm(const alarm_event_t *event);
+
+/**
+ * @brief Lê o evento de alarme mais antigo sem removê-lo
+ * @param event Destino do evento
+ * @return ESP_OK se sucesso, ESP_ERR_NOT_FOUND se o backlog está vazio
+ */
+esp_err_t spiffs_peek_alarm(alarm_event_t *event);
+
+/**
+ * @brief Remove o evento de alarme mais antigo (após publicação)
+ * @return ESP_OK se sucesso, código de erro caso contrário
+ */
+esp_err_t spiffs_remove_alarm(void);
+
+/**
+ * @brief Número de eventos de alarme guardados
+ */
+uint32_t spiffs_alarm_count(void);
+
 /**
  * @brief Imprime o status do SPIFFS
  */
@@ -2,6 +2,8 @@
 #include "globals.h"
 #include "config.h"
 #include "spiffs_manager.h"
+#include "measurement.h"
+#include "sensor_table.h"
 #include <time.h>
 #include <stdio.h>
 #include "esp_log.h"
@@ -28,6 +30,21 @@ void system_status_task(void *pvParameters) {
         ESP_LOGI(TAG, "State: %d", current_state);
         ESP_LOGI(TAG, "Time synced: %s", time_synced ? "YES" : "NO");
         ESP_LOGI(TAG, "Measurements generated: %u", measurement_counter);
+
+        for (size_t i = 0; i < sensor_count; i++) {
+            sensor_pipeline_stats_t ps;
+            measurement_get_pipeline_stats(i, &ps);
+            ESP_LOGI(TAG, "Sensor %s (GPIO%d): %u reads / %u samples, %u failures, %u rejected (range %u, rate %u), %u stale, %u missing",
+                     sensor_table[i].sensor_id, sensor_table[i].pin,
+                     ps.reads, ps.samples, ps.read_failures, ps.rejected_range + ps.rejected_rate,
+                     ps.rejected_range, ps.rejected_rate, ps.stale, ps.missing);
+
+            measurement_schedule_stats_t ss;
+            measurement_get_schedule_stats(i, &ss);
+            ESP_LOGI(TAG, "Schedule %s: %s, %u slots, %u overruns, jitter last=%d max=%d avg=%d us",
+                     sensor_table[i].sensor_id, ss.aligned ? "wall-clock aligned" : "uptime",
+                     ss.slots, ss.overruns, ss.last_jitter_us, ss.max_jitter_us, ss.avg_jitter_us);
+        }
         ESP_LOGI(TAG, "Client ID: %s", mqtt_client_id);
         
         // Yield antes de operações de Event Group
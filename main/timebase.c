@@ -0,0 +1,211 @@
+#include "timebase.h"
+#include "globals.h"
+#include "config.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define TIMEBASE_NVS_NAMESPACE      "timebase"
+#define TIMEBASE_NVS_KEY_BOOT       "boot_id"
+#define TIMEBASE_NVS_KEY_ANCHORS    "anchors"
+
+// Âncora de um boot: epoch UTC em ms correspondente ao uptime 0
+typedef struct {
+    int64_t epoch_ms;
+    uint16_t boot_id;
+    uint16_t valid;
+} timebase_anchor_t;
+
+// Indexado por boot_id % TIMEBASE_ANCHOR_SLOTS: boots consecutivos formam um anel
+static timebase_anchor_t anchors[TIMEBASE_ANCHOR_SLOTS];
+static uint16_t current_id = 0;
+static uint32_t current_segment = 0;    // voltas do uptime de 32 bits neste boot
+static bool current_anchored = false;
+// Âncora registrada só na RAM (callback do SNTP): timebase_save() grava no NVS
+static volatile bool anchors_dirty = false;
+
+static void save_anchors(void) {
+    timebase_anchor_t copy[TIMEBASE_ANCHOR_SLOTS];
+    portENTER_CRITICAL();
+    memcpy(copy, anchors, sizeof(copy));
+    portEXIT_CRITICAL();
+
+    nvs_handle handle;
+    esp_err_t err = nvs_open(TIMEBASE_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(handle, TIMEBASE_NVS_KEY_ANCHORS, copy, sizeof(copy));
+        if (err == ESP_OK) {
+            err = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to persist time anchors: %s", esp_err_to_name(err));
+    }
+}
+
+// Próximo boot_id persistido no NVS (também usado na volta do uptime)
+static uint16_t alloc_boot_id(void) {
+    nvs_handle handle;
+    uint16_t id = 0;
+    esp_err_t err = nvs_open(TIMEBASE_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err == ESP_OK) {
+        nvs_get_u16(handle, TIMEBASE_NVS_KEY_BOOT, &id);   // ausente: primeiro boot
+        id++;
+        err = nvs_set_u16(handle, TIMEBASE_NVS_KEY_BOOT, id);
+        if (err == ESP_OK) {
+            err = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to persist boot id: %s", esp_err_to_name(err));
+    }
+    return id;
+}
+
+static void set_anchor(uint16_t boot_id, int64_t epoch_ms) {
+    timebase_anchor_t *a = &anchors[boot_id % TIMEBASE_ANCHOR_SLOTS];
+    portENTER_CRITICAL();
+    a->epoch_ms = epoch_ms;
+    a->boot_id = boot_id;
+    a->valid = 1;
+    portEXIT_CRITICAL();
+}
+
+void timebase_init(void) {
+    nvs_handle handle;
+    size_t len = sizeof(anchors);
+    memset(anchors, 0, sizeof(anchors));
+    if (nvs_open(TIMEBASE_NVS_NAMESPACE, NVS_READONLY, &handle) == ESP_OK) {
+        if (nvs_get_blob(handle, TIMEBASE_NVS_KEY_ANCHORS, anchors, &len) != ESP_OK || len != sizeof(anchors)) {
+            memset(anchors, 0, sizeof(anchors));
+        }
+        nvs_close(handle);
+    }
+
+    current_id = alloc_boot_id();
+    current_segment = 0;
+    current_anchored = false;
+
+    // O slot deste boot pode guardar a âncora de um boot antigo
+    timebase_anchor_t *a = &anchors[current_id % TIMEBASE_ANCHOR_SLOTS];
+    if (a->valid && a->boot_id != current_id) {
+        a->valid = 0;
+    }
+    ESP_LOGI(TAG, "Time base: boot id %u", current_id);
+}
+
+void timebase_now(uint16_t *boot_id, uint32_t *uptime_ms) {
+    uint64_t up_ms = (uint64_t)esp_timer_get_time() / 1000U;
+    uint32_t segment = (uint32_t)(up_ms >> 32);
+
+    if (segment != current_segment) {
+        // Uptime de 32 bits voltou a zero: novo boot_id, mesma âncora deslocada
+        uint16_t prev_id = current_id;
+        int64_t prev_anchor = 0;
+        bool anchored = timebase_to_epoch_ms(prev_id, 0, &prev_anchor);
+        uint16_t id = alloc_boot_id();
+
+        portENTER_CRITICAL();
+        current_id = id;
+        current_anchored = false;
+        portEXIT_CRITICAL();
+        if (anchored) {
+            set_anchor(id, prev_anchor + ((int64_t)(segment - current_segment) << 32));
+            save_anchors();
+            current_anchored = true;
+        }
+        current_segment = segment;
+        ESP_LOGI(TAG, "Uptime wrapped: boot id %u -> %u (%s)", prev_id, id, anchored ? "anchored" : "unanchored");
+    }
+
+    *boot_id = current_id;
+    *uptime_ms = (uint32_t)up_ms;
+}
+
+void timebase_anchor(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    if (tv.tv_sec < 1704067200) { // 2024: relógio ainda não é confiável
+        return;
+    }
+
+    int64_t up_ms = esp_timer_get_time() / 1000 - ((int64_t)current_segment << 32);
+    int64_t epoch_ms = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000 - up_ms;
+
+    // Ressincronizações só regravam o NVS se corrigirem mais de 1 s
+    int64_t prev = 0;
+    if (timebase_to_epoch_ms(current_id, 0, &prev)) {
+        int64_t drift = epoch_ms - prev;
+        if (drift >= -1000 && drift <= 1000) {
+            return;
+        }
+        ESP_LOGW(TAG, "Boot %u re-anchored (clock moved %ld ms)", current_id, (long)drift);
+    }
+
+    set_anchor(current_id, epoch_ms);
+    anchors_dirty = true;
+    current_anchored = true;
+    ESP_LOGI(TAG, "Boot %u anchored: uptime 0 = epoch %u.%03u", current_id,
+             (uint32_t)(epoch_ms / 1000), (uint32_t)(epoch_ms % 1000));
+}
+
+void timebase_save(void) {
+    if (!anchors_dirty) {
+        return;
+    }
+    anchors_dirty = false;
+    save_anchors();
+}
+
+bool timebase_current_anchored(void) {
+    return current_anchored;
+}
+
+bool timebase_to_epoch_ms(uint16_t boot_id, uint32_t uptime_ms, int64_t *epoch_ms) {
+    bool found = false;
+    const timebase_anchor_t *a = &anchors[boot_id % TIMEBASE_ANCHOR_SLOTS];
+    portENTER_CRITICAL();
+    if (a->valid && a->boot_id == boot_id) {
+        *epoch_ms = a->epoch_ms + uptime_ms;
+        found = true;
+    }
+    portEXIT_CRITICAL();
+    return found;
+}
+
+bool timebase_to_timestamp(uint16_t boot_id, uint32_t uptime_ms, uint32_t *timestamp) {
+    int64_t epoch_ms;
+    if (!timebase_to_epoch_ms(boot_id, uptime_ms, &epoch_ms)) {
+        return false;
+    }
+    time_t t = (time_t)(epoch_ms / 1000);
+#if USE_LOCAL_TIMESTAMP
+    // Deslocar pelo fuso configurado (TZ definido em ntp_init)
+    struct tm utc_tm;
+    gmtime_r(&t, &utc_tm);
+    utc_tm.tm_isdst = -1;
+    t += t - mktime(&utc_tm);
+#endif
+    *timestamp = (uint32_t)t;
+    return true;
+}
+
+int timebase_format_json(char *buf, size_t len, uint16_t boot_id, uint32_t uptime_ms) {
+    int64_t epoch_ms;
+    uint32_t ts;
+    if (timebase_to_epoch_ms(boot_id, uptime_ms, &epoch_ms) && timebase_to_timestamp(boot_id, uptime_ms, &ts)) {
+        // Os dois campos saem do mesmo segundo: com USE_LOCAL_TIMESTAMP, timestamp_ms também é local
+        return snprintf(buf, len, "\"timestamp\":%u,\"timestamp_ms\":%u%03u,\"boot_id\":%u,\"uptime_ms\":%u",
+                        ts, ts, (uint32_t)(epoch_ms % 1000), boot_id, uptime_ms);
+    }
+    return snprintf(buf, len, "\"timestamp\":null,\"timestamp_ms\":null,\"boot_id\":%u,\"uptime_ms\":%u",
+                    boot_id, uptime_ms);
+}
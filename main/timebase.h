@@ -0,0 +1,72 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Base de tempo dos registros: cada amostra guarda o boot_id e o uptime em ms
+ * (monotônico, esp_timer). Na primeira sincronização NTP de cada boot a âncora
+ * "epoch em ms no uptime 0" é registrada e depois persistida no NVS pela task NTP; o horário em epoch é resolvido
+ * só na publicação/drain, o que também corrige amostras gravadas antes do NTP.
+ *
+ * O uptime em ms de 32 bits volta a zero a cada ~49,7 dias: nesse ponto um novo
+ * boot_id é alocado, com âncora derivada da anterior quando ela já existe.
+ */
+
+/**
+ * @brief Aloca o boot_id deste boot e carrega as âncoras do NVS
+ * @note Chamar após nvs_flash_init() e antes de qualquer amostra
+ */
+void timebase_init(void);
+
+/**
+ * @brief Instante atual na base de tempo dos registros
+ * @param[out] boot_id Identificador do boot (ou do trecho após a volta do uptime)
+ * @param[out] uptime_ms Uptime em ms dentro desse boot_id
+ */
+void timebase_now(uint16_t *boot_id, uint32_t *uptime_ms);
+
+/**
+ * @brief Registra na RAM a âncora do boot atual a partir do relógio do sistema
+ * @note Chamado a cada sincronização NTP, no contexto do SNTP: não grava o NVS. A âncora
+ *       só é marcada para gravação se mudar mais de 1 s; ver timebase_save()
+ */
+void timebase_anchor(void);
+
+/**
+ * @brief Grava no NVS a âncora registrada por timebase_anchor(), se houver
+ * @note Chamar de uma task: a escrita na flash não pode parar a thread tcpip
+ */
+void timebase_save(void);
+
+/**
+ * @brief Indica se o boot atual já tem âncora (horários resolvíveis)
+ */
+bool timebase_current_anchored(void);
+
+/**
+ * @brief Converte boot_id + uptime em epoch UTC em ms
+ * @return false se o boot não tem âncora conhecida
+ */
+bool timebase_to_epoch_ms(uint16_t boot_id, uint32_t uptime_ms, int64_t *epoch_ms);
+
+/**
+ * @brief Converte boot_id + uptime no timestamp publicado (s; local se USE_LOCAL_TIMESTAMP)
+ * @return false se o boot não tem âncora conhecida
+ */
+bool timebase_to_timestamp(uint16_t boot_id, uint32_t uptime_ms, uint32_t *timestamp);
+
+/**
+ * @brief Serializa os campos de tempo de um registro em JSON
+ *
+ * Gera "timestamp" (s) e "timestamp_ms" resolvidos na mesma base (UTC, ou local com
+ * USE_LOCAL_TIMESTAMP), ou null sem âncora, seguidos
+ * de "boot_id" e "uptime_ms" para reprocessamento no servidor.
+ *
+ * @return Retorno de snprintf
+ */
+int timebase_format_json(char *buf, size_t len, uint16_t boot_id, uint32_t uptime_ms);
+
+#endif // TIMEBASE_H
@@ -0,0 +1,74 @@
+#include "trend_history.h"
+#include "config.h"
+#include "fixed_point.h"
+#include <stdbool.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Duração de uma coluna do gráfico
+#define TREND_COLUMN_MS  ((uint32_t)OLED_TREND_HOURS * 3600000U / TREND_HISTORY_LEN)
+
+static trend_point_t ring[TREND_HISTORY_LEN];
+static size_t ring_head = 0;        // próxima posição a escrever
+static size_t ring_count = 0;
+static uint32_t columns_total = 0;
+
+// Coluna aberta: só a measurement_task escreve, sem trava
+static uint32_t column_start;
+static bool column_open = false;
+static int32_t temp_sum;
+static int32_t hum_sum;
+static uint16_t samples;
+
+static void push(int16_t temp_x10, int16_t hum_x10) {
+    portENTER_CRITICAL();
+    ring[ring_head].temp_x10 = temp_x10;
+    ring[ring_head].hum_x10 = hum_x10;
+    ring_head = (ring_head + 1) % TREND_HISTORY_LEN;
+    if (ring_count < TREND_HISTORY_LEN) {
+        ring_count++;
+    }
+    columns_total++;
+    portEXIT_CRITICAL();
+}
+
+uint32_t trend_history_add(uint32_t uptime_ms, int16_t temp_x10, int16_t hum_x10) {
+    uint32_t closed = 0;
+    if (!column_open) {
+        column_start = uptime_ms - uptime_ms % TREND_COLUMN_MS;
+        column_open = true;
+    } else if (uptime_ms - column_start >= TREND_COLUMN_MS) {
+        uint32_t elapsed = (uptime_ms - column_start) / TREND_COLUMN_MS;
+        push(samples ? (int16_t)(temp_sum / samples) : MEAS_VALUE_INVALID,
+             samples ? (int16_t)(hum_sum / samples) : MEAS_VALUE_INVALID);
+        closed++;
+        // Lacunas além de uma volta inteira não aparecem no gráfico
+        for (uint32_t i = 1; i < elapsed && i <= TREND_HISTORY_LEN; i++) {
+            push(MEAS_VALUE_INVALID, MEAS_VALUE_INVALID);
+            closed++;
+        }
+        column_start += elapsed * TREND_COLUMN_MS;
+        temp_sum = 0;
+        hum_sum = 0;
+        samples = 0;
+    }
+    temp_sum += temp_x10;
+    hum_sum += hum_x10;
+    samples++;
+    return closed;
+}
+
+size_t trend_history_copy(trend_point_t *out, uint32_t *columns) {
+    portENTER_CRITICAL();
+    size_t first = (ring_head + TREND_HISTORY_LEN - ring_count) % TREND_HISTORY_LEN;
+    for (size_t i = 0; i < ring_count; i++) {
+        out[i] = ring[(first + i) % TREND_HISTORY_LEN];
+    }
+    size_t count = ring_count;
+    if (columns != NULL) {
+        *columns = columns_total;
+    }
+    portEXIT_CRITICAL();
+    return count;
+}
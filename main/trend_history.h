@@ -0,0 +1,39 @@
+#ifndef TREND_HISTORY_H
+#define TREND_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Histórico reduzido do sensor principal para o gráfico de tendência do display:
+ * TREND_HISTORY_LEN colunas cobrindo OLED_TREND_HOURS, cada uma com a média das
+ * amostras do seu intervalo. Fica só na RAM (perde-se no reboot).
+ */
+
+#define TREND_HISTORY_LEN   128     // uma coluna por pixel da largura do display
+
+typedef struct {
+    int16_t temp_x10;   // MEAS_VALUE_INVALID se o intervalo não teve amostras
+    int16_t hum_x10;
+} trend_point_t;
+
+/**
+ * @brief Acumula uma amostra na coluna aberta
+ *
+ * A coluna é fechada quando chega a primeira amostra posterior ao seu fim;
+ * intervalos sem amostras viram colunas inválidas (lacunas no gráfico).
+ *
+ * @param uptime_ms Instante da amostra (uptime em ms)
+ * @return Número de colunas fechadas por esta amostra (0 na maioria das vezes)
+ */
+uint32_t trend_history_add(uint32_t uptime_ms, int16_t temp_x10, int16_t hum_x10);
+
+/**
+ * @brief Copia o histórico, da coluna mais antiga para a mais recente
+ * @param out Destino com espaço para TREND_HISTORY_LEN pontos
+ * @param[out] columns Total de colunas fechadas desde o boot (detecta colunas novas); pode ser NULL
+ * @return Número de pontos copiados
+ */
+size_t trend_history_copy(trend_point_t *out, uint32_t *columns);
+
+#endif // TREND_HISTORY_H
@@ -4,21 +4,75 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-// Estrutura de medição
+// Flags de qualidade da amostra (bitmask em measurement_data_t.quality)
+typedef enum {
+    MEAS_QUALITY_OK        = 0x00,
+    MEAS_QUALITY_RETRIED   = 0x01, // leitura válida obtida após novas tentativas
+    MEAS_QUALITY_FILTERED  = 0x02, // valor reportado é a saída do filtro (mediana/EMA)
+    MEAS_QUALITY_STALE     = 0x04, // todas as tentativas falharam; repetido último valor válido
+    MEAS_QUALITY_MISSING   = 0x08, // sem valor válido; temperatura/umidade não devem ser usadas
+    MEAS_QUALITY_AGGREGATE = 0x10 // registro é a média de uma janela (timestamp = início da janela)
+} measurement_quality_t;
+
+// Estrutura de medição (também é o formato do registro no SPIFFS)
 typedef struct {
-    uint32_t timestamp;
+    uint32_t uptime_ms;       // instante da amostra no boot boot_id (ver timebase.h)
     char sensor_id[16];
     uint8_t mac_address[6];
-    float temperature;
-    float humidity;
-    uint8_t retry_count;
+    int16_t temperature_x10;  // °C em décimos (ver fixed_point.h)
+    int16_t humidity_x10;     // % em décimos
+    uint8_t retry_count;      // novas tentativas de leitura do sensor nesta amostra
+    uint8_t quality;          // measurement_quality_t
+    uint16_t interval_s;      // intervalo de amostragem efetivo (ver sampling_policy.c)
+    uint16_t boot_id;         // boot em que a amostra foi feita; epoch resolvido na publicação
     uint32_t measurement_id;
 } measurement_data_t;
 
+// Estatísticas de uma grandeza em uma janela (décimos)
+typedef struct {
+    int16_t min;
+    int16_t max;
+    int16_t mean;
+    int16_t stddev;   // desvio padrão amostral
+    int16_t last;
+} window_channel_summary_t;
+
+// Resumo publicado no fechamento de uma janela (ver window_stats.c)
+typedef struct {
+    uint32_t start_uptime_ms; // início da janela (mesma base de measurement_data_t.uptime_ms)
+    uint32_t length_s;
+    char sensor_id[16];
+    uint8_t mac_address[6];
+    uint16_t samples;         // amostras recebidas na janela
+    uint16_t count;           // amostras com valor novo (sem MISSING/STALE)
+    uint8_t quality;          // OR das flags das amostras
+    uint16_t boot_id;
+    bool store_offline;       // gravar no SPIFFS como registro agregado se não publicado
+    uint32_t measurement_id;
+    window_channel_summary_t temperature;
+    window_channel_summary_t humidity;
+} window_summary_t;
+
+// Evento de alarme (transição de uma regra de alarm_rules.c)
+typedef struct {
+    uint32_t uptime_ms;       // instante da transição no boot boot_id
+    char sensor_id[16];
+    char rule[16];            // nome da regra: estável se uma atualização reordenar a tabela
+    uint8_t raised;           // 1 = disparou, 0 = normalizou
+    int16_t value_x10;        // valor (ou taxa por minuto) que causou a transição
+    int16_t threshold_x10;
+    uint16_t boot_id;
+    uint32_t event_id;        // boot_id nos 16 bits altos, contador do boot nos baixos
+} alarm_event_t;
+
+// Versão do formato do registro/índice no SPIFFS; incrementar ao mudar measurement_data_t
+#define SPIFFS_RECORD_VERSION       4
+
 // Estrutura para rastrear mensagens pendentes de confirmação MQTT
 typedef struct {
     int msg_id;
-    measurement_data_t measurement;
+    measurement_data_t *measurement; // registro do pool; referência solta no PUBACK
+    uint32_t sent_tick;              // xTaskGetTickCount() do envio
     bool is_stored; // true se veio da SPIFFS
 } mqtt_pending_t;
 
@@ -28,6 +82,8 @@ typedef struct {
     uint32_t tail;
     uint32_t count;
     uint32_t total_written;
+    uint16_t version;       // SPIFFS_RECORD_VERSION
+    uint16_t record_size;   // sizeof(measurement_data_t)
 } spiffs_ring_index_t;
 
 // Estados do sistema
@@ -4,6 +4,7 @@
 #include "dns_manager.h"
 #include "ntp_manager.h"
 #include "oled_display.h"
+#include "http_server.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
@@ -29,6 +30,8 @@ void wifi_event_handler(void* arg, esp_event_base_t event_base,
                 // Clear connected bit and mark state so reconnect manager runs.
                 ESP_LOGI(TAG, "WIFI_EVENT_STA_DISCONNECTED");
                 xEventGroupClearBits(wifi_event_group, WIFI_CONNECTED_BIT);
+                oled_display_notify(OLED_EVT_CONNECTIVITY);
+                http_events_notify(HTTP_EVT_STATUS);
                 current_state = WIFI_CONNECTING;
                 ESP_LOGI(TAG, "WiFi disconnected, waiting for reconnect manager task");
                 return;
@@ -51,6 +54,8 @@ void wifi_event_handler(void* arg, esp_event_base_t event_base,
             wifi_retry_num = 0;
             current_state = WIFI_CONNECTED;
             xEventGroupSetBits(wifi_event_group, WIFI_CONNECTED_BIT);
+            oled_display_notify(OLED_EVT_CONNECTIVITY);
+            http_events_notify(HTTP_EVT_STATUS);
             // Call DNS resolution now that DHCP-provided DNS is available
             if (test_dns_resolution() != ESP_OK) {
                 ESP_LOGW(TAG, "DNS resolution test failed on IP event, but continuing...");
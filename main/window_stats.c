@@ -0,0 +1,202 @@
+#include "window_stats.h"
+#include "globals.h"
+#include "config.h"
+#include "sensor_table.h"
+#include "fixed_point.h"
+#include "timebase.h"
+#include <string.h>
+#include "esp_log.h"
+
+// Acumulador incremental (Welford) de uma grandeza em décimos
+typedef struct {
+    int32_t mean_q8;    // média em Q8
+    int64_t m2_q16;     // soma dos quadrados dos desvios em Q16
+    int16_t min;
+    int16_t max;
+    int16_t last;
+} channel_acc_t;
+
+// Estado de uma janela aberta
+typedef struct {
+    uint32_t start;         // uptime_ms do início no boot boot_id
+    uint16_t boot_id;
+    uint16_t samples;
+    uint16_t count;
+    uint8_t quality;
+    uint8_t mac_address[6];
+    channel_acc_t temp;
+    channel_acc_t hum;
+} window_acc_t;
+
+static const uint32_t window_length_s[WINDOW_STATS_COUNT] = {
+    WINDOW_STATS_SHORT_MIN * 60U,
+    WINDOW_STATS_MEDIUM_MIN * 60U,
+    WINDOW_STATS_LONG_MIN * 60U,
+};
+
+static window_acc_t windows[SENSOR_MAX_COUNT][WINDOW_STATS_COUNT];
+static window_stats_counters_t counters;
+// Primeira janela habilitada: no modo somente-resumo é a que vai para o SPIFFS sem MQTT
+static int offline_window = -1;
+
+static void channel_add(channel_acc_t *c, uint16_t n, int16_t x) {
+    int32_t x_q8 = (int32_t)x << 8;
+    if (n == 1) {
+        c->mean_q8 = x_q8;
+        c->m2_q16 = 0;
+        c->min = x;
+        c->max = x;
+    } else {
+        int32_t delta = x_q8 - c->mean_q8;
+        c->mean_q8 += delta / n;
+        c->m2_q16 += (int64_t)delta * (x_q8 - c->mean_q8);
+        if (x < c->min) {
+            c->min = x;
+        }
+        if (x > c->max) {
+            c->max = x;
+        }
+    }
+    c->last = x;
+}
+
+static uint32_t isqrt64(uint64_t v) {
+    uint64_t res = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)res;
+}
+
+static void channel_summary(const channel_acc_t *c, uint16_t n, window_channel_summary_t *out) {
+    if (n == 0) {
+        out->min = out->max = out->mean = out->stddev = out->last = MEAS_VALUE_INVALID;
+        return;
+    }
+    out->min = c->min;
+    out->max = c->max;
+    out->last = c->last;
+    out->mean = fixed_q8_round(c->mean_q8);
+    // Variância amostral em Q16 -> desvio em Q8 -> décimos
+    out->stddev = (n > 1) ? (int16_t)((isqrt64((uint64_t)c->m2_q16 / (n - 1)) + 128) >> 8) : 0;
+}
+
+static void close_window(size_t idx, int w, const window_acc_t *acc) {
+    window_summary_t s;
+    memset(&s, 0, sizeof(s));
+    s.start_uptime_ms = acc->start;
+    s.boot_id = acc->boot_id;
+    s.length_s = window_length_s[w];
+    strncpy(s.sensor_id, sensor_table[idx].sensor_id, sizeof(s.sensor_id) - 1);
+    memcpy(s.mac_address, acc->mac_address, sizeof(s.mac_address));
+    s.samples = acc->samples;
+    s.count = acc->count;
+    s.quality = acc->quality;
+    s.store_offline = WINDOW_STATS_SUMMARY_ONLY && w == offline_window;
+    s.measurement_id = ++measurement_counter;
+    channel_summary(&acc->temp, acc->count, &s.temperature);
+    channel_summary(&acc->hum, acc->count, &s.humidity);
+    counters.windows_closed++;
+
+    ESP_LOGI(TAG, "%s window %us@%u+%ums closed: n=%u/%u T=" FIXED_X10_FMT " [" FIXED_X10_FMT ".." FIXED_X10_FMT
+             "] sd=" FIXED_X10_FMT " H=" FIXED_X10_FMT " sd=" FIXED_X10_FMT,
+             s.sensor_id, s.length_s, s.boot_id, s.start_uptime_ms, s.count, s.samples,
+             FIXED_X10_ARGS(s.temperature.mean), FIXED_X10_ARGS(s.temperature.min),
+             FIXED_X10_ARGS(s.temperature.max), FIXED_X10_ARGS(s.temperature.stddev),
+             FIXED_X10_ARGS(s.humidity.mean), FIXED_X10_ARGS(s.humidity.stddev));
+
+    if (summary_queue == NULL || xQueueSend(summary_queue, &s, 0) != pdTRUE) {
+        counters.summaries_dropped++;
+        ESP_LOGW(TAG, "Summary queue full, window summary of %s dropped", s.sensor_id);
+    }
+}
+
+void window_stats_init(void) {
+    memset(windows, 0, sizeof(windows));
+    memset(&counters, 0, sizeof(counters));
+    offline_window = -1;
+    for (int w = 0; w < WINDOW_STATS_COUNT; w++) {
+        if (window_length_s[w] > 0) {
+            offline_window = w;
+            break;
+        }
+    }
+}
+
+/*
+ * Início da janela que contém a amostra, em uptime_ms: alinhado a múltiplos da
+ * duração no relógio de parede quando o boot tem âncora, senão no uptime.
+ */
+static uint32_t window_start_ms(const measurement_data_t *m, uint32_t len_ms) {
+    int64_t epoch_ms;
+    if (timebase_to_epoch_ms(m->boot_id, m->uptime_ms, &epoch_ms)) {
+        uint32_t offset = (uint32_t)(epoch_ms % len_ms);
+        // Janela iniciada antes do boot começa no uptime 0
+        return (offset <= m->uptime_ms) ? m->uptime_ms - offset : 0;
+    }
+    return m->uptime_ms - m->uptime_ms % len_ms;
+}
+
+void window_stats_add(size_t idx, const measurement_data_t *m) {
+    // Valores repetidos (STALE) ou ausentes não entram nas estatísticas, só na contagem
+    bool has_value = !(m->quality & (MEAS_QUALITY_MISSING | MEAS_QUALITY_STALE));
+
+    for (int w = 0; w < WINDOW_STATS_COUNT; w++) {
+        uint32_t len = window_length_s[w];
+        if (len == 0) {
+            continue;
+        }
+        window_acc_t *acc = &windows[idx][w];
+        // A chegada da âncora (uptime -> relógio de parede) também fecha a janela
+        uint32_t start = window_start_ms(m, len * 1000U);
+        if (acc->samples > 0 && (start != acc->start || m->boot_id != acc->boot_id)) {
+            close_window(idx, w, acc);
+            acc->samples = 0;
+        }
+        if (acc->samples == 0) {
+            memset(acc, 0, sizeof(*acc));
+            acc->start = start;
+            acc->boot_id = m->boot_id;
+            memcpy(acc->mac_address, m->mac_address, sizeof(acc->mac_address));
+        }
+
+        acc->samples++;
+        acc->quality |= m->quality;
+        if (has_value) {
+            acc->count++;
+            channel_add(&acc->temp, acc->count, m->temperature_x10);
+            channel_add(&acc->hum, acc->count, m->humidity_x10);
+        }
+    }
+}
+
+void window_stats_to_record(const window_summary_t *s, measurement_data_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->uptime_ms = s->start_uptime_ms;
+    out->boot_id = s->boot_id;
+    memcpy(out->sensor_id, s->sensor_id, sizeof(out->sensor_id));
+    memcpy(out->mac_address, s->mac_address, sizeof(out->mac_address));
+    out->temperature_x10 = s->temperature.mean;
+    out->humidity_x10 = s->humidity.mean;
+    out->quality = s->quality | MEAS_QUALITY_AGGREGATE;
+    if (s->count > 0) {
+        out->quality &= ~MEAS_QUALITY_MISSING;
+    } else {
+        out->quality |= MEAS_QUALITY_MISSING;
+    }
+    out->measurement_id = s->measurement_id;
+}
+
+void window_stats_get_counters(window_stats_counters_t *out) {
+    *out = counters;
+}
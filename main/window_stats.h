@@ -0,0 +1,44 @@
+#ifndef WINDOW_STATS_H
+#define WINDOW_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "types.h"
+
+// Contadores do motor de estatísticas por janela
+typedef struct {
+    uint32_t windows_closed;    // resumos gerados
+    uint32_t summaries_dropped; // resumos descartados com summary_queue cheia
+} window_stats_counters_t;
+
+/**
+ * @brief Inicializa os acumuladores de todas as janelas de todos os sensores
+ */
+void window_stats_init(void);
+
+/**
+ * @brief Acumula uma amostra nas janelas do sensor
+ *
+ * Janelas fixas (tumbling) alinhadas a múltiplos da duração na base de tempo
+ * do timestamp. A janela é fechada quando chega a primeira amostra posterior
+ * ao seu fim; o resumo vai para summary_queue. Memória O(1) por janela.
+ *
+ * @param idx Índice do sensor em sensor_table
+ * @param m Amostra já com timestamp e flags de qualidade
+ */
+void window_stats_add(size_t idx, const measurement_data_t *m);
+
+/**
+ * @brief Converte um resumo em registro agregado (média) para o backlog do SPIFFS
+ * @param s Resumo da janela
+ * @param out Registro com flag MEAS_QUALITY_AGGREGATE
+ */
+void window_stats_to_record(const window_summary_t *s, measurement_data_t *out);
+
+/**
+ * @brief Copia os contadores do motor de estatísticas
+ * @param out Destino dos contadores
+ */
+void window_stats_get_counters(window_stats_counters_t *out);
+
+#endif // WINDOW_STATS_H
@@ -0,0 +1,43 @@
+#include "www.h"
+#include <stdio.h>
+#include <string.h>
+
+const www_asset_t *www_find(const char *path) {
+    for (size_t i = 0; i < www_asset_count; i++) {
+        if (strcmp(www_assets[i].path, path) == 0) {
+            return &www_assets[i];
+        }
+    }
+    return NULL;
+}
+
+// If-None-Match traz "*" ou uma lista de ETags, possivelmente com o prefixo fraco W/
+static bool etag_matches(const char *if_none_match, const char *etag) {
+    if (if_none_match == NULL) {
+        return false;
+    }
+    return strcmp(if_none_match, "*") == 0 || strstr(if_none_match, etag) != NULL;
+}
+
+void www_handle(http_conn_t *c, const http_request_t *req) {
+    const www_asset_t *asset = www_find(req->path);
+    if (asset == NULL) {
+        http_send_error(c, 404);
+        return;
+    }
+
+    // no-cache: o navegador guarda a cópia mas revalida a cada carga; sem mudança a
+    // resposta é só o cabeçalho 304. Sem Vary: o Accept-Encoding é ignorado e há uma
+    // única representação por path
+    char headers[128];
+    int n = snprintf(headers, sizeof(headers), "ETag: %s\r\nCache-Control: no-cache\r\n", asset->etag);
+    if (etag_matches(http_request_header(req, "If-None-Match"), asset->etag)) {
+        http_begin(c, 304, asset->content_type, headers, 0);
+        return;
+    }
+    // Só existe a versão comprimida, enviada a qualquer cliente: todo navegador atual
+    // aceita gzip, e guardar a descomprimida custaria o dobro de flash
+    snprintf(headers + n, sizeof(headers) - (size_t)n, "Content-Encoding: gzip\r\n");
+    http_begin(c, 200, asset->content_type, headers, asset->len);
+    http_write_static(c, asset->data, asset->len);
+}
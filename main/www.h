@@ -0,0 +1,36 @@
+#ifndef WWW_H
+#define WWW_H
+
+#include "http_conn.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Painel web estático (main/www): o build comprime cada arquivo com gzip e gera
+ * www_assets.c (tools/www_pack.py) com os bytes em arrays const, o tipo MIME e um
+ * ETag do conteúdo. O servidor envia os bytes comprimidos como estão e responde
+ * 304 quando o navegador já tem a versão atual.
+ */
+
+typedef struct {
+    const char *path;
+    const char *content_type;
+    const uint8_t *data;        // conteúdo com gzip
+    size_t len;
+    const char *etag;           // com as aspas
+} www_asset_t;
+
+extern const www_asset_t www_assets[];
+extern const size_t www_asset_count;
+
+/**
+ * @brief Asset com o path exato, NULL se não houver
+ */
+const www_asset_t *www_find(const char *path);
+
+/**
+ * @brief Handler HTTP dos assets (rota de prefixo "/"): 200 com gzip, 304 pelo If-None-Match, ou 404
+ */
+void www_handle(http_conn_t *c, const http_request_t *req);
+
+#endif // WWW_H
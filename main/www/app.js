@@ -0,0 +1,121 @@
+// Painel do datalogger: valores ao vivo pelo stream /events, detalhes de /status
+(function () {
+  'use strict';
+  var MAX_POINTS = 360;
+  // Contadores de /status não vêm no stream: recarregados devagar enquanto a aba está visível
+  var STATUS_REFRESH_MS = 60000;
+  var points = [];
+
+  function $(id) { return document.getElementById(id); }
+  function fmt(x) { return x === null || x === undefined ? '--' : x.toFixed(1); }
+  function onOff(id, on) {
+    var el = $(id);
+    el.textContent = on ? 'conectado' : 'desconectado';
+    el.className = on ? 'on' : 'off';
+  }
+  function setLive(text, cls) {
+    var el = $('live');
+    el.textContent = text;
+    el.className = 'badge ' + (cls || '');
+  }
+
+  function drawSeries(ctx, key, color, w, h) {
+    var vals = points.map(function (p) { return p[key]; }).filter(function (v) { return v !== null; });
+    if (vals.length < 2) {
+      return;
+    }
+    var lo = Math.min.apply(null, vals), hi = Math.max.apply(null, vals);
+    if (hi - lo < 1) {
+      lo -= 0.5;
+      hi += 0.5;
+    }
+    ctx.strokeStyle = color;
+    ctx.lineWidth = 2;
+    ctx.beginPath();
+    var started = false;
+    points.forEach(function (p, i) {
+      if (p[key] === null) {
+        started = false;
+        return;
+      }
+      var x = i * (w - 1) / (MAX_POINTS - 1);
+      var y = h - 6 - (p[key] - lo) * (h - 12) / (hi - lo);
+      if (started) {
+        ctx.lineTo(x, y);
+      } else {
+        ctx.moveTo(x, y);
+        started = true;
+      }
+    });
+    ctx.stroke();
+  }
+
+  function drawChart() {
+    var c = $('chart'), ctx = c.getContext('2d');
+    ctx.clearRect(0, 0, c.width, c.height);
+    drawSeries(ctx, 'temperature', '#E53935', c.width, c.height);
+    drawSeries(ctx, 'humidity', '#2196F3', c.width, c.height);
+  }
+
+  function onMeasurement(m) {
+    $('temp').textContent = fmt(m.temperature);
+    $('hum').textContent = fmt(m.humidity);
+    $('sid').textContent = m.sensor_id;
+    $('time').textContent = m.timestamp === null ? '--' : new Date(m.timestamp * 1000).toLocaleString('pt-BR');
+    points.push({ temperature: m.temperature, humidity: m.humidity });
+    if (points.length > MAX_POINTS) {
+      points.shift();
+    }
+    drawChart();
+  }
+
+  function onStatus(s) {
+    onOff('wifi', s.wifi);
+    onOff('mqtt', s.mqtt);
+    $('ntp').textContent = s.synced ? 'sincronizado' : 'aguardando NTP';
+    $('alarms').textContent = s.alarms_active;
+    $('mac').textContent = s.mac;
+    loadStatus();
+  }
+
+  // Detalhes que não vêm no stream: contadores, tabela de sensores, servidor HTTP
+  var loading = false;
+  function loadStatus() {
+    if (loading) {
+      return;
+    }
+    loading = true;
+    fetch('/status').then(function (r) { return r.json(); }).then(function (st) {
+      $('fw').textContent = st.firmware;
+      $('counts').textContent = st.mqtt_sent + ' / ' + st.backlog_count;
+      if (st.http) {
+        $('http').textContent = st.http.busy + ' de ' + st.http.slots + ' slots, ' + st.http.streams + ' streams';
+      }
+      $('sensors').innerHTML = st.sensors.map(function (s) {
+        return '<tr><td>' + s.sensor_id + '</td><td>' + s.pin + '</td><td>' + (s.interval_ms / 1000) + ' s</td><td>' +
+          s.samples + '</td><td>' + s.read_failures + '</td><td>' + s.quality + '</td></tr>';
+      }).join('');
+    }).catch(function () {}).then(function () { loading = false; });
+  }
+
+  function openStream() {
+    var es = new EventSource('/events');
+    es.onopen = function () { setLive('ao vivo', 'ok'); };
+    es.onerror = function () {
+      setLive('reconectando', 'err');
+      // 503: todos os slots de stream ocupados; o navegador não tenta de novo sozinho
+      if (es.readyState === 2) {
+        setTimeout(openStream, 30000);
+      }
+    };
+    es.addEventListener('measurement', function (e) { onMeasurement(JSON.parse(e.data)); });
+    es.addEventListener('status', function (e) { onStatus(JSON.parse(e.data)); });
+  }
+
+  openStream();
+  setInterval(function () {
+    if (!document.hidden) {
+      loadStatus();
+    }
+  }, STATUS_REFRESH_MS);
+})();
@@ -0,0 +1,110 @@
+/*
+ * Benchmark de host do NanoCanvas1 (1 bpp) da biblioteca ssd1306: µs por operação
+ * de tela cheia 128x64 (limpar, preencher, blit de bitmap, texto), com e sem
+ * alinhamento às páginas de 8 linhas. O checksum do buffer após cada operação é
+ * comparado com o dos kernels antigos (pixel a pixel): uma otimização que mude o
+ * resultado faz o benchmark sair com 1. Os blits e o texto usam altura múltipla de 8
+ * e nenhum blit opaco preto, onde o drawBitmap1() novo difere de propósito (ver
+ * canvas_check.cpp).
+ *
+ * Uso: canvas_bench [ms_por_operacao]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ssd1306.h"
+#include "nano_engine/canvas.h"
+
+#define WIDTH   128
+#define HEIGHT  64
+
+static uint8_t buffer[WIDTH * HEIGHT / 8];
+static uint8_t bitmap[WIDTH * HEIGHT / 8];
+static NanoCanvas1 canvas(WIDTH, HEIGHT, buffer);
+static const char *line = "T25.3C H62.5% 12:00:0";
+static int mismatches = 0;
+
+static double now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static uint32_t checksum()
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < sizeof(buffer); i++)
+    {
+        h = (h ^ buffer[i]) * 16777619u;
+    }
+    return h;
+}
+
+static void text(lcdint_t y)
+{
+    for (lcdint_t row = 0; row < HEIGHT / 8; row++)
+    {
+        canvas.printFixed(0, y + row * 8, line);
+    }
+}
+
+// Repete op pelo tempo pedido, a partir de um buffer com conteúdo
+static void bench(const char *name, uint32_t expected, void (*op)(), double budget_us)
+{
+    uint32_t reps = 0;
+    memcpy(buffer, bitmap, sizeof(buffer));
+    op();
+    uint32_t sum = checksum();
+    double start = now_us();
+    double elapsed;
+    do
+    {
+        for (int i = 0; i < 64; i++)
+        {
+            op();
+        }
+        reps += 64;
+        elapsed = now_us() - start;
+    } while (elapsed < budget_us);
+    printf("%-26s %9.3f us  %08x%s\n", name, elapsed / reps, (unsigned)sum,
+           sum == expected ? "" : "  MISMATCH");
+    if (sum != expected)
+    {
+        mismatches++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    double budget_us = (argc > 1 ? atof(argv[1]) : 200) * 1000;
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < sizeof(bitmap); i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        bitmap[i] = (uint8_t)(seed >> 16);
+    }
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+
+    printf("NanoCanvas1 %dx%d, us per operation\n", WIDTH, HEIGHT);
+    bench("clear", 0x1f116dc5, [] { canvas.clear(); }, budget_us);
+    bench("fill page aligned", 0x422f51c5, [] { canvas.setColor(WHITE); canvas.fillRect(0, 0, WIDTH - 1, HEIGHT - 1); }, budget_us);
+    bench("fill unaligned", 0x5e22210a, [] { canvas.setColor(WHITE); canvas.fillRect(1, 3, WIDTH - 2, HEIGHT - 4); }, budget_us);
+    bench("fill unaligned black", 0xd87b5198, [] { canvas.setColor(BLACK); canvas.fillRect(1, 3, WIDTH - 2, HEIGHT - 4); }, budget_us);
+    bench("hline x64", 0x422f51c5, [] { canvas.setColor(WHITE); for (lcdint_t y = 0; y < HEIGHT; y++) canvas.drawHLine(0, y, WIDTH - 1); }, budget_us);
+    bench("blit page aligned", 0x84578734, [] { canvas.setColor(WHITE); canvas.setMode(0); canvas.drawBitmap1(0, 0, WIDTH, HEIGHT, bitmap); }, budget_us);
+    bench("blit shifted", 0x6d30e7c9, [] { canvas.setColor(WHITE); canvas.setMode(0); canvas.drawBitmap1(0, 3, WIDTH, HEIGHT, bitmap); }, budget_us);
+    bench("blit clipped", 0xdfadb44d, [] { canvas.setColor(WHITE); canvas.setMode(0); canvas.drawBitmap1(-5, -11, WIDTH, HEIGHT, bitmap); }, budget_us);
+    bench("blit transparent", 0x6ada4cff, [] { canvas.setColor(WHITE); canvas.setMode(CANVAS_MODE_TRANSPARENT); canvas.drawBitmap1(0, 3, WIDTH, HEIGHT, bitmap); }, budget_us);
+    bench("text page aligned", 0x95b41818, [] { canvas.setColor(WHITE); canvas.setMode(0); text(0); }, budget_us);
+    bench("text shifted", 0x9493ad05, [] { canvas.setColor(WHITE); canvas.setMode(0); text(4); }, budget_us);
+    bench("text transparent black", 0xaa05337c, [] { canvas.setColor(BLACK); canvas.setMode(CANVAS_MODE_TRANSPARENT); text(4); }, budget_us);
+    if (mismatches)
+    {
+        printf("%d checksums differ from the old kernels\n", mismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,259 @@
+/*
+ * Teste diferencial dos kernels do NanoCanvas1 (1 bpp): operações aleatórias de
+ * preenchimento, linha horizontal e blit de bitmap, com recorte, offset, as duas
+ * cores e modo transparente, aplicadas ao canvas da biblioteca e a uma cópia dos
+ * kernels antigos, pixel a pixel. Os buffers têm de ser iguais após cada operação.
+ *
+ * Ficam de fora as duas mudanças intencionais do drawBitmap1() novo: o modo opaco
+ * preto (o antigo ligava bits fora das linhas do bitmap) e alturas que não são
+ * múltiplas de 8 (o antigo escrevia também o enchimento da última página). Texto
+ * não é testado à parte: printFixed() desenha cada glifo com drawBitmap1(), altura 8.
+ *
+ * Uso: canvas_check [operações] [semente]; sai com 1 na primeira diferença
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ssd1306.h"
+#include "nano_engine/canvas.h"
+
+#define WIDTH   128
+#define HEIGHT  64
+
+// Kernels antigos (antes dos kernels por página e por palavra), sobre um buffer simples
+struct RefCanvas1
+{
+    uint8_t *m_buf;
+    lcdint_t m_w;
+    lcdint_t m_h;
+    lcdint_t ox;
+    lcdint_t oy;
+    uint8_t m_color;
+    uint8_t m_textMode;
+
+    uint16_t yaddr(lcdint_t y) const { return static_cast<uint16_t>(y >> 3) * m_w; }
+
+    void drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
+    {
+        if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
+        x1 -= ox;
+        x2 -= ox;
+        y1 -= oy;
+        if ((y1 >= m_h) || (y1 < 0)) return;
+        if ((x2 < 0) || (x1 >= m_w)) return;
+        x1 = x1 > 0 ? x1 : 0;
+        x2 = x2 < m_w - 1 ? x2 : m_w - 1;
+        uint16_t addr = yaddr(y1) + x1;
+        uint8_t mask = (1 << (y1 & 0x7));
+        if (m_color)
+        {
+            do { m_buf[addr++] |= mask; } while (x2 > x1++);
+        }
+        else
+        {
+            do { m_buf[addr++] &= ~mask; } while (x2 > x1++);
+        }
+    }
+
+    void fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+    {
+        if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
+        if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
+        x1 -= ox;
+        x2 -= ox;
+        y1 -= oy;
+        y2 -= oy;
+        if ((x2 < 0) || (x1 >= m_w)) return;
+        if ((y2 < 0) || (y1 >= m_h)) return;
+        x1 = x1 > 0 ? x1 : 0;
+        x2 = x2 < m_w - 1 ? x2 : m_w - 1;
+        y1 = y1 > 0 ? y1 : 0;
+        y2 = y2 < m_h - 1 ? y2 : m_h - 1;
+        uint8_t bank1 = (y1 >> 3);
+        uint8_t bank2 = (y2 >> 3);
+        for (uint8_t bank = bank1; bank <= bank2; bank++)
+        {
+            uint8_t mask = 0xFF;
+            if (bank1 == bank2)
+            {
+                mask = (mask >> ((y1 & 7) + 7 - (y2 & 7))) << (y1 & 7);
+            }
+            else if (bank1 == bank)
+            {
+                mask = (mask << (y1 & 7));
+            }
+            else if (bank2 == bank)
+            {
+                mask = (mask >> (7 - (y2 & 7)));
+            }
+            for (lcdint_t x = x1; x <= x2; x++)
+            {
+                if (m_color)
+                {
+                    m_buf[bank * m_w + x] |= mask;
+                }
+                else
+                {
+                    m_buf[bank * m_w + x] &= ~mask;
+                }
+            }
+        }
+    }
+
+    void drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+    {
+        x -= ox;
+        y -= oy;
+        lcduint_t origin_width = w;
+        uint8_t offs = y & 0x07;
+        uint8_t complexFlag = 0;
+        uint8_t mainFlag = 1;
+        if (y + (lcdint_t)h <= 0) return;
+        if (y >= m_h) return;
+        if ((int16_t)x + (int16_t)w <= 0) return;
+        if ((int16_t)x >= (int16_t)m_w) return;
+        if (y < 0)
+        {
+            bitmap += ((lcduint_t)((-y) + 7) >> 3) * w;
+            h += y;
+            y = 0;
+            complexFlag = 1;
+        }
+        if (x < 0)
+        {
+            bitmap += -x;
+            w += x;
+            x = 0;
+        }
+        uint8_t max_pages = (lcduint_t)(h + 15 - offs) >> 3;
+        if ((lcduint_t)(y + (lcdint_t)h) > (lcduint_t)m_h)
+        {
+            h = (lcduint_t)(m_h - (lcduint_t)y);
+        }
+        if ((lcduint_t)(x + (lcdint_t)w) > (lcduint_t)m_w)
+        {
+            w = (lcduint_t)(m_w - (lcduint_t)x);
+        }
+        uint8_t pages = ((y + h - 1) >> 3) - (y >> 3) + 1;
+        for (uint8_t j = 0; j < pages; j++)
+        {
+            uint16_t addr = yaddr(y + ((uint16_t)j << 3)) + x;
+            if (j == max_pages - 1) mainFlag = !offs;
+            for (lcduint_t i = w; i > 0; i--)
+            {
+                uint8_t data = 0;
+                uint8_t mask = 0;
+                if (mainFlag)    { data |= (*bitmap << offs); mask |= (0xFF << offs); }
+                if (complexFlag) { data |= (*(bitmap - origin_width) >> (8 - offs)); mask |= (0xFF >> (8 - offs)); }
+                if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
+                {
+                    m_buf[addr] &= ~mask;
+                    m_buf[addr] |= m_color == BLACK ? ~data : data;
+                }
+                else
+                {
+                    if (m_color == BLACK)
+                        m_buf[addr] &= ~data;
+                    else
+                        m_buf[addr] |= data;
+                }
+                bitmap++;
+                addr++;
+            }
+            bitmap += origin_width - w;
+            complexFlag = offs;
+        }
+    }
+};
+
+static uint8_t buffer[WIDTH * HEIGHT / 8];
+static uint8_t expected[WIDTH * HEIGHT / 8];
+static uint8_t bitmap[WIDTH * HEIGHT / 8];
+static uint32_t seed;
+
+static uint32_t rnd(uint32_t n)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 8) % n;
+}
+
+// Coordenada que às vezes cai fora do canvas, para exercitar o recorte
+static lcdint_t coord(lcdint_t size)
+{
+    return (lcdint_t)rnd(size + 40) - 20;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long ops = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+    seed = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 1;
+    for (size_t i = 0; i < sizeof(bitmap); i++)
+    {
+        bitmap[i] = (uint8_t)rnd(256);
+    }
+
+    NanoCanvas1 canvas(WIDTH, HEIGHT, buffer);
+    RefCanvas1 ref = { expected, WIDTH, HEIGHT, 0, 0, WHITE, 0 };
+    unsigned long counts[3] = { 0, 0, 0 };
+    for (unsigned long n = 0; n < ops; n++)
+    {
+        if (rnd(64) == 0)
+        {
+            lcdint_t ox = (lcdint_t)rnd(17) - 8;
+            lcdint_t oy = (lcdint_t)rnd(17) - 8;
+            canvas.setOffset(ox, oy);
+            ref.ox = ox;
+            ref.oy = oy;
+        }
+        uint8_t color = rnd(2) ? WHITE : BLACK;
+        uint8_t mode = rnd(2) ? CANVAS_MODE_TRANSPARENT : 0;
+        canvas.setColor(color);
+        canvas.setMode(mode);
+        ref.m_color = color;
+        ref.m_textMode = mode;
+
+        unsigned op = rnd(3);
+        const char *name;
+        if (op == 0)
+        {
+            lcdint_t x1 = coord(WIDTH), y1 = coord(HEIGHT), x2 = coord(WIDTH), y2 = coord(HEIGHT);
+            canvas.fillRect(x1, y1, x2, y2);
+            ref.fillRect(x1, y1, x2, y2);
+            name = "fillRect";
+        }
+        else if (op == 1)
+        {
+            lcdint_t x1 = coord(WIDTH), y1 = coord(HEIGHT), x2 = coord(WIDTH);
+            canvas.drawHLine(x1, y1, x2);
+            ref.drawHLine(x1, y1, x2);
+            name = "drawHLine";
+        }
+        else
+        {
+            if (color == BLACK && mode == 0)
+            {
+                // Mudança intencional: fora da comparação
+                color = WHITE;
+                canvas.setColor(color);
+                ref.m_color = color;
+            }
+            lcduint_t w = 1 + rnd(WIDTH);
+            lcduint_t h = 8 * (1 + rnd(HEIGHT / 8));
+            lcdint_t x = coord(WIDTH), y = coord(HEIGHT);
+            canvas.drawBitmap1(x, y, w, h, bitmap);
+            ref.drawBitmap1(x, y, w, h, bitmap);
+            name = "drawBitmap1";
+        }
+        counts[op]++;
+        if (memcmp(buffer, expected, sizeof(buffer)) != 0)
+        {
+            printf("op %lu (%s, color %u, mode %u): buffer differs from the old kernels\n", n, name,
+                   (unsigned)color, (unsigned)mode);
+            return 1;
+        }
+    }
+    printf("%lu operations (%lu fillRect, %lu drawHLine, %lu drawBitmap1): same buffer as the old kernels\n",
+           ops, counts[0], counts[1], counts[2]);
+    return 0;
+}
@@ -0,0 +1,1006 @@
+/*
+ * Teste de carga de host do servidor HTTP: o núcleo do firmware (main/http_conn.c)
+ * roda sobre sockets POSIX com o mesmo modelo de slots (acceptor + fila + uma thread
+ * por slot) e rotas que imitam /, /data e /status. Clientes em threads medem
+ * requisições por segundo e latência (p50/p99) com conexões persistentes.
+ *
+ * O modo -l roda no lugar dele o servidor antigo: uma conexão por vez, um único
+ * recv, Connection: close e uma escrita por pedaço da resposta.
+ *
+ * Uso: http_load [-l] [-c clientes] [-t segundos] [-w slots] [-s]
+ *   -l  servidor antigo
+ *   -c  número de clientes (padrão: 1, 4 e 16 em sequência)
+ *   -t  duração de cada rodada (padrão 2 s)
+ *   -w  slots do servidor novo (padrão HTTP_MAX_CONNECTIONS)
+ *   -s  mais um cliente lento: conecta, espera 300 ms e envia cada requisição em duas
+ *       metades, 300 ms entre elas (como uma conexão especulativa de navegador)
+ *   -e  custo de um navegador com a página aberta, por minuto: com -l, a página antiga
+ *       recarregada a cada segundo (meta refresh); sem -l, o stream /events com uma
+ *       medição a cada MEASUREMENT_INTERVAL_MS e GET /status a cada STATUS_REFRESH_S,
+ *       como o painel (tempo acelerado VIEWER_SPEEDUP vezes)
+ *   -p  custo de abrir o painel: primeira carga e recarga com o cache do navegador
+ *       (If-None-Match); com -l, a página antiga, sem cache
+ *   -H  vazão de GET /history (registros/s) sobre um buffer cheio de
+ *       MAX_MEASUREMENTS_BUFFER registros num arquivo, no layout do SPIFFS
+ *
+ * As rotas do painel (/, /app.js, /style.css) são os assets reais de main/www,
+ * empacotados pelo Makefile com tools/www_pack.py e servidos por main/www.c.
+ */
+
+#define _GNU_SOURCE
+#include "config.h"
+#include "history.h"
+#include "http_conn.h"
+#include "timebase.h"
+#include "www.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_SLOTS       16
+#define MAX_CLIENTS     64
+#define MAX_SAMPLES     (1 << 20)
+#define SLOW_GAP_MS     300
+#define CLIENT_TIMEOUT_S 3
+#define VIEWER_SPEEDUP  60      // -e: um minuto simulado por segundo
+#define STATUS_REFRESH_S 60     // -e: contadores de /status recarregados pelo painel (app.js)
+
+static bool legacy = false;
+static int slot_count = HTTP_MAX_CONNECTIONS;
+static int listen_fd = -1;
+static struct sockaddr_in server_addr;
+static volatile bool running = true;
+// Escritas e bytes enviados pelo servidor (com TCP_NODELAY, cada escrita é ao menos um segmento)
+static uint32_t server_writes, server_bytes;
+
+static void count_write(size_t len) {
+    __atomic_add_fetch(&server_writes, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&server_bytes, (uint32_t)len, __ATOMIC_RELAXED);
+}
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)ts.tv_nsec / 1000U;
+}
+
+static void set_nodelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+static bool send_all(int fd, const void *data, size_t len) {
+    const char *p = data;
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/* ---------- Conteúdo das rotas (tamanhos parecidos com os do firmware) ---------- */
+
+static const char data_json[] =
+    "{\"sensor_id\":\"dht22_0\",\"timestamp\":1760790000,\"boot_id\":12,\"uptime_ms\":3600000,"
+    "\"time_source\":\"ntp\",\"temperature\":25.3,\"humidity\":62.5,\"quality\":0}";
+
+// /status: cabeçalho, um bloco por sensor e um por regra de alarme, como http_server.c
+static const char *status_parts[] = {
+    "{\"firmware\":\"2.0.0\",\"sensor_id\":\"dht22_0\",\"mac\":\"5C:CF:7F:00:00:00\",\"wifi_connected\":true,"
+    "\"mqtt_connected\":true,\"mqtt_sent\":1520,\"backlog_count\":37,\"last_measurement\":{\"timestamp\":1760790000,"
+    "\"temperature\":25.3,\"humidity\":62.5,\"quality\":0},\"windows\":{\"summary_only\":false,\"closed\":60,"
+    "\"dropped\":0},\"record_pool\":{\"size\":20,\"free\":18,\"ring\":0},\"sensors\":[",
+    "{\"sensor_id\":\"dht22_0\",\"pin\":4,\"type\":22,\"interval_ms\":5000,\"timestamp\":1760790000,"
+    "\"temperature\":25.3,\"humidity\":62.5,\"quality\":0,\"samples\":720,\"reads\":722,\"read_failures\":2,"
+    "\"rejected_range\":0,\"rejected_rate\":0,\"retried\":2,\"stale\":0,\"missing\":0,"
+    "\"bus_us\":4980,\"cpu_us\":310,\"cpu_us_max\":420,",
+    "\"schedule\":{\"aligned\":true,\"slots\":720,\"overruns\":0,\"jitter_us\":{\"last\":120,\"max\":980,\"avg\":140}},",
+    "\"sampling\":{\"base_ms\":5000,\"interval_ms\":5000,\"storage\":false,\"stable\":false,\"fill_pct\":3,"
+    "\"link_up\":true,\"stable_count\":0,\"changes\":0}}",
+    "],\"display\":{\"shadow\":true,\"frames\":3600,\"i2c_bytes\":{\"last\":28,\"max\":1040,\"avg\":31},"
+    "\"i2c_transactions\":{\"last\":3,\"max\":9,\"avg\":3},\"full_refresh\":{\"us\":24100,\"bytes\":1040,"
+    "\"transactions\":9,\"bytes_per_s\":43153,\"cycles\":{\"runtime\":0,\"static\":0}},"
+    "\"digit_cycles\":{\"scaled\":0,\"cached\":0},\"trend\":{\"scrolls\":0,\"late\":0,\"redraws\":0},\"shift_rows\":0,\"shift_cols\":0,",
+    "\"power\":{\"on\":true,\"contrast\":127,\"on_s\":3600,\"off_s\":0,\"offs\":0,\"wakes\":0,\"bytes_skipped_est\":0},",
+    "\"renders\":3600,\"cpu_us\":{\"render\":{\"last\":900,\"max\":4100,\"avg\":950,\"total_ms\":3420},"
+    "\"flush\":{\"last\":700,\"max\":24100,\"avg\":760,\"total_ms\":2736}}},\"alarm_backlog\":0,\"alarms\":[",
+    "{\"rule\":\"temp_high\",\"active_mask\":0,\"evaluations\":720,\"transitions\":0,"
+    "\"cycles\":{\"last\":410,\"max\":900,\"avg\":430}}",
+    ",{\"rule\":\"hum_high\",\"active_mask\":0,\"evaluations\":720,\"transitions\":0,"
+    "\"cycles\":{\"last\":410,\"max\":900,\"avg\":430}}",
+    "],\"http\":{\"slots\":3,\"busy\":1,\"connections\":10,\"requests\":100,\"errors\":0}}",
+};
+
+static const char *index_parts[] = {
+    "<html><head><meta name='viewport' content='width=device-width, initial-scale=1'><meta charset='UTF-8'>"
+    "<meta http-equiv='refresh' content='1'><style>body{font-family:sans-serif;background:#f4f4f4;margin:0;"
+    "padding:0;}.container{max-width:400px;margin:40px auto;background:#fff;padding:24px;border-radius:8px;"
+    "box-shadow:0 2px 8px #ccc;}h1{color:#2196F3;} .data{font-size:1.2em;margin:12px 0;display:flex;"
+    "justify-content:space-between;} .label{color:#888;}@media(max-width:500px){.container{margin:10px;"
+    "padding:10px;}}</style></head><body><div class='container'><h1>ESP8266 Datalogger</h1>",
+    "<div class='data'><span class='label'>Temperatura:</span><span>25.3°C</span></div>",
+    "<div class='data'><span class='label'>Umidade:</span><span>62.5%</span></div>",
+    "<div class='data'><span class='label'>Data da Medição:</span><span>18/10/2026 12:00:00</span></div>",
+    "<div class='data'><span class='label'>MAC:</span><span>5C:CF:7F:00:00:00</span></div>",
+    "<div class='data'><span class='label'>Firmware:</span><span>2.0.0</span></div>",
+    "<div class='data'><span class='label'>Sensor ID:</span><span>dht22_0</span></div>",
+    "</div></body></html>",
+};
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+/* ---------- Servidor novo: núcleo do firmware sobre sockets ---------- */
+
+static void handle_data(http_conn_t *c, const http_request_t *req) {
+    http_begin(c, 200, "application/json", "Cache-Control: no-store\r\n", HTTP_LENGTH_UNKNOWN);
+    http_write_str(c, data_json);
+}
+
+static void handle_status(http_conn_t *c, const http_request_t *req) {
+    http_begin(c, 200, "application/json", "Cache-Control: no-store\r\n", HTTP_LENGTH_UNKNOWN);
+    for (size_t i = 0; i < COUNT(status_parts); i++) {
+        http_write_str(c, status_parts[i]);
+    }
+}
+
+// Medições simuladas para /events (xTaskNotify no firmware)
+static uint32_t event_seq;
+static pthread_mutex_t event_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t event_cond = PTHREAD_COND_INITIALIZER;
+
+static void write_event(http_conn_t *c, const char *name, const char *json) {
+    char buf[512];
+    snprintf(buf, sizeof(buf), "event: %s\ndata: %s\n\n", name, json);
+    http_write_str(c, buf);
+}
+
+static void handle_events(http_conn_t *c, const http_request_t *req) {
+    static const char status_json[] =
+        "{\"wifi\":true,\"mqtt\":true,\"synced\":true,\"mac\":\"5C:CF:7F:00:00:00\",\"alarms_active\":0}";
+    http_begin(c, 200, "text/event-stream", "Cache-Control: no-store\r\n", HTTP_LENGTH_UNKNOWN);
+    http_write_str(c, "retry: 5000\n\n");
+    write_event(c, "measurement", data_json);
+    write_event(c, "status", status_json);
+    http_flush(c);
+
+    pthread_mutex_lock(&event_lock);
+    uint32_t seen = event_seq;
+    while (!c->failed) {
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        uint64_t ns = until.tv_nsec + (uint64_t)HTTP_SSE_PING_S * 1000000000U / VIEWER_SPEEDUP;
+        until.tv_sec += ns / 1000000000U;
+        until.tv_nsec = ns % 1000000000U;
+        pthread_cond_timedwait(&event_cond, &event_lock, &until);
+        bool changed = seen != event_seq;
+        seen = event_seq;
+        pthread_mutex_unlock(&event_lock);
+
+        http_write_str(c, changed ? "" : ": ping\n\n");
+        if (changed) {
+            write_event(c, "measurement", data_json);
+        }
+        http_flush(c);
+        char buf[16];
+        if (c->io.recv(c->io.ctx, buf, sizeof(buf), 1) < 0) {
+            pthread_mutex_lock(&event_lock);
+            break;
+        }
+        pthread_mutex_lock(&event_lock);
+    }
+    pthread_mutex_unlock(&event_lock);
+    c->keep_alive = false;
+}
+
+static void *ticker_thread(void *arg) {
+    while (1) {
+        usleep(MEASUREMENT_INTERVAL_MS * 1000U / VIEWER_SPEEDUP);
+        pthread_mutex_lock(&event_lock);
+        event_seq++;
+        pthread_cond_broadcast(&event_cond);
+        pthread_mutex_unlock(&event_lock);
+    }
+    return NULL;
+}
+
+// Buffer de medições: arquivo no layout do SPIFFS (ring de MAX_MEASUREMENTS_BUFFER
+// registros), lido como spiffs_read_measurements() faz, com o mutex por lote
+static char store_path[64];
+static uint32_t store_tail, store_count, store_written;
+static pthread_mutex_t store_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t store_lock_us, store_reads;
+
+// Âncora de host: boot 1 começa em 18/10/2026 00:00 UTC; o boot 0 ficou sem âncora
+bool timebase_to_timestamp(uint16_t boot_id, uint32_t uptime_ms, uint32_t *timestamp) {
+    if (boot_id == 0) {
+        return false;
+    }
+    *timestamp = 1792281600U + uptime_ms / 1000U;
+    return true;
+}
+
+static void store_range(uint32_t *first, uint32_t *end) {
+    pthread_mutex_lock(&store_lock);
+    *end = store_written;
+    *first = store_written - store_count;
+    pthread_mutex_unlock(&store_lock);
+}
+
+static size_t store_read(uint32_t *pos, uint32_t end, measurement_data_t *buf, size_t max) {
+    pthread_mutex_lock(&store_lock);
+    uint64_t t0 = now_us();
+    uint32_t first = store_written - store_count;
+    if ((int32_t)(*pos - first) < 0) {
+        *pos = first;
+    }
+    size_t n = 0;
+    FILE *f = fopen(store_path, "rb");
+    while (f != NULL && n < max && (int32_t)(end - *pos) > 0) {
+        uint32_t slot = (store_tail + (*pos - first)) % MAX_MEASUREMENTS_BUFFER;
+        size_t run = max - n;
+        run = run < end - *pos ? run : end - *pos;
+        run = run < MAX_MEASUREMENTS_BUFFER - slot ? run : MAX_MEASUREMENTS_BUFFER - slot;
+        fseek(f, (long)(slot * sizeof(measurement_data_t)), SEEK_SET);
+        size_t got = fread(&buf[n], sizeof(measurement_data_t), run, f);
+        n += got;
+        *pos += got;
+        if (got < run) {
+            break;
+        }
+    }
+    if (f != NULL) {
+        fclose(f);
+    }
+    uint32_t held = (uint32_t)(now_us() - t0);
+    store_lock_us += held;
+    store_reads++;
+    pthread_mutex_unlock(&store_lock);
+    return n;
+}
+
+static const history_source_t store_history = { .range = store_range, .read = store_read };
+
+static void handle_history(http_conn_t *c, const http_request_t *req) {
+    history_handle(c, req, &store_history);
+}
+
+static const http_route_t routes[] = {
+    { "GET", "/data", handle_data },
+    { "GET", "/status", handle_status },
+    { "GET", "/events", handle_events },
+    { "GET", "/history", handle_history },
+    { "GET", "/*", www_handle },
+};
+
+// Fila de conexões aceitas (xQueue no firmware)
+static int queue[HTTP_ACCEPT_QUEUE_LEN];
+static int queue_head, queue_count;
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_not_empty = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t queue_not_full = PTHREAD_COND_INITIALIZER;
+
+static void queue_push(int fd) {
+    pthread_mutex_lock(&queue_lock);
+    while (queue_count == HTTP_ACCEPT_QUEUE_LEN) {
+        pthread_cond_wait(&queue_not_full, &queue_lock);
+    }
+    queue[(queue_head + queue_count++) % HTTP_ACCEPT_QUEUE_LEN] = fd;
+    pthread_cond_signal(&queue_not_empty);
+    pthread_mutex_unlock(&queue_lock);
+}
+
+static int queue_pop(void) {
+    pthread_mutex_lock(&queue_lock);
+    while (queue_count == 0) {
+        pthread_cond_wait(&queue_not_empty, &queue_lock);
+    }
+    int fd = queue[queue_head];
+    queue_head = (queue_head + 1) % HTTP_ACCEPT_QUEUE_LEN;
+    queue_count--;
+    pthread_cond_signal(&queue_not_full);
+    pthread_mutex_unlock(&queue_lock);
+    return fd;
+}
+
+static int sock_recv(void *ctx, char *buf, size_t len, uint32_t timeout_ms) {
+    int fd = *(int *)ctx;
+    struct pollfd p = { .fd = fd, .events = POLLIN };
+    int r = poll(&p, 1, (int)timeout_ms);
+    if (r <= 0) {
+        return r == 0 ? 0 : -1;
+    }
+    ssize_t n = recv(fd, buf, len, 0);
+    return n > 0 ? (int)n : -1;
+}
+
+static bool sock_send(void *ctx, const void *data, size_t len) {
+    count_write(len);
+    return send_all(*(int *)ctx, data, len);
+}
+
+static bool sock_waiting(void *ctx) {
+    return queue_count > 0;
+}
+
+static http_conn_t slots[MAX_SLOTS];
+
+static void *worker_thread(void *arg) {
+    http_conn_t *c = arg;
+    while (1) {
+        int fd = queue_pop();
+        http_io_t io = {
+            .ctx = &fd, .recv = sock_recv, .send = sock_send, .send_static = sock_send, .waiting = sock_waiting
+        };
+        set_nodelay(fd);
+        http_conn_serve(c, &io, routes, COUNT(routes), HTTP_KEEPALIVE_S * 1000U);
+        close(fd);
+    }
+    return NULL;
+}
+
+static void *acceptor_thread(void *arg) {
+    while (1) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd >= 0) {
+            queue_push(fd);
+        }
+    }
+    return NULL;
+}
+
+/* ---------- Servidor antigo: uma conexão por vez, Connection: close ---------- */
+
+static void legacy_write(int fd, const char *s) {
+    count_write(strlen(s));
+    send_all(fd, s, strlen(s));
+}
+
+static void *legacy_thread(void *arg) {
+    char buf[1460];
+    while (1) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        ssize_t n = recv(fd, buf, sizeof(buf) - 1, 0);
+        if (n > 0) {
+            buf[n] = '\0';
+            const char *ct = "application/json";
+            const char **parts = index_parts;
+            size_t count = COUNT(index_parts);
+            const char *single[] = { data_json };
+            if (strncmp(buf, "GET /data ", 10) == 0) {
+                parts = single;
+                count = 1;
+            } else if (strncmp(buf, "GET /status ", 12) == 0) {
+                parts = status_parts;
+                count = COUNT(status_parts);
+            } else {
+                ct = "text/html; charset=UTF-8";
+            }
+            char hdr[160];
+            snprintf(hdr, sizeof(hdr),
+                     "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nConnection: close\r\nCache-Control: no-store\r\n\r\n", ct);
+            legacy_write(fd, hdr);
+            for (size_t i = 0; i < count; i++) {
+                legacy_write(fd, parts[i]);
+            }
+        }
+        close(fd);
+    }
+    return NULL;
+}
+
+/* ---------- Clientes ---------- */
+
+typedef struct {
+    int fd;
+    char buf[8192];
+    size_t len, pos;
+    uint64_t total;         // bytes recebidos desde a criação
+} reader_t;
+
+static int reader_fill(reader_t *r) {
+    if (r->pos == r->len) {
+        r->pos = r->len = 0;
+    }
+    ssize_t n = recv(r->fd, r->buf + r->len, sizeof(r->buf) - r->len, 0);
+    if (n > 0) {
+        r->len += (size_t)n;
+        r->total += (uint64_t)n;
+    }
+    return (int)n;
+}
+
+// Linha terminada em CRLF (sem o CRLF) em line; false se a conexão fechou
+static bool reader_line(reader_t *r, char *line, size_t size) {
+    while (1) {
+        char *nl = memchr(r->buf + r->pos, '\n', r->len - r->pos);
+        if (nl != NULL) {
+            size_t n = (size_t)(nl - (r->buf + r->pos));
+            size_t copy = n < size - 1 ? n : size - 1;
+            memcpy(line, r->buf + r->pos, copy);
+            line[copy] = '\0';
+            if (copy > 0 && line[copy - 1] == '\r') {
+                line[copy - 1] = '\0';
+            }
+            r->pos += n + 1;
+            return true;
+        }
+        if (r->pos > 0) {
+            memmove(r->buf, r->buf + r->pos, r->len - r->pos);
+            r->len -= r->pos;
+            r->pos = 0;
+        }
+        if (reader_fill(r) <= 0) {
+            return false;
+        }
+    }
+}
+
+static bool reader_skip(reader_t *r, size_t n) {
+    while (n > 0) {
+        if (r->pos == r->len && reader_fill(r) <= 0) {
+            return false;
+        }
+        size_t k = r->len - r->pos < n ? r->len - r->pos : n;
+        r->pos += k;
+        n -= k;
+    }
+    return true;
+}
+
+// Lê uma resposta inteira; *close fica verdadeiro se o servidor vai fechar a conexão
+static bool read_response(reader_t *r, bool *close_conn) {
+    char line[256];
+    long length = -1;
+    bool chunked = false;
+    if (!reader_line(r, line, sizeof(line)) || strncmp(line, "HTTP/1.1 200", 12) != 0) {
+        return false;
+    }
+    *close_conn = false;
+    while (reader_line(r, line, sizeof(line)) && line[0] != '\0') {
+        if (strncasecmp(line, "Content-Length:", 15) == 0) {
+            length = strtol(line + 15, NULL, 10);
+        } else if (strncasecmp(line, "Transfer-Encoding: chunked", 26) == 0) {
+            chunked = true;
+        } else if (strncasecmp(line, "Connection: close", 17) == 0) {
+            *close_conn = true;
+        }
+    }
+    if (chunked) {
+        while (1) {
+            if (!reader_line(r, line, sizeof(line))) {
+                return false;
+            }
+            long n = strtol(line, NULL, 16);
+            if (n == 0) {
+                return reader_line(r, line, sizeof(line));
+            }
+            if (!reader_skip(r, (size_t)n) || !reader_line(r, line, sizeof(line))) {
+                return false;
+            }
+        }
+    }
+    if (length >= 0) {
+        return reader_skip(r, (size_t)length);
+    }
+    // Sem tamanho: corpo até o fechamento
+    while (reader_fill(r) > 0) {
+        r->pos = r->len;
+    }
+    *close_conn = true;
+    return true;
+}
+
+typedef struct {
+    int id;
+    bool slow;
+    uint32_t *samples;
+    size_t count;
+    uint32_t errors;
+    uint32_t connects;
+} client_t;
+
+static int client_connect(client_t *cl) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    set_nodelay(fd);
+    struct timeval tv = { .tv_sec = CLIENT_TIMEOUT_S };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    cl->connects++;
+    return fd;
+}
+
+static void *client_thread(void *arg) {
+    client_t *cl = arg;
+    static const char *paths[] = { "/data", "/data", "/data", "/data", "/data", "/data", "/data", "/data",
+                                   "/status", "/" };
+    reader_t *r = calloc(1, sizeof(reader_t));
+    r->fd = -1;
+    unsigned n = (unsigned)cl->id;
+    while (running) {
+        if (r->fd < 0) {
+            r->fd = client_connect(cl);
+            r->len = r->pos = 0;
+            if (r->fd < 0) {
+                cl->errors++;
+                usleep(1000);
+                continue;
+            }
+        }
+        char req[128];
+        int len = snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\nHost: datalogger\r\nUser-Agent: http_load\r\n\r\n",
+                           paths[n++ % COUNT(paths)]);
+        uint64_t t0 = now_us();
+        bool ok;
+        if (cl->slow) {
+            usleep(SLOW_GAP_MS * 1000);
+            ok = send_all(r->fd, req, (size_t)len / 2);
+            usleep(SLOW_GAP_MS * 1000);
+            ok = ok && send_all(r->fd, req + len / 2, (size_t)len - (size_t)len / 2);
+        } else {
+            ok = send_all(r->fd, req, (size_t)len);
+        }
+        bool close_conn = true;
+        ok = ok && read_response(r, &close_conn);
+        if (!running) {
+            break;
+        }
+        if (!ok) {
+            cl->errors++;
+        } else if (!cl->slow && cl->count < MAX_SAMPLES) {
+            cl->samples[cl->count++] = (uint32_t)(now_us() - t0);
+        }
+        if (!ok || close_conn) {
+            close(r->fd);
+            r->fd = -1;
+        }
+    }
+    if (r->fd >= 0) {
+        close(r->fd);
+    }
+    free(r);
+    return NULL;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void run(int clients, int seconds, bool slow) {
+    static client_t cl[MAX_CLIENTS + 1];
+    pthread_t th[MAX_CLIENTS + 1];
+    int total_threads = clients + (slow ? 1 : 0);
+    running = true;
+    for (int i = 0; i < total_threads; i++) {
+        cl[i] = (client_t){ .id = i, .slow = i == clients };
+        cl[i].samples = malloc(MAX_SAMPLES * sizeof(uint32_t));
+    }
+    // O cliente lento começa antes, para já ocupar uma conexão
+    if (slow) {
+        pthread_create(&th[clients], NULL, client_thread, &cl[clients]);
+        usleep(50000);
+    }
+    uint64_t t0 = now_us();
+    for (int i = 0; i < clients; i++) {
+        pthread_create(&th[i], NULL, client_thread, &cl[i]);
+    }
+    usleep((useconds_t)seconds * 1000000U);
+    running = false;
+    uint64_t elapsed = now_us() - t0;
+    // Cada cliente termina a requisição em andamento (ou desiste pelo SO_RCVTIMEO) e fecha
+    for (int i = 0; i < total_threads; i++) {
+        pthread_join(th[i], NULL);
+    }
+
+    size_t count = 0;
+    uint32_t errors = 0, connects = 0;
+    for (int i = 0; i < clients; i++) {
+        count += cl[i].count;
+        errors += cl[i].errors;
+        connects += cl[i].connects;
+    }
+    uint32_t *all = malloc((count + 1) * sizeof(uint32_t));
+    size_t k = 0;
+    for (int i = 0; i < total_threads; i++) {
+        memcpy(all + k, cl[i].samples, cl[i].count * sizeof(uint32_t));
+        k += cl[i].count;
+        free(cl[i].samples);
+    }
+    qsort(all, count, sizeof(uint32_t), cmp_u32);
+    printf("%-8s %4d%s %10.0f %9u %9u %9u %8u %6u\n", legacy ? "legacy" : "slots", clients, slow ? "+s" : "  ",
+           count * 1e6 / (double)elapsed, count ? all[count / 2] : 0, count ? all[count * 99 / 100] : 0,
+           count ? all[count - 1] : 0, connects, errors);
+    fflush(stdout);
+    free(all);
+}
+
+// GET /status numa conexão própria, como o fetch() do painel; devolve os bytes recebidos
+static uint64_t fetch_status(client_t *cl) {
+    reader_t *r = calloc(1, sizeof(reader_t));
+    uint64_t bytes = 0;
+    r->fd = client_connect(cl);
+    const char req[] = "GET /status HTTP/1.1\r\nHost: datalogger\r\nConnection: close\r\n\r\n";
+    send_all(r->fd, req, sizeof(req) - 1);
+    int n;
+    while ((n = reader_fill(r)) > 0) {
+        bytes += (uint64_t)n;
+        r->pos = r->len;
+    }
+    close(r->fd);
+    free(r);
+    return bytes;
+}
+
+// Um navegador com a página aberta por `minutes` minutos simulados
+static void run_viewer(int minutes) {
+    client_t cl = { 0 };
+    reader_t *r = calloc(1, sizeof(reader_t));
+    uint32_t requests = 0, events = 0;
+    uint64_t bytes_in = 0;
+    server_writes = server_bytes = 0;
+    if (legacy) {
+        // Meta refresh de 1 s: página inteira e uma conexão nova por segundo
+        for (int i = 0; i < minutes * 60; i++) {
+            r->fd = client_connect(&cl);
+            r->len = r->pos = 0;
+            const char req[] = "GET / HTTP/1.1\r\nHost: datalogger\r\n\r\n";
+            send_all(r->fd, req, sizeof(req) - 1);
+            int n;
+            while ((n = reader_fill(r)) > 0) {
+                bytes_in += (uint64_t)n;
+                r->pos = r->len;
+            }
+            close(r->fd);
+            requests++;
+        }
+    } else {
+        pthread_t th;
+        pthread_create(&th, NULL, ticker_thread, NULL);
+        r->fd = client_connect(&cl);
+        const char req[] = "GET /events HTTP/1.1\r\nHost: datalogger\r\nAccept: text/event-stream\r\n\r\n";
+        send_all(r->fd, req, sizeof(req) - 1);
+        requests++;
+        uint64_t end = now_us() + (uint64_t)minutes * 60000000U / VIEWER_SPEEDUP;
+        const uint64_t status_period = (uint64_t)STATUS_REFRESH_S * 1000000U / VIEWER_SPEEDUP;
+        uint64_t next_status = now_us() + status_period;
+        while (now_us() < end) {
+            if (now_us() >= next_status) {
+                bytes_in += fetch_status(&cl);
+                requests++;
+                next_status += status_period;
+            }
+            struct pollfd p = { .fd = r->fd, .events = POLLIN };
+            if (poll(&p, 1, 10) <= 0) {
+                continue;
+            }
+            r->len = r->pos = 0;
+            int n = reader_fill(r);
+            if (n <= 0) {
+                break;
+            }
+            bytes_in += (uint64_t)n;
+            for (char *e = r->buf; (e = memmem(e, r->buf + r->len - e, "event: ", 7)) != NULL; e += 7) {
+                events++;
+            }
+        }
+        close(r->fd);
+        usleep(100000);
+    }
+    free(r);
+    double m = minutes;
+    printf("%-8s %11.1f %8.1f %8.1f %8.1f %10.0f %11.0f\n", legacy ? "refresh" : "events", cl.connects / m,
+           requests / m, events / m, server_writes / m, bytes_in / m, server_bytes / m);
+}
+
+// Uma carga do painel numa conexão keep-alive; etags guarda o cache do navegador
+static void page_load(const char *name, const char **paths, size_t count, char (*etags)[40]) {
+    client_t cl = { 0 };
+    reader_t *r = calloc(1, sizeof(reader_t));
+    uint32_t ok = 0, not_modified = 0;
+    server_writes = server_bytes = 0;
+    r->fd = -1;
+    for (size_t i = 0; i < count; i++) {
+        if (r->fd < 0) {
+            r->fd = client_connect(&cl);
+            r->len = r->pos = 0;
+        }
+        char req[256];
+        int len = snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\nHost: datalogger\r\nAccept-Encoding: gzip, deflate\r\n",
+                           paths[i]);
+        if (etags[i][0] != '\0') {
+            len += snprintf(req + len, sizeof(req) - (size_t)len, "If-None-Match: %s\r\n", etags[i]);
+        }
+        len += snprintf(req + len, sizeof(req) - (size_t)len, "\r\n");
+        send_all(r->fd, req, (size_t)len);
+
+        char line[256];
+        long length = -1;
+        bool close_conn = false;
+        if (!reader_line(r, line, sizeof(line))) {
+            break;
+        }
+        int status = atoi(line + 9);
+        ok += status == 200;
+        not_modified += status == 304;
+        while (reader_line(r, line, sizeof(line)) && line[0] != '\0') {
+            if (strncasecmp(line, "Content-Length:", 15) == 0) {
+                length = strtol(line + 15, NULL, 10);
+            } else if (strncasecmp(line, "ETag: ", 6) == 0) {
+                snprintf(etags[i], sizeof(etags[i]), "%.39s", line + 6);
+            } else if (strncasecmp(line, "Connection: close", 17) == 0) {
+                close_conn = true;
+            }
+        }
+        if (status == 304) {
+            length = 0;
+        }
+        if (length >= 0) {
+            reader_skip(r, (size_t)length);
+        } else {
+            while (reader_fill(r) > 0) {
+                r->pos = r->len;
+            }
+            close_conn = true;
+        }
+        if (close_conn) {
+            close(r->fd);
+            r->fd = -1;
+        }
+    }
+    if (r->fd >= 0) {
+        close(r->fd);
+    }
+    // O servidor conta o que enviou depois do cliente ler a resposta
+    usleep(10000);
+    printf("%-8s %8u %5u %5u %8u %9u %9llu\n", name, cl.connects, ok, not_modified, server_writes, server_bytes,
+           (unsigned long long)r->total);
+    free(r);
+}
+
+static void run_page(void) {
+    static const char *paths[] = { "/", "/style.css", "/app.js" };
+    char etags[COUNT(paths)][40] = { { 0 } };
+    size_t count = legacy ? 1 : COUNT(paths);
+    page_load("first", paths, count, etags);
+    page_load("reload", paths, count, etags);
+}
+
+// Buffer cheio que já deu a volta (1,5 vez a capacidade escrita); o décimo mais antigo sem âncora
+#define STORE_WRITTEN   (MAX_MEASUREMENTS_BUFFER * 3 / 2)
+#define STORE_UNANCHORED (MAX_MEASUREMENTS_BUFFER / 10)
+
+static void store_fill(void) {
+    snprintf(store_path, sizeof(store_path), "/tmp/http_load_history_%d.dat", (int)getpid());
+    FILE *f = fopen(store_path, "wb");
+    uint32_t total = STORE_WRITTEN;
+    measurement_data_t ring[MAX_MEASUREMENTS_BUFFER];
+    for (uint32_t i = 0; i < total; i++) {
+        measurement_data_t *m = &ring[i % MAX_MEASUREMENTS_BUFFER];
+        memset(m, 0, sizeof(*m));
+        snprintf(m->sensor_id, sizeof(m->sensor_id), "%s", SENSOR_ID);
+        m->boot_id = i < total - MAX_MEASUREMENTS_BUFFER + STORE_UNANCHORED ? 0 : 1;
+        m->uptime_ms = i * (uint32_t)MEASUREMENT_INTERVAL_MS;
+        m->temperature_x10 = (int16_t)(200 + i % 80);
+        m->humidity_x10 = (int16_t)(550 + i % 150);
+        m->quality = i % 50 == 0 ? MEAS_QUALITY_MISSING : MEAS_QUALITY_OK;
+        m->interval_s = MEASUREMENT_INTERVAL_MS / 1000;
+        m->measurement_id = i;
+    }
+    fwrite(ring, sizeof(measurement_data_t), MAX_MEASUREMENTS_BUFFER, f);
+    fclose(f);
+    store_written = total;
+    store_count = MAX_MEASUREMENTS_BUFFER;
+    store_tail = total % MAX_MEASUREMENTS_BUFFER;
+}
+
+// Uma resposta de /history inteira; conta registros (linhas CSV ou objetos JSON) e bytes do corpo
+static bool read_history(reader_t *r, bool csv, uint32_t *records, uint32_t *body) {
+    char line[256];
+    if (!reader_line(r, line, sizeof(line)) || strncmp(line, "HTTP/1.1 200", 12) != 0) {
+        return false;
+    }
+    while (reader_line(r, line, sizeof(line)) && line[0] != '\0') {
+    }
+    *records = 0;
+    *body = 0;
+    while (reader_line(r, line, sizeof(line))) {
+        long n = strtol(line, NULL, 16);
+        if (n == 0) {
+            reader_line(r, line, sizeof(line));
+            if (csv) {
+                (*records)--;   // cabeçalho
+            }
+            return true;
+        }
+        *body += (uint32_t)n;
+        while (n > 0) {
+            if (r->pos == r->len && reader_fill(r) <= 0) {
+                return false;
+            }
+            size_t k = r->len - r->pos < (size_t)n ? r->len - r->pos : (size_t)n;
+            for (size_t i = 0; i < k; i++) {
+                *records += r->buf[r->pos + i] == (csv ? '\n' : '{');
+            }
+            r->pos += k;
+            n -= (long)k;
+        }
+        reader_line(r, line, sizeof(line));
+    }
+    return false;
+}
+
+// Requisições seguidas numa conexão keep-alive durante `seconds`
+static void run_history(const char *query, int seconds) {
+    client_t cl = { 0 };
+    reader_t *r = calloc(1, sizeof(reader_t));
+    r->fd = client_connect(&cl);
+    bool csv = strstr(query, "csv") != NULL;
+    uint32_t requests = 0, records = 0, per_request = 0, body = 0;
+    server_writes = 0;
+    store_reads = 0;
+    store_lock_us = 0;
+    uint64_t t0 = now_us(), end = t0 + (uint64_t)seconds * 1000000U;
+    while (now_us() < end) {
+        char req[160];
+        int len = snprintf(req, sizeof(req), "GET /history?%s HTTP/1.1\r\nHost: datalogger\r\n\r\n", query);
+        if (!send_all(r->fd, req, (size_t)len) || !read_history(r, csv, &per_request, &body)) {
+            fprintf(stderr, "history request failed\n");
+            break;
+        }
+        requests++;
+        records += per_request;
+    }
+    double elapsed = (now_us() - t0) / 1e6;
+    close(r->fd);
+    free(r);
+    printf("%-42s %8u %5u %9.0f %6.1f %7.1f %6.1f %7.1f\n", query, requests, per_request, records / elapsed,
+           per_request ? (double)body / per_request : 0.0, requests ? (double)server_writes / requests : 0.0,
+           requests ? (double)store_reads / requests : 0.0, store_reads ? (double)store_lock_us / store_reads : 0.0);
+}
+
+int main(int argc, char **argv) {
+    int clients = 0;
+    int seconds = 2;
+    bool slow = false;
+    bool viewer = false;
+    bool page = false;
+    bool history = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "lc:t:w:sepH")) != -1) {
+        switch (opt) {
+        case 'l':
+            legacy = true;
+            break;
+        case 'c':
+            clients = atoi(optarg);
+            break;
+        case 't':
+            seconds = atoi(optarg);
+            break;
+        case 'w':
+            slot_count = atoi(optarg);
+            break;
+        case 's':
+            slow = true;
+            break;
+        case 'e':
+            viewer = true;
+            break;
+        case 'p':
+            page = true;
+            break;
+        case 'H':
+            history = true;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-l] [-c clients] [-t seconds] [-w slots] [-s] [-e] [-p] [-H]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (clients > MAX_CLIENTS || slot_count < 1 || slot_count > MAX_SLOTS) {
+        fprintf(stderr, "at most %d clients and 1..%d slots\n", MAX_CLIENTS, MAX_SLOTS);
+        return 2;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    server_addr.sin_port = 0;
+    socklen_t alen = sizeof(server_addr);
+    if (bind(listen_fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) != 0 || listen(listen_fd, 8) != 0 ||
+        getsockname(listen_fd, (struct sockaddr *)&server_addr, &alen) != 0) {
+        perror("listen");
+        return 1;
+    }
+
+    pthread_t th;
+    if (legacy) {
+        pthread_create(&th, NULL, legacy_thread, NULL);
+    } else {
+        pthread_create(&th, NULL, acceptor_thread, NULL);
+        for (int i = 0; i < slot_count; i++) {
+            pthread_create(&th, NULL, worker_thread, &slots[i]);
+        }
+    }
+
+    if (viewer) {
+        printf("one viewer, %d simulated minutes, measurement every %d ms\n", seconds, MEASUREMENT_INTERVAL_MS);
+        printf("%-8s %11s %8s %8s %8s %10s %11s\n", "page", "connects/m", "req/m", "events/m", "writes/m",
+               "bytes_in/m", "srv_bytes/m");
+        run_viewer(seconds);
+        return 0;
+    }
+    if (history && !legacy) {
+        static const char *queries[] = {
+            "format=csv", "format=json", "format=csv&from=1792288800&to=1792290600",
+            "format=json&from=1792288800&to=1792290600",
+        };
+        store_fill();
+        printf("/history over %d records (%d without anchor), %d per read, %d s per query\n", MAX_MEASUREMENTS_BUFFER,
+               STORE_UNANCHORED, HISTORY_READ_BATCH,
+               seconds);
+        printf("%-42s %8s %5s %9s %6s %7s %6s %7s\n", "query", "requests", "recs", "recs/s", "B/rec", "writes",
+               "reads", "lock_us");
+        for (size_t i = 0; i < COUNT(queries); i++) {
+            run_history(queries[i], seconds);
+        }
+        remove(store_path);
+        return 0;
+    }
+    if (page) {
+        printf("%s\n", legacy ? "old page (no cache)" : "dashboard (gzip, ETag)");
+        printf("%-8s %8s %5s %5s %8s %9s %9s\n", "load", "connects", "200", "304", "writes", "srv_bytes",
+               "bytes_in");
+        run_page();
+        return 0;
+    }
+    printf("%s server, %d s per run, keep-alive %d s\n",
+           legacy ? "legacy (one connection at a time, Connection: close)" : "slot", seconds, HTTP_KEEPALIVE_S);
+    if (!legacy) {
+        printf("%d slots, accept queue %d\n", slot_count, HTTP_ACCEPT_QUEUE_LEN);
+    }
+    printf("%-8s %6s %10s %9s %9s %9s %8s %6s\n", "server", "clients", "req/s", "p50_us", "p99_us", "max_us",
+           "connects", "errors");
+    static const int defaults[] = { 1, 4, 16 };
+    for (size_t i = 0; i < COUNT(defaults); i++) {
+        if (clients == 0 || clients == defaults[i]) {
+            run(clients ? clients : defaults[i], seconds, slow);
+        }
+    }
+    if (clients != 0 && clients != 1 && clients != 4 && clients != 16) {
+        run(clients, seconds, slow);
+    }
+    if (!legacy) {
+        uint32_t requests = 0, connections = 0, errors = 0;
+        for (int i = 0; i < slot_count; i++) {
+            requests += slots[i].requests_total;
+            connections += slots[i].connections_total;
+            errors += slots[i].errors_total;
+        }
+        printf("server: %u connections, %u requests, %u errors\n", connections, requests, errors);
+    }
+    return 0;
+}
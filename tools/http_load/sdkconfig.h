@@ -0,0 +1,15 @@
+/*
+ * Configuração de host do teste de carga HTTP: valores padrão do Kconfig
+ * do servidor, da medição e do buffer SPIFFS (main/config.h inclui este arquivo).
+ */
+#ifndef SDKCONFIG_H
+#define SDKCONFIG_H
+
+#define CONFIG_SENSOR_ID                "TEMP_HUM_001"
+#define CONFIG_FIRMWARE_VERSION         "1.0.0"
+#define CONFIG_MEASUREMENT_INTERVAL_MS  10000
+#define CONFIG_MAX_MEASUREMENTS_BUFFER  1000
+#define CONFIG_HTTP_MAX_CONNECTIONS     3
+#define CONFIG_HTTP_KEEPALIVE_S         5
+
+#endif // SDKCONFIG_H
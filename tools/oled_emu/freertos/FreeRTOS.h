@@ -0,0 +1,11 @@
+/*
+ * Substituto de host: o emulador roda numa única thread, seções críticas
+ * não fazem nada.
+ */
+#ifndef FREERTOS_H_HOST
+#define FREERTOS_H_HOST
+
+#define portENTER_CRITICAL()
+#define portEXIT_CRITICAL()
+
+#endif // FREERTOS_H_HOST
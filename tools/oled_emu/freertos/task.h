@@ -0,0 +1,6 @@
+#ifndef TASK_H_HOST
+#define TASK_H_HOST
+
+#include "freertos/FreeRTOS.h"
+
+#endif // TASK_H_HOST
@@ -0,0 +1,220 @@
+/*
+ * Emulador de host do display OLED: roda a renderização do firmware (oled_screen,
+ * oled_ui, oled_trend, framebuffer sombra) contra o SSD1306 emulado da biblioteca
+ * (intf/emu) e mede o custo de barramento de cada quadro de um roteiro fixo.
+ *
+ * Uso: oled_emu [-c clock_hz] [-d] [-o dir] [-g dir]
+ *   -c  clock SCL simulado (padrão 400 kHz, fast mode)
+ *   -d  desenho direto, sem framebuffer sombra
+ *   -o  grava a imagem do painel após cada quadro em dir/NN-nome.pbm
+ *   -g  compara cada quadro com dir/NN-nome.pbm (imagens de referência); sai com 1 se diferir
+ */
+
+#include "config.h"
+#include "fixed_point.h"
+#include "oled_screen.h"
+#include "oled_trend.h"
+#include "oled_ui.h"
+#include "trend_history.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ssd1306.h"
+#include "intf/emu/ssd1306_emu.h"
+
+// Quadros do SSD1306 durante o passo de scroll (OLED_TREND_SCROLL_STOP_MS a ~105 Hz)
+#define SCROLL_FRAMES   ((OLED_TREND_SCROLL_STOP_MS * 105 + 999) / 1000)
+// Duração de uma coluna do histórico de tendência
+#define COLUMN_MS       ((uint32_t)OLED_TREND_HOURS * 3600000U / TREND_HISTORY_LEN)
+
+static bool shadow = true;
+static const char *out_dir = NULL;
+static const char *golden_dir = NULL;
+static int frame_no = 0;
+static int mismatches = 0;
+static SSD1306EmuStats total;
+
+static int compare_pbm(const char *generated, const char *golden) {
+    FILE *a = fopen(generated, "rb");
+    FILE *b = fopen(golden, "rb");
+    int differ = 1;
+    if (a != NULL && b != NULL) {
+        int ca, cb;
+        do {
+            ca = fgetc(a);
+            cb = fgetc(b);
+        } while (ca == cb && ca != EOF);
+        differ = ca != cb;
+    }
+    if (a != NULL) {
+        fclose(a);
+    }
+    if (b != NULL) {
+        fclose(b);
+    }
+    return differ;
+}
+
+// Fim de um quadro: envia o framebuffer sombra, contabiliza o barramento e a imagem
+static void frame(const char *name) {
+    char path[256];
+    SSD1306EmuStats st;
+    ssd1306_flush();
+    ssd1306_emuGetStats(&st, 1);
+    total.transactions += st.transactions;
+    total.bytes += st.bytes;
+    total.dataBytes += st.dataBytes;
+    total.busUs += st.busUs;
+    printf("%2d  %-28s %5u %6u %6u %7u\n", frame_no, name, st.transactions, st.bytes, st.dataBytes, st.busUs);
+
+    if (out_dir != NULL) {
+        snprintf(path, sizeof(path), "%s/%02d-%s.pbm", out_dir, frame_no, name);
+        if (ssd1306_emuWritePbm(path) != 0) {
+            fprintf(stderr, "cannot write %s\n", path);
+            exit(2);
+        }
+    }
+    if (golden_dir != NULL) {
+        char golden[256];
+        snprintf(path, sizeof(path), "/tmp/oled_emu_%d.pbm", (int)getpid());
+        snprintf(golden, sizeof(golden), "%s/%02d-%s.pbm", golden_dir, frame_no, name);
+        ssd1306_emuWritePbm(path);
+        if (compare_pbm(path, golden)) {
+            printf("    ^ differs from %s\n", golden);
+            mismatches++;
+        }
+        remove(path);
+    }
+    frame_no++;
+}
+
+static void render(const char *name) {
+    oled_ui_render();
+    frame(name);
+}
+
+// Histórico de tendência: uma amostra por minuto; ondas de 90 e 120 min atingem os
+// extremos logo nas primeiras colunas, então a coluna nova não muda as escalas
+static uint32_t feed_history(uint32_t from_ms, uint32_t to_ms) {
+    for (uint32_t t = from_ms; t < to_ms; t += 60000) {
+        uint32_t m = t / 60000;
+        int16_t temp = (int16_t)(230 + (int)(m % 90 < 45 ? m % 45 : 45 - m % 45) / 2);
+        int16_t hum = (int16_t)(600 - (int)(m % 120 < 60 ? m % 60 : 60 - m % 60));
+        trend_history_add(t, temp, hum);
+    }
+    return to_ms;
+}
+
+int main(int argc, char **argv) {
+    uint32_t clock_hz = 400000;
+    int opt;
+    while ((opt = getopt(argc, argv, "c:do:g:")) != -1) {
+        switch (opt) {
+        case 'c':
+            clock_hz = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'd':
+            shadow = false;
+            break;
+        case 'o':
+            out_dir = optarg;
+            break;
+        case 'g':
+            golden_dir = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-c clock_hz] [-d] [-o dir] [-g dir]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    ssd1306_emuInit(clock_hz);
+    ssd1306_128x64_init();
+    if (OLED_STATIC_DRIVER_ENABLED) {
+        ssd1306_setStaticDriver(ssd1306_128x64_staticDriver());
+    }
+    ssd1306_clearScreen();
+    if (shadow) {
+        ssd1306_enableShadowBuffer();
+    }
+    printf("SSD1306 emulator, %s, SCL %u Hz\n", shadow ? "shadow framebuffer" : "direct drawing",
+           (unsigned)clock_hz);
+    printf("%2s  %-28s %5s %6s %6s %7s\n", "#", "frame", "txn", "bytes", "gdram", "bus_us");
+    frame("init");
+
+    // Tela principal, na ordem dos eventos da oled_display_task
+    struct tm now = { .tm_year = 126, .tm_mon = 9, .tm_mday = 18, .tm_hour = 12 };
+    oled_screen_init();
+    oled_screen_set_synced(false);
+    render("boot");
+
+    oled_screen_set_synced(true);
+    oled_screen_set_wifi(true);
+    oled_screen_set_clock(&now);
+    oled_screen_set_counts(0, 0);
+    oled_screen_set_values(253, 625, true);
+    render("synced");
+
+    now.tm_sec = 1;
+    oled_screen_set_clock(&now);
+    render("clock-tick");
+
+    render("nothing-changed");
+
+    now.tm_sec = 2;
+    oled_screen_set_clock(&now);
+    oled_screen_set_counts(1, 0);
+    oled_screen_set_values(254, 626, true);
+    oled_screen_set_notify(true);
+    render("measurement");
+
+    oled_screen_set_notify(false);
+    render("blink-end");
+
+    now.tm_sec = 3;
+    oled_screen_set_clock(&now);
+    oled_screen_set_counts(1520, 37);
+    render("counter-grows");
+
+    oled_screen_set_wifi(false);
+    render("wifi-lost");
+
+    now.tm_min = 1;
+    now.tm_sec = 0;
+    oled_screen_set_clock(&now);
+    oled_screen_set_values(99, 1000, true);
+    render("minute-and-width");
+
+    if (OLED_BURNIN_SHIFT_PX > 0) {
+        ssd1306_setStartLine(SCREEN_HEIGHT - 1);
+        ssd1306_setShadowOffset(1);
+        frame("burnin-shift");
+    }
+
+    // Tela de tendência: entrada, coluna nova por scroll de hardware, volta à tela principal
+    uint32_t t = feed_history(0, 100 * COLUMN_MS);
+    ssd1306_clearScreen();
+    oled_trend_draw();
+    frame("trend-screen");
+
+    t = feed_history(t, t + COLUMN_MS);
+    ssd1306_flush();
+    if (oled_trend_advance(shadow && OLED_TREND_HW_SCROLL_ENABLED) == OLED_TREND_SCROLL) {
+        ssd1306_emuAdvanceFrames(SCROLL_FRAMES);
+        oled_trend_scroll_end();
+    }
+    frame("trend-column");
+
+    ssd1306_setStartLine(0);
+    ssd1306_setShadowOffset(0);
+    ssd1306_clearScreen();
+    oled_ui_invalidate();
+    render("main-screen");
+
+    printf("    %-28s %5u %6u %6u %7u\n", "total", total.transactions, total.bytes, total.dataBytes, total.busUs);
+    if (golden_dir != NULL) {
+        printf("%d of %d frames differ from %s\n", mismatches, frame_no, golden_dir);
+    }
+    return mismatches ? 1 : 0;
+}
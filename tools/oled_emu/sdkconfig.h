@@ -0,0 +1,20 @@
+/*
+ * Configuração de host do emulador do display: valores padrão do Kconfig
+ * que afetam a renderização (main/config.h inclui este arquivo).
+ */
+#ifndef SDKCONFIG_H
+#define SDKCONFIG_H
+
+#define CONFIG_SENSOR_ID                "TEMP_HUM_001"
+#define CONFIG_FIRMWARE_VERSION         "1.0.0"
+#define CONFIG_ENABLE_OLED_DISPLAY      1
+#define CONFIG_OLED_SHADOW_BUFFER       1
+#define CONFIG_OLED_STATIC_DRIVER       1
+#define CONFIG_OLED_TREND_SCREEN_S      10
+#define CONFIG_OLED_MAIN_SCREEN_S       20
+#define CONFIG_OLED_TREND_HOURS         24
+#define CONFIG_OLED_TREND_HW_SCROLL     1
+#define CONFIG_OLED_BURNIN_SHIFT_PX     2
+#define CONFIG_OLED_BURNIN_PERIOD_S     300
+
+#endif // SDKCONFIG_H
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""Empacota o painel web (main/www) para o firmware.
+
+Cada arquivo é comprimido com gzip (nível 9, sem data nem nome no cabeçalho, para o
+resultado só depender do conteúdo) e vira um array const em C, com o tipo MIME e um
+ETag tirado do SHA-256 do conteúdo comprimido. O servidor (main/www.c) envia os bytes
+como estão, com Content-Encoding: gzip.
+
+Uso: www_pack.py <diretório www> <www_assets.c>
+"""
+
+import gzip
+import hashlib
+import os
+import sys
+
+CONTENT_TYPES = {
+    '.html': 'text/html; charset=UTF-8',
+    '.js': 'application/javascript',
+    '.css': 'text/css',
+    '.svg': 'image/svg+xml',
+    '.ico': 'image/x-icon',
+    '.json': 'application/json',
+}
+
+
+def c_name(path):
+    return 'www_' + ''.join(ch if ch.isalnum() else '_' for ch in path)
+
+
+def pack(www_dir):
+    assets = []
+    for name in sorted(os.listdir(www_dir)):
+        ext = os.path.splitext(name)[1]
+        if ext not in CONTENT_TYPES:
+            continue
+        with open(os.path.join(www_dir, name), 'rb') as f:
+            raw = f.read()
+        gz = gzip.compress(raw, compresslevel=9, mtime=0)
+        path = '/' if name == 'index.html' else '/' + name
+        etag = '"' + hashlib.sha256(gz).hexdigest()[:16] + '"'
+        assets.append((path, name, CONTENT_TYPES[ext], raw, gz, etag))
+    return assets
+
+
+def write_c(assets, out):
+    lines = [
+        '// Gerado por tools/www_pack.py a partir de main/www; não editar',
+        '',
+        '#include "www.h"',
+        '',
+    ]
+    for path, name, ctype, raw, gz, etag in assets:
+        lines.append('// %s: %u bytes, %u com gzip' % (name, len(raw), len(gz)))
+        lines.append('static const uint8_t %s[] __attribute__((aligned(4))) = {' % c_name(name))
+        for i in range(0, len(gz), 16):
+            lines.append('    ' + ' '.join('0x%02x,' % b for b in gz[i:i + 16]))
+        lines.append('};')
+        lines.append('')
+    lines.append('const www_asset_t www_assets[] = {')
+    for path, name, ctype, raw, gz, etag in assets:
+        lines.append('    { "%s", "%s", %s, sizeof(%s), "%s" },'
+                     % (path, ctype, c_name(name), c_name(name), etag.replace('"', '\\"')))
+    lines.append('};')
+    lines.append('')
+    lines.append('const size_t www_asset_count = sizeof(www_assets) / sizeof(www_assets[0]);')
+    text = '\n'.join(lines) + '\n'
+
+    # Só regrava se mudou: o arquivo é fonte do build
+    try:
+        with open(out) as f:
+            if f.read() == text:
+                return
+    except OSError:
+        pass
+    with open(out, 'w') as f:
+        f.write(text)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write('usage: www_pack.py <www dir> <out.c>\n')
+        return 2
+    assets = pack(sys.argv[1])
+    write_c(assets, sys.argv[2])
+    for path, name, ctype, raw, gz, etag in assets:
+        print('www: %-12s %6u -> %5u bytes  %s' % (path, len(raw), len(gz), etag))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())